@@ -0,0 +1,164 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+// Encode/decode round-trip check of the pre-render disk cache codec (standalone, no app dependencies). Build & run from the repo root:
+// g++ -std=c++17 -O2 -Isrc/PlaybackController dev/tests/PreRenderDiskCacheRoundTrip.cpp src/PlaybackController/PreRenderDiskCache.cpp src/Util/MemoryMappedFile.cpp -o prerender_cache_check && ./prerender_cache_check
+
+#include "../../src/PlaybackController/PreRenderDiskCache.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/// @brief Serves the prepared samples, like a SidDecoder would render them.
+	class SampleSource : public IBufferWriter
+	{
+	public:
+		explicit SampleSource(const std::vector<short>& samples, int numChannels) :
+			_samples(samples),
+			_numChannels(numChannels)
+		{
+		}
+
+		bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) override
+		{
+			short* out = static_cast<short*>(buffer);
+			for (size_t i = 0; i < framesPerBuffer * _numChannels; ++i)
+			{
+				out[i] = (_pos < _samples.size()) ? _samples[_pos] : 0;
+				++_pos;
+			}
+
+			return true;
+		}
+
+	private:
+		const std::vector<short>& _samples;
+		const int _numChannels;
+		size_t _pos = 0;
+	};
+
+	std::vector<short> MakeSignal(size_t frames, int numChannels, unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> full(-32768, 32767);
+		std::uniform_int_distribution<int> small(-40, 40);
+
+		std::vector<short> samples(frames * numChannels);
+		for (size_t frame = 0; frame < frames; ++frame)
+		{
+			for (int channel = 0; channel < numChannels; ++channel)
+			{
+				int value = 0;
+				switch ((frame / 5000) % 4)
+				{
+					case 0: value = static_cast<int>(12000.0 * std::sin(frame * (0.01 + 0.003 * channel))) + small(rng); break; // Tonal.
+					case 1: value = full(rng); break; // Noise (the escaped residuals).
+					case 2: value = (frame % 2 == 0) ? 32767 : -32768; break; // Worst case residuals.
+					default: value = 0; break; // Silence.
+				}
+
+				samples[(frame * numChannels) + channel] = static_cast<short>(value);
+			}
+		}
+
+		return samples;
+	}
+
+	/// @brief Records the signal through the cache (in uneven chunks, as the pre-render would), then plays it back. Returns true if the playback is bit-exact.
+	bool TryRoundTrip(PreRenderDiskCache& cache, const std::string& key, size_t frames, int numChannels, bool discardMidway)
+	{
+		const std::vector<short> signal = MakeSignal(frames, numChannels, static_cast<unsigned int>(frames));
+		SampleSource source(signal, numChannels);
+
+		{
+			std::unique_ptr<PreRenderDiskCache::Recorder> recorder = cache.CreateRecorder(key, source, frames, numChannels);
+			std::vector<short> buffer(4000 * numChannels);
+			size_t done = 0;
+			for (size_t chunk = 1; done < frames; chunk = (chunk * 7 + 13) % 3999 + 1)
+			{
+				const size_t count = std::min(chunk, frames - done);
+				recorder->TryFillBuffer(buffer.data(), static_cast<unsigned long>(count));
+				done += count;
+
+				if (discardMidway && done > frames / 2)
+				{
+					cache.DiscardPendingRecordings();
+					discardMidway = false;
+				}
+			}
+		}
+
+		std::unique_ptr<PreRenderDiskCache::Player> player = cache.TryOpen(key, frames, numChannels);
+		if (player == nullptr)
+		{
+			return false;
+		}
+
+		std::vector<short> decoded(frames * numChannels);
+		size_t done = 0;
+		for (size_t chunk = 1; done < frames; chunk = (chunk * 5 + 11) % 2999 + 1)
+		{
+			const size_t count = std::min(chunk, frames - done);
+			if (!player->TryFillBuffer(decoded.data() + (done * numChannels), static_cast<unsigned long>(count)))
+			{
+				return false;
+			}
+
+			done += count;
+		}
+
+		return decoded == signal;
+	}
+}
+
+int main()
+{
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "sidplaywx-prerender-cache-check";
+	std::filesystem::remove_all(folder);
+
+	PreRenderDiskCache cache;
+	cache.SetLocation(folder, 1024ull * 1024 * 1024);
+
+	int failures = 0;
+	const auto check = [&failures](bool ok, const char* what)
+	{
+		std::printf("%s: %s\n", (ok) ? "PASS" : "FAIL", what);
+		failures += (ok) ? 0 : 1;
+	};
+
+	check(TryRoundTrip(cache, "mono", 44100 * 3 + 17, 1, false), "mono round-trip");
+	check(TryRoundTrip(cache, "stereo", 48000 * 3 + 4096, 2, false), "stereo round-trip (whole last block)");
+	check(TryRoundTrip(cache, "short", 100, 2, false), "shorter than a block");
+	check(!TryRoundTrip(cache, "discarded", 44100 * 2, 2, true), "discarded recording isn't committed");
+
+	bool noTempLeft = true;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder))
+	{
+		noTempLeft = noTempLeft && entry.path().extension() != ".tmp";
+	}
+
+	check(noTempLeft, "no temporary files left behind");
+
+	std::filesystem::remove_all(folder);
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+// Bit-exact check of the VirtualStereo effect against a per-sample reference (standalone, no app dependencies). Build & run from the repo root:
+// g++ -std=c++17 -O2 dev/tests/VirtualStereoBitExact.cpp src/PlaybackController/PlaybackWrappers/Output/extra/VirtualStereo/VirtualStereo.cpp -o virtual_stereo_check && ./virtual_stereo_check
+
+#include "../../src/PlaybackController/PlaybackWrappers/Output/extra/VirtualStereo/VirtualStereo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace
+{
+	size_t allocations = 0; // Counts every heap allocation (the Apply must not do any, it runs in the audio callback).
+}
+
+void* operator new(size_t size)
+{
+	++allocations;
+	void* ptr = std::malloc((size == 0) ? 1 : size);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+	constexpr size_t CHANNELS = 2;
+
+	short Saturate(long sample)
+	{
+		return static_cast<short>(std::clamp<long>(sample, std::numeric_limits<short>::min(), std::numeric_limits<short>::max()));
+	}
+
+	/// @brief The effect computed straight from its definition over the whole signal (silence before the start): left = side * L[n] + center * L[n - d], right = center * R[n - d] + side * R[n - 2d].
+	std::vector<short> ApplyReference(const std::vector<short>& signal, size_t framesOffset, float sideVolumeFactor)
+	{
+		const float centerVolumeFactor = 1.0f - (sideVolumeFactor * 2);
+		const auto at = [&signal](size_t frame, size_t delay, size_t channel) -> short
+		{
+			return (frame < delay) ? 0 : signal[((frame - delay) * CHANNELS) + channel];
+		};
+
+		std::vector<short> out(signal.size());
+		for (size_t frame = 0; frame < signal.size() / CHANNELS; ++frame)
+		{
+			out[frame * CHANNELS] = Saturate(std::lrintf(at(frame, 0, 0) * sideVolumeFactor) + std::lrintf(at(frame, framesOffset, 0) * centerVolumeFactor));
+			out[(frame * CHANNELS) + 1] = Saturate(std::lrintf(at(frame, framesOffset, 1) * centerVolumeFactor) + std::lrintf(at(frame, framesOffset * 2, 1) * sideVolumeFactor));
+		}
+
+		return out;
+	}
+
+	std::vector<short> MakeSignal(size_t frames, unsigned int seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> full(-32768, 32767);
+
+		std::vector<short> samples(frames * CHANNELS);
+		for (size_t i = 0; i < samples.size(); ++i)
+		{
+			const size_t frame = i / CHANNELS;
+			switch ((frame / 3000) % 3)
+			{
+				case 0: samples[i] = static_cast<short>(full(rng)); break; // Noise.
+				case 1: samples[i] = (frame % 2 == 0) ? 32767 : -32768; break; // Saturates the sum.
+				default: samples[i] = static_cast<short>(12000.0 * std::sin(frame * 0.013)); break; // Tonal.
+			}
+		}
+
+		return samples;
+	}
+
+	/// @brief Runs the signal through the VirtualStereo in blocks of the given sizes (cycled), as the audio callback would. Returns true if bit-exact with the reference and no block allocated.
+	bool TryMatchReference(unsigned int sampleRate, unsigned int offsetMs, float sideVolumeFactor, const std::vector<size_t>& blockFrames)
+	{
+		const size_t frames = sampleRate * 2 + 123;
+		const std::vector<short> signal = MakeSignal(frames, offsetMs * 1000 + static_cast<unsigned int>(blockFrames.front()));
+
+		std::vector<short> processed = MakeSignal(frames, 1);
+		const size_t framesOffset = static_cast<size_t>(std::floor(sampleRate * (offsetMs / 1000.0)));
+
+		VirtualStereo virtualStereo(sampleRate, offsetMs, sideVolumeFactor);
+		const size_t allocationsBefore = allocations;
+
+		// Garbage first, then a Reset: must start over from silence
+		virtualStereo.Apply(processed.data(), 4096);
+		virtualStereo.Reset();
+
+		std::copy(signal.cbegin(), signal.cend(), processed.begin());
+		size_t done = 0;
+		for (size_t block = 0; done < frames; ++block)
+		{
+			const size_t count = std::min(blockFrames[block % blockFrames.size()], frames - done);
+			virtualStereo.Apply(processed.data() + (done * CHANNELS), count);
+			done += count;
+		}
+
+		return allocations == allocationsBefore && processed == ApplyReference(signal, framesOffset, sideVolumeFactor);
+	}
+}
+
+int main()
+{
+	int failures = 0;
+	const auto check = [&failures](bool ok, unsigned int sampleRate, unsigned int offsetMs, float sideVolumeFactor, const char* blocks)
+	{
+		std::printf("%s: %u Hz, %u ms, side %.2f, %s\n", (ok) ? "PASS" : "FAIL", sampleRate, offsetMs, sideVolumeFactor, blocks);
+		failures += (ok) ? 0 : 1;
+	};
+
+	const std::vector<size_t> uneven = {1, 63, 1024, 1025, 4096, 7, 480, 2048, 3};
+	for (const unsigned int offsetMs : {0u, 4u, 7u, 16u})
+	{
+		for (const float sideVolumeFactor : {0.1f, 0.18f, 0.4f})
+		{
+			check(TryMatchReference(48000, offsetMs, sideVolumeFactor, {512}), 48000, offsetMs, sideVolumeFactor, "512 frame blocks");
+			check(TryMatchReference(44100, offsetMs, sideVolumeFactor, uneven), 44100, offsetMs, sideVolumeFactor, "uneven blocks (up to 4096 frames)");
+		}
+	}
+
+	return (failures == 0) ? 0 : 1;
+}
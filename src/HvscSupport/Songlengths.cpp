@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2021-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2021-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,10 +18,12 @@
 
 #include "Songlengths.h"
 #include "../Util/Const.h"
-#include "../Util/HelpersGeneral.h"
 #include <sidplayfp/SidTuneInfo.h>
-#include <fstream>
-#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
 static constexpr uint_least8_t MD5_LEN = 32; // Standard length of MD5 hashes is 32 characters.
 
@@ -31,28 +33,68 @@ static constexpr const char CHAR_INI_SECTION = '[';
 static constexpr const char CHAR_HASH_DURATION_SEPARATOR = '=';
 static constexpr const char CHAR_SUBSONG_DURATION_SEPARATOR = ' ';
 
-static constexpr const char* const INI_SECTION_DATABASE = "[Database]";
+static constexpr std::string_view INI_SECTION_DATABASE = "[Database]";
 
 // -----------------------------------------------------------
 
+static inline int HexNibble(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+static inline int ParseInt(std::string_view str)
+{
+	int value = 0;
+	std::from_chars(str.data(), str.data() + str.size(), value);
+	return value;
+}
+
 bool Songlengths::TryLoad(const std::filesystem::path& songlengthsMd5Filepath)
 {
 	Unload();
 
-	std::ifstream file(songlengthsMd5Filepath);
+	if (!_file.TryOpen(songlengthsMd5Filepath) || _file.Size() > std::numeric_limits<uint32_t>::max())
+	{
+		Unload();
+		return false;
+	}
+
+	const std::string_view content = _file.View();
+	_database.reserve(content.size() / 64); // Rough estimate (the HVSC path comment + the MD5 line per tune).
+	_durations.reserve(content.size() / 32);
 
 	bool inDatabaseSection = false;
-	std::string line;
 
-	std::string songHvscPath;
-	while (std::getline(file, line))
+	uint32_t hvscPathOffset = 0;
+	uint32_t hvscPathLength = 0;
+
+	size_t lineStart = 0;
+	while (lineStart < content.size())
 	{
-		if (line.at(line.length() - 1) == '\r') // Clipping the CR is needed on Linux.
+		size_t lineEnd = content.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos)
 		{
-			line.erase(line.length() - 1);
+			lineEnd = content.size();
 		}
 
-		const char& firstChar = line.front();
+		std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+		const uint32_t lineOffset = static_cast<uint32_t>(lineStart);
+		lineStart = lineEnd + 1;
+
+		if (!line.empty() && line.back() == '\r') // Clipping the CR is needed on Linux.
+		{
+			line.remove_suffix(1);
+		}
+
+		if (line.empty())
+		{
+			continue;
+		}
+
+		const char firstChar = line.front();
 
 		// Ignore if not within Database section(s)
 		if (firstChar == CHAR_INI_SECTION)
@@ -71,27 +113,74 @@ bool Songlengths::TryLoad(const std::filesystem::path& songlengthsMd5Filepath)
 		{
 			if (line.length() > 2 && line.at(1) == ' ' && line.at(2) == '/')
 			{
-				songHvscPath = line.substr(2);
+				hvscPathOffset = lineOffset + 2;
+				hvscPathLength = static_cast<uint32_t>(line.length() - 2);
 			}
 
 			continue;
 		}
 
 		// Ignore if the line doesn't appear to contain MD5 hash and duration
-		if (line.length() > MD5_LEN && line.at(MD5_LEN) != CHAR_HASH_DURATION_SEPARATOR)
+		if (line.length() <= MD5_LEN || line.at(MD5_LEN) != CHAR_HASH_DURATION_SEPARATOR)
 		{
 			continue;
 		}
 
 		// ---------------------------------------------------
 
-		const std::string& md5Value = line.substr(0, MD5_LEN);
-		const std::string& durations = line.substr(MD5_LEN + 1);
+		Entry entry;
+		if (!TryParseMd5(line.substr(0, MD5_LEN), entry.md5))
+		{
+			continue;
+		}
+
+		// Decode all subsong durations once
+		entry.durationsIndex = static_cast<uint32_t>(_durations.size());
+		{
+			std::string_view durationsRaw = line.substr(MD5_LEN + 1);
+			while (!durationsRaw.empty())
+			{
+				const size_t separator = durationsRaw.find(CHAR_SUBSONG_DURATION_SEPARATOR);
+				const std::string_view preformattedDuration = durationsRaw.substr(0, separator);
+				if (!preformattedDuration.empty())
+				{
+					_durations.emplace_back(GetDurationMs(preformattedDuration));
+				}
+
+				durationsRaw.remove_prefix((separator == std::string_view::npos) ? durationsRaw.size() : separator + 1);
+			}
+		}
+		entry.durationsCount = static_cast<uint32_t>(_durations.size()) - entry.durationsIndex;
+		entry.hvscPathOffset = hvscPathOffset;
+		entry.hvscPathLength = hvscPathLength;
 
-		_database[md5Value] = std::move(std::make_unique<HvscInfoRaw>(durations, songHvscPath));
+		_database.emplace_back(entry);
 	}
 
-	file.close();
+	// Sort for the binary search. Duplicate MD5s: the last one in the file wins (as it always did).
+	std::stable_sort(_database.begin(), _database.end(), [](const Entry& a, const Entry& b) { return a.md5 < b.md5; });
+	{
+		auto itWrite = _database.begin();
+		for (auto it = _database.begin(); it != _database.end(); ++it)
+		{
+			const auto itNext = it + 1;
+			if (itNext != _database.end() && itNext->md5 == it->md5)
+			{
+				continue; // A later duplicate exists.
+			}
+
+			*itWrite++ = *it;
+		}
+
+		_database.erase(itWrite, _database.end());
+	}
+	_database.shrink_to_fit();
+	_durations.shrink_to_fit();
+
+	if (!IsLoaded())
+	{
+		Unload();
+	}
 
 	return IsLoaded();
 }
@@ -99,6 +188,10 @@ bool Songlengths::TryLoad(const std::filesystem::path& songlengthsMd5Filepath)
 void Songlengths::Unload()
 {
 	_database.clear();
+	_database.shrink_to_fit();
+	_durations.clear();
+	_durations.shrink_to_fit();
+	_file.Close();
 }
 
 bool Songlengths::IsLoaded() const
@@ -116,27 +209,19 @@ bool Songlengths::IsLoaded() const
 //
 // 1:02.500
 //
-uint_least32_t Songlengths::GetDurationMs(const std::string& preformattedDuration)
+uint_least32_t Songlengths::GetDurationMs(std::string_view preformattedDuration)
 {
 	// Convert string duration to integers
-	std::vector<std::string> subsongDurationSliced = Helpers::General::SplitString(preformattedDuration, ':');
-	const std::string& secondsRaw = subsongDurationSliced.back();
-	const bool hasMillis = secondsRaw.find('.') != std::string::npos;
+	const size_t minutesEnd = preformattedDuration.find(':');
+	const std::string_view minutesRaw = preformattedDuration.substr(0, minutesEnd);
+	const std::string_view secondsRaw = (minutesEnd == std::string_view::npos) ? preformattedDuration : preformattedDuration.substr(minutesEnd + 1);
 
-	int minutes = stoi(subsongDurationSliced.front());
-	int seconds = 0;
-	int extraMillis = 0;
+	const size_t millisStart = secondsRaw.find('.');
+	const bool hasMillis = millisStart != std::string_view::npos;
 
-	if (hasMillis)
-	{
-		std::vector<std::string> secondsMillis = Helpers::General::SplitString(secondsRaw, '.');
-		seconds = stoi(secondsMillis.front());
-		extraMillis = stoi(secondsMillis.back());
-	}
-	else
-	{
-		seconds = stoi(secondsRaw);
-	}
+	const int minutes = ParseInt(minutesRaw);
+	const int seconds = ParseInt(secondsRaw.substr(0, millisStart));
+	const int extraMillis = (hasMillis) ? ParseInt(secondsRaw.substr(millisStart + 1)) : 0;
 
 	// Convert integer duration to milliseconds
 	return (minutes * Const::MILLISECONDS_IN_MINUTE) + (seconds * Const::MILLISECONDS_IN_SECOND) + extraMillis;
@@ -155,19 +240,77 @@ Songlengths::HvscInfo Songlengths::GetHvscInfo(const char* tuneMd5, int subsong)
 		return HvscInfo(); // Tune wasn't loaded.
 	}
 
-	const auto& it = _database.find(tuneMd5);
-	if (it == _database.cend())
+	const Entry* const entry = FindEntry(tuneMd5);
+	if (entry == nullptr)
 	{
 		return HvscInfo(); // No tune in database.
 	}
 
-	const std::string& durationsRaw = it->second->durations;
-	std::vector<std::string> subsongsDurations = Helpers::General::SplitString(durationsRaw, CHAR_SUBSONG_DURATION_SEPARATOR);
-	if (subsongsDurations.size() < subsong)
+	if (subsong < 1 || static_cast<uint32_t>(subsong) > entry->durationsCount)
 	{
 		return HvscInfo(); // Database doesn't contain this subsong.
 	}
 
-	const std::string& preformattedDuration = subsongsDurations.at(subsong - 1);
-	return HvscInfo(GetDurationMs(preformattedDuration), it->second->hvscPath, tuneMd5);
+	return HvscInfo(_durations[entry->durationsIndex + subsong - 1], std::string(GetView(entry->hvscPathOffset, entry->hvscPathLength)), tuneMd5);
+}
+
+std::vector<uint_least32_t> Songlengths::GetSubsongDurations(const char* tuneMd5) const
+{
+	if (_database.empty())
+	{
+		throw std::runtime_error("Database wasn't loaded!");
+	}
+
+	const Entry* const entry = (tuneMd5 == 0) ? nullptr : FindEntry(tuneMd5);
+	if (entry == nullptr)
+	{
+		return {};
+	}
+
+	const auto itBegin = _durations.cbegin() + entry->durationsIndex;
+	return std::vector<uint_least32_t>(itBegin, itBegin + entry->durationsCount);
+}
+
+bool Songlengths::TryParseMd5(std::string_view hex, Md5Digest& outDigest)
+{
+	if (hex.length() != MD5_LEN)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < outDigest.size(); ++i)
+	{
+		const int hi = HexNibble(hex[i * 2]);
+		const int lo = HexNibble(hex[i * 2 + 1]);
+		if (hi < 0 || lo < 0)
+		{
+			return false;
+		}
+
+		outDigest[i] = static_cast<uint8_t>((hi << 4) | lo);
+	}
+
+	return true;
+}
+
+const Songlengths::Entry* Songlengths::FindEntry(const char* tuneMd5) const
+{
+	Md5Digest digest;
+	if (!TryParseMd5(std::string_view(tuneMd5, strnlen(tuneMd5, MD5_LEN + 1)), digest))
+	{
+		return nullptr;
+	}
+
+	const auto it = std::lower_bound(_database.cbegin(), _database.cend(), digest, [](const Entry& entry, const Md5Digest& value) { return entry.md5 < value; });
+	if (it == _database.cend() || it->md5 != digest)
+	{
+		return nullptr;
+	}
+
+	return &(*it);
+}
+
+std::string_view Songlengths::GetView(uint32_t offset, uint32_t length) const
+{
+	return std::string_view(_file.Data() + offset, length);
 }
@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2021-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2021-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,13 +20,15 @@
 
 // This is used instead of the libsidplayfp's SidDatabase which unfortunately segfaults when rapidly reading songlengths of huge amount of tunes from the Zip files (data from buffer).
 
+#include "../Util/MemoryMappedFile.h"
 #include <sidplayfp/SidTune.h>
 
+#include <array>
 #include <cstdint>
 #include <filesystem>
-#include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 class Songlengths
 {
@@ -49,21 +51,22 @@ public:
     };
 
 private:
-    struct HvscInfoRaw
-    {
-        HvscInfoRaw() = delete;
-        HvscInfoRaw(const std::string& aDurations, const std::string& aHvscPath) :
-            durations(aDurations),
-            hvscPath(aHvscPath)
-        {
-        }
+    using Md5Digest = std::array<uint8_t, 16>;
 
-        const std::string durations;
-        const std::string hvscPath;
+    /// @brief Compact record pointing into the memory-mapped file (no owned strings).
+    struct Entry
+    {
+        Md5Digest md5;
+        uint32_t durationsIndex; // Into the _durations table.
+        uint32_t durationsCount;
+        uint32_t hvscPathOffset;
+        uint32_t hvscPathLength;
     };
 
 public:
     Songlengths() = default;
+    Songlengths(const Songlengths&) = delete;
+    Songlengths& operator=(const Songlengths&) = delete;
 
 public:
     bool TryLoad(const std::filesystem::path& songlengthsMd5Filepath);
@@ -71,10 +74,19 @@ public:
 
     bool IsLoaded() const;
 
-    static uint_least32_t GetDurationMs(const std::string& preformattedDuration);
+    static uint_least32_t GetDurationMs(std::string_view preformattedDuration);
     HvscInfo GetHvscInfo(const char* tuneMd5, int subsong = 1) const;
 
+    /// @brief Returns the durations (in ms) of all subsongs at once, or an empty vector if the tune isn't in the database.
+    std::vector<uint_least32_t> GetSubsongDurations(const char* tuneMd5) const;
+
+private:
+    static bool TryParseMd5(std::string_view hex, Md5Digest& outDigest);
+    const Entry* FindEntry(const char* tuneMd5) const;
+    std::string_view GetView(uint32_t offset, uint32_t length) const;
+
 private:
-    using MD5 = std::string;
-    std::unordered_map<MD5, std::unique_ptr<HvscInfoRaw>> _database;
+    MemoryMappedFile _file;
+    std::vector<Entry> _database; // Sorted by the MD5 digest.
+    std::vector<uint32_t> _durations; // Pre-parsed subsong durations (ms) of all tunes, back to back.
 };
@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2024 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2024-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,16 +18,13 @@
 
 #pragma once
 
-#include <unordered_map>
-#include <string>
-
-using HvscPathsIndex = std::unordered_map<std::string, int>;
+#include <string_view>
 
 // Removes final CR from the string if present.
-inline void ClipCarriageReturn(std::string& str)
+inline void ClipCarriageReturn(std::string_view& str)
 {
-	if (str.back() == '\r')
+	if (!str.empty() && str.back() == '\r')
 	{
-		str.pop_back();
+		str.remove_suffix(1);
 	}
 }
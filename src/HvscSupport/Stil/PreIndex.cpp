@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2024-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2024-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,73 +18,161 @@
 
 #include "PreIndex.h"
 #include "../../wxApplication/Helpers/HelpersWx.h"
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 
 static const std::filesystem::path PRE_INDEX_FILE_PATH(Helpers::Wx::Files::GetConfigFilePath("stil.index").ToStdWstring());
-static constexpr const char* PRE_INDEX_FORMAT_VERSION = "1";
-static constexpr const char PRE_INDEX_NEWLINE = '\n';
 
-bool PreIndex::TryLoadFromCache(const std::string& stilVersion, HvscPathsIndex& pathsIndex)
+// Layout (little-endian, native for all supported platforms):
+// [Header][STIL version, padded to 8][Entries: u32 pathOffset, u32 pathLength, u64 dataOffset][String pool]
+static constexpr char PRE_INDEX_MAGIC[8] = {'S', 'W', 'X', 'S', 'T', 'I', 'L', '\0'};
+static constexpr uint32_t PRE_INDEX_FORMAT_VERSION = 2;
+
+namespace
 {
-	bool success = false;
+	struct Header
+	{
+		char magic[8];
+		uint32_t formatVersion;
+		uint32_t entriesCount;
+		uint64_t stilContentHash;
+		uint32_t stilVersionLength;
+		uint32_t stringPoolSize;
+	};
 
-	std::ifstream preIndexInStream(PRE_INDEX_FILE_PATH);
-	if (preIndexInStream.good())
+	static constexpr size_t ENTRY_SIZE = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+	inline size_t PadTo8(size_t size)
 	{
-		std::string line;
-		if (NextLineEquals(preIndexInStream, line, PRE_INDEX_FORMAT_VERSION) && // Check the index file format version. If we've changed the format in a new sidplaywx update, this existing older file will be invalidated.
-			NextLineEquals(preIndexInStream, line, stilVersion.c_str())) // Check the STIL.txt version for which this pre-index file was generated. If it differs it will be invalidated.
-		{
-			const int expectedEntriesCount = NextLineAsInt(preIndexInStream, line);
-			if (expectedEntriesCount > 0)
-			{
-				std::string position;
-				while(std::getline(preIndexInStream, line) && !line.empty())
-				{
-					std::getline(preIndexInStream, position);
-					try
-					{
-						pathsIndex[line] = std::stoi(position);
-					}
-					catch (std::invalid_argument)
-					{
-						break; // Index file is corrupted.
-					}
-				}
-
-				if (pathsIndex.size() == expectedEntriesCount) // Check the integrity of the index file.
-				{
-					success = true;
-				}
-				else
-				{
-					pathsIndex.clear(); // Index file is corrupted.
-				}
-			}
-		}
+		return (size + 7) & ~static_cast<size_t>(7);
 	}
 
-	preIndexInStream.close();
-	return success;
+	template <typename T>
+	inline T ReadAt(const char* src)
+	{
+		T value;
+		std::memcpy(&value, src, sizeof(T)); // Avoids unaligned access.
+		return value;
+	}
+
+	template <typename T>
+	inline void WriteAt(char* dst, T value)
+	{
+		std::memcpy(dst, &value, sizeof(T));
+	}
 }
 
-void PreIndex::RebuildIndexAndCache(const std::string& stilVersion, HvscPathsIndex& pathsIndex, std::ifstream& stilDataStream)
+bool PreIndex::TryLoadFromCache(const std::string& stilVersion, uint64_t stilContentHash)
 {
+	Unload();
+
+	if (!_cacheFile.TryOpen(PRE_INDEX_FILE_PATH))
+	{
+		return false;
+	}
+
+	if (!TryAttach(_cacheFile.View(), stilVersion, stilContentHash))
+	{
+		Unload(); // Outdated or corrupted.
+		return false;
+	}
+
+	return true;
+}
+
+void PreIndex::RebuildIndexAndCache(const std::string& stilVersion, uint64_t stilContentHash, std::string_view stilContent)
+{
+	Unload();
+
+	struct RawEntry
+	{
+		std::string_view path;
+		uint64_t dataOffset;
+	};
+
 	// Do the actual (slow) pre-indexing
+	std::vector<RawEntry> rawEntries;
 	{
-		stilDataStream.clear(); // Rewind (just in case).
+		size_t lineStart = 0;
+		while (lineStart < stilContent.size())
+		{
+			size_t lineEnd = stilContent.find('\n', lineStart);
+			if (lineEnd == std::string_view::npos)
+			{
+				lineEnd = stilContent.size();
+			}
+
+			std::string_view line = stilContent.substr(lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1;
+
+			if (!line.empty() && line.front() == '/')
+			{
+				ClipCarriageReturn(line);
+				rawEntries.push_back({line, std::min(static_cast<uint64_t>(lineStart), static_cast<uint64_t>(stilContent.size()))});
+			}
+		}
+
+		std::stable_sort(rawEntries.begin(), rawEntries.end(), [](const RawEntry& a, const RawEntry& b) { return a.path < b.path; });
 
-		std::string line;
-		while (std::getline(stilDataStream, line))
+		// Duplicate paths: the last one wins (as with the former map-based index).
+		auto itWrite = rawEntries.begin();
+		for (auto it = rawEntries.begin(); it != rawEntries.end(); ++it)
 		{
-			if (line.front() == '/')
+			if (it + 1 != rawEntries.end() && (it + 1)->path == it->path)
 			{
-				ClipCarriageReturn(line); // Reminder: any existing "line" iterators are invalid now.
-				pathsIndex[line] = stilDataStream.tellg();
+				continue;
 			}
+
+			*itWrite++ = *it;
+		}
+
+		rawEntries.erase(itWrite, rawEntries.end());
+	}
+
+	// Build the binary image
+	{
+		size_t stringPoolSize = 0;
+		for (const RawEntry& entry : rawEntries)
+		{
+			stringPoolSize += entry.path.size();
+		}
+
+		const size_t versionBlockSize = PadTo8(stilVersion.size());
+		const size_t tableOffset = sizeof(Header) + versionBlockSize;
+		const size_t poolOffset = tableOffset + rawEntries.size() * ENTRY_SIZE;
+
+		_builtImage.assign(poolOffset + stringPoolSize, '\0');
+		char* const image = _builtImage.data();
+
+		Header header{};
+		std::memcpy(header.magic, PRE_INDEX_MAGIC, sizeof(header.magic));
+		header.formatVersion = PRE_INDEX_FORMAT_VERSION;
+		header.entriesCount = static_cast<uint32_t>(rawEntries.size());
+		header.stilContentHash = stilContentHash;
+		header.stilVersionLength = static_cast<uint32_t>(stilVersion.size());
+		header.stringPoolSize = static_cast<uint32_t>(stringPoolSize);
+		std::memcpy(image, &header, sizeof(Header));
+		std::memcpy(image + sizeof(Header), stilVersion.data(), stilVersion.size());
+
+		uint32_t pathOffset = 0;
+		for (size_t i = 0; i < rawEntries.size(); ++i)
+		{
+			const RawEntry& entry = rawEntries[i];
+			char* const dst = image + tableOffset + i * ENTRY_SIZE;
+
+			WriteAt<uint32_t>(dst, pathOffset);
+			WriteAt<uint32_t>(dst + sizeof(uint32_t), static_cast<uint32_t>(entry.path.size()));
+			WriteAt<uint64_t>(dst + sizeof(uint32_t) * 2, entry.dataOffset);
+
+			std::memcpy(image + poolOffset + pathOffset, entry.path.data(), entry.path.size());
+			pathOffset += static_cast<uint32_t>(entry.path.size());
 		}
 	}
 
+	TryAttach(std::string_view(_builtImage.data(), _builtImage.size()), stilVersion, stilContentHash);
+
 	// Write a new index file so that we can skip the expensive pre-indexing next time
 	{
 #ifndef WIN32
@@ -98,16 +186,125 @@ void PreIndex::RebuildIndexAndCache(const std::string& stilVersion, HvscPathsInd
 
 		if (preIndexOutStream.good())
 		{
-			preIndexOutStream << PRE_INDEX_FORMAT_VERSION << PRE_INDEX_NEWLINE;
-			preIndexOutStream << stilVersion << PRE_INDEX_NEWLINE;
-			preIndexOutStream << pathsIndex.size() << PRE_INDEX_NEWLINE;
-			for (const auto& [hvscPath, position] : pathsIndex)
-			{
-				preIndexOutStream << hvscPath << PRE_INDEX_NEWLINE;
-				preIndexOutStream << position << PRE_INDEX_NEWLINE;
-			}
+			preIndexOutStream.write(_builtImage.data(), static_cast<std::streamsize>(_builtImage.size()));
 		}
 
 		preIndexOutStream.close();
 	}
 }
+
+void PreIndex::Unload()
+{
+	_table = nullptr;
+	_stringPool = nullptr;
+	_stringPoolSize = 0;
+	_entriesCount = 0;
+
+	_builtImage.clear();
+	_builtImage.shrink_to_fit();
+	_cacheFile.Close();
+}
+
+bool PreIndex::IsLoaded() const
+{
+	return _entriesCount > 0;
+}
+
+bool PreIndex::TryFind(std::string_view hvscPath, uint64_t& outOffset) const
+{
+	size_t low = 0;
+	size_t high = _entriesCount;
+	while (low < high)
+	{
+		const size_t mid = low + (high - low) / 2;
+		const int cmp = GetPath(mid).compare(hvscPath);
+		if (cmp == 0)
+		{
+			outOffset = GetDataOffset(mid);
+			return true;
+		}
+
+		if (cmp < 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return false;
+}
+
+uint64_t PreIndex::CalcContentHash(std::string_view content)
+{
+	// FNV-1a (64-bit)
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (const char c : content)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
+bool PreIndex::TryAttach(std::string_view image, const std::string& stilVersion, uint64_t stilContentHash)
+{
+	if (image.size() < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header header = ReadAt<Header>(image.data());
+	if (std::memcmp(header.magic, PRE_INDEX_MAGIC, sizeof(header.magic)) != 0 || header.formatVersion != PRE_INDEX_FORMAT_VERSION) // If we've changed the format in a new sidplaywx update, this existing older file will be invalidated.
+	{
+		return false;
+	}
+
+	if (header.stilContentHash != stilContentHash || header.stilVersionLength != stilVersion.size()) // The STIL.txt for which this pre-index file was generated differs.
+	{
+		return false;
+	}
+
+	const size_t tableOffset = sizeof(Header) + PadTo8(header.stilVersionLength);
+	const size_t poolOffset = tableOffset + static_cast<size_t>(header.entriesCount) * ENTRY_SIZE;
+	if (image.size() != poolOffset + header.stringPoolSize || image.substr(sizeof(Header), header.stilVersionLength) != stilVersion) // Check the integrity of the index file and the version.
+	{
+		return false;
+	}
+
+	_table = image.data() + tableOffset;
+	_stringPool = image.data() + poolOffset;
+	_stringPoolSize = header.stringPoolSize;
+	_entriesCount = header.entriesCount;
+
+	// Validate the string pool references once so that the lookups don't have to
+	for (size_t i = 0; i < _entriesCount; ++i)
+	{
+		const char* const src = _table + i * ENTRY_SIZE;
+		const uint64_t pathEnd = static_cast<uint64_t>(ReadAt<uint32_t>(src)) + ReadAt<uint32_t>(src + sizeof(uint32_t));
+		if (pathEnd > _stringPoolSize)
+		{
+			_table = nullptr;
+			_stringPool = nullptr;
+			_stringPoolSize = 0;
+			_entriesCount = 0;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::string_view PreIndex::GetPath(size_t entryIndex) const
+{
+	const char* const src = _table + entryIndex * ENTRY_SIZE;
+	return std::string_view(_stringPool + ReadAt<uint32_t>(src), ReadAt<uint32_t>(src + sizeof(uint32_t)));
+}
+
+uint64_t PreIndex::GetDataOffset(size_t entryIndex) const
+{
+	return ReadAt<uint64_t>(_table + entryIndex * ENTRY_SIZE + sizeof(uint32_t) * 2);
+}
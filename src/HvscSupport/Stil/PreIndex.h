@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2024-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2024-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,37 +19,46 @@
 #pragma once
 
 #include "Common.h"
-#include <fstream>
+#include "../../Util/MemoryMappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
 
+/// @brief Binary index of the HVSC paths within the STIL.txt (sorted path table + string pool), cached on disk and memory-mapped on the next launch.
 class PreIndex
 {
 public:
-	PreIndex() = delete;
+	PreIndex() = default;
 	PreIndex(PreIndex&) = delete;
 
 public:
-	static bool TryLoadFromCache(const std::string& stilVersion, HvscPathsIndex& pathsIndex);
-	static void RebuildIndexAndCache(const std::string& stilVersion, HvscPathsIndex& pathsIndex, std::ifstream& stilDataStream);
+	/// @brief Maps the cached index file if it matches the format version, the STIL version and the STIL.txt content hash.
+	bool TryLoadFromCache(const std::string& stilVersion, uint64_t stilContentHash);
+
+	/// @brief Scans the STIL.txt content and (re)writes the cached index file. The index is usable even if the file couldn't be written.
+	void RebuildIndexAndCache(const std::string& stilVersion, uint64_t stilContentHash, std::string_view stilContent);
+
+	void Unload();
+	bool IsLoaded() const;
+
+	/// @brief Finds the STIL.txt offset of the first line following the tune's HVSC path line.
+	bool TryFind(std::string_view hvscPath, uint64_t& outOffset) const;
+
+	static uint64_t CalcContentHash(std::string_view content);
 
 private:
-	// Reads the next line of a stream (advancing it) and checks its content against a given one. This function allows for chained one-liners.
-	static inline bool NextLineEquals(std::ifstream& stream, std::string& lineBuffer, const char* compareWith)
-	{
-		std::getline(stream, lineBuffer);
-		return (lineBuffer == compareWith);
-	}
-
-	// Reads the next line of a stream (advancing it) and returns the value as an integer if possible, otherwise returns the fallbackValue.
-	static inline int NextLineAsInt(std::ifstream& stream, std::string& lineBuffer, int fallbackValue = -1)
-	{
-		std::getline(stream, lineBuffer);
-		try
-		{
-			return std::stoi(lineBuffer);
-		}
-		catch (std::invalid_argument)
-		{
-			return fallbackValue;
-		}
-	}
+	/// @brief Validates the image header and sets up the table/pool views.
+	bool TryAttach(std::string_view image, const std::string& stilVersion, uint64_t stilContentHash);
+	std::string_view GetPath(size_t entryIndex) const;
+	uint64_t GetDataOffset(size_t entryIndex) const;
+
+private:
+	MemoryMappedFile _cacheFile;
+	std::vector<char> _builtImage; // Used instead of the mapped file right after a rebuild.
+
+	const char* _table = nullptr;
+	const char* _stringPool = nullptr;
+	size_t _stringPoolSize = 0;
+	uint32_t _entriesCount = 0;
 };
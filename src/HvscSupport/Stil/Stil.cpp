@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2024-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2024-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,9 +17,9 @@
  */
 
 #include "Stil.h"
-#include "PreIndex.h"
+#include <charconv>
 
-static const std::string STIL_VERSION_PREFIX("#  STIL v");
+static constexpr std::string_view STIL_VERSION_PREFIX("#  STIL v");
 static constexpr const char STIL_CHAR_COMMENT = '#';
 static constexpr size_t STIL_LABEL_LENGTH = 9; // Labels (NAME, TITLE, ARTIST, AUTHOR, COMMENT) always end with a colon and a space and have 9 characters total (all padded with spaces except the COMMENT).
 
@@ -60,7 +60,7 @@ namespace
 	}
 
 	// Adds a line content (skipping the label prefix) into the target field under an existing key.
-	inline void AddLineContent(Stil::Field& target, int key, const std::string& line)
+	inline void AddLineContent(Stil::Field& target, int key, std::string_view line)
 	{
 		target[key].emplace_back(line.substr(STIL_LABEL_LENGTH));
 	}
@@ -98,10 +98,7 @@ std::string Stil::Info::GetFieldAsString(const Field& field, int subsong, const
 #pragma endregion
 #pragma region Actual Stil class
 
-Stil::Stil()
-{
-	_hvscPathsIndex.rehash(0); // This makes all clear() calls instant (orders of magnitude faster) and doesn't affect the filling speed. The app closes faster.
-}
+Stil::Stil() = default;
 
 Stil::~Stil()
 {
@@ -113,46 +110,40 @@ bool Stil::TryLoad(const std::filesystem::path& stilFilepath)
 	Unload();
 	std::string stilVersion;
 
-	// Lock & load the STIL.txt file
+	// Map the STIL.txt file
+	if (!_stilFile.TryOpen(stilFilepath))
 	{
-		_stilDataStream.open(stilFilepath, std::ios::binary);
-		_stilDataStream.clear();
-		if (!_stilDataStream.good())
-		{
-			return false;
-		}
+		return false;
+	}
 
-		// Determine the STIL.txt version
-		{
-			std::string line;
-			const size_t len = STIL_VERSION_PREFIX.length();
-			while (std::getline(_stilDataStream, line))
-			{
-				if (line.substr(0, len) == STIL_VERSION_PREFIX)
-				{
-					const size_t end = line.find(' ', len);
-					if (end != std::string::npos)
-					{
-						stilVersion = line.substr(len, end - len);
-					}
-					break;
-				}
-			}
+	const std::string_view content = _stilFile.View();
 
-			if (stilVersion.empty())
+	// Determine the STIL.txt version
+	{
+		const size_t versionStart = content.find(STIL_VERSION_PREFIX);
+		if (versionStart != std::string_view::npos && (versionStart == 0 || content[versionStart - 1] == '\n'))
+		{
+			const size_t len = versionStart + STIL_VERSION_PREFIX.length();
+			const size_t end = content.find_first_of(" \r\n", len);
+			if (end != std::string_view::npos && content[end] == ' ')
 			{
-				return false; // Unknown STIL.txt version. Possibly corrupted file or not STIL.txt?
+				stilVersion = content.substr(len, end - len);
 			}
+		}
 
-			_stilDataStream.clear(); // Rewind & reset the stream.
+		if (stilVersion.empty())
+		{
+			Unload();
+			return false; // Unknown STIL.txt version. Possibly corrupted file or not STIL.txt?
 		}
 	}
 
-	// Load the pre-index file if valid
-	if (!PreIndex::TryLoadFromCache(stilVersion, _hvscPathsIndex))
+	// Load the pre-index file if valid (the content hash catches an edited STIL.txt even if the version string stayed the same)
+	const uint64_t contentHash = PreIndex::CalcContentHash(content);
+	if (!_preIndex.TryLoadFromCache(stilVersion, contentHash))
 	{
 		// Pre-index the positions of STIL tunes, so when we want to fetch data for any tune later, we can do so without having to parse the entire file again
-		PreIndex::RebuildIndexAndCache(stilVersion, _hvscPathsIndex, _stilDataStream);
+		_preIndex.RebuildIndexAndCache(stilVersion, contentHash, content);
 	}
 
 	_stilFilepath = stilFilepath;
@@ -162,17 +153,18 @@ bool Stil::TryLoad(const std::filesystem::path& stilFilepath)
 
 void Stil::Unload()
 {
-	_hvscPathsIndex.clear();
+	AbortPreload();
+	_preIndex.Unload();
 	_stilFilepath.clear();
-	_stilDataStream.close();
+	_stilFile.Close();
 }
 
 bool Stil::IsLoaded() const
 {
-	return !_hvscPathsIndex.empty();
+	return _preIndex.IsLoaded();
 }
 
-Stil::Info Stil::Get(const std::string& tuneHvscPath)
+Stil::Info Stil::Get(const std::string& tuneHvscPath) const
 {
 	Stil::Info data;
 	if (!IsLoaded())
@@ -185,93 +177,202 @@ Stil::Info Stil::Get(const std::string& tuneHvscPath)
 		return data; // Unknown SID tune.
 	}
 
-	// Parse info
+	if (IsPreloaded())
+	{
+		const Info* const preloaded = TryGetPreloaded(tuneHvscPath);
+		return (preloaded == nullptr) ? data : *preloaded;
+	}
+
+	uint64_t offset = 0;
+	if (_preIndex.TryFind(tuneHvscPath, offset) && offset <= _stilFile.Size())
+	{
+		data = ParseEntry(static_cast<size_t>(offset));
+	}
+
+	return data;
+}
+
+void Stil::PreloadAsync()
+{
+	AbortPreload();
+
+	if (!IsLoaded())
+	{
+		return;
+	}
+
+	_preloadThread = std::thread([this]()
 	{
-		const auto& itStart = _hvscPathsIndex.find(tuneHvscPath);
-		if (itStart != _hvscPathsIndex.end())
+		std::unordered_map<std::string_view, Info> entries;
+		const std::string_view content = _stilFile.View();
+
+		size_t lineStart = 0;
+		while (lineStart < content.size())
 		{
-			_stilDataStream.clear();
-			_stilDataStream.seekg(itStart->second);
+			if (_abortPreloadFlag) [[unlikely]]
+			{
+				return;
+			}
+
+			size_t lineEnd = content.find('\n', lineStart);
+			if (lineEnd == std::string_view::npos)
+			{
+				lineEnd = content.size();
+			}
 
-			int subsongKey = 1; // Reminder: this is not index, but an unordered dict key!
-			std::string line;
+			std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+			lineStart = lineEnd + 1;
 
-			while (std::getline(_stilDataStream, line))
+			if (!line.empty() && line.front() == '/')
 			{
-				ClipCarriageReturn(line); // Reminder: any existing "line" iterators are invalid now.
+				ClipCarriageReturn(line);
+				entries[line] = ParseEntry(std::min(lineStart, content.size())); // Duplicate paths: the last one wins (same as the pre-index).
+			}
+		}
 
-				// Treat an empty line as the end of this tune's data
-				if (line.empty())
-				{
-					break;
-				}
+		_preloadedEntries = std::move(entries);
+		_preloaded.store(true, std::memory_order_release);
+	});
+}
 
-				const char firstChar = line.front(); // Reminder: shouldn't call .front() on an empty string, thus we have a preceding check for it above.
+bool Stil::IsPreloaded() const
+{
+	return _preloaded.load(std::memory_order_acquire);
+}
 
-				// Treat beginning of the next tune as the end of this tune's data
-				if (firstChar == '/')
-				{
-					break;
-				}
+const Stil::Info* Stil::TryGetPreloaded(std::string_view tuneHvscPath) const
+{
+	if (!IsPreloaded())
+	{
+		return nullptr;
+	}
 
-				// Skip a comment line
-				if (firstChar == STIL_CHAR_COMMENT)
-				{
-					continue;
-				}
+	const auto it = _preloadedEntries.find(tuneHvscPath);
+	return (it == _preloadedEntries.cend()) ? nullptr : &it->second;
+}
 
-				// Subsong selector
-				if (firstChar == '(' && line.length() > 2 && line.at(1) == '#')
-				{
-					subsongKey = std::stoi(line.substr(2, line.length() - 1));
-					continue;
-				}
+const Stil::Info& Stil::GetPreloadedOrParse(const std::string& tuneHvscPath, Info& fallbackStorage) const
+{
+	if (IsPreloaded())
+	{
+		const Info* const preloaded = TryGetPreloaded(tuneHvscPath);
+		return (preloaded == nullptr) ? fallbackStorage : *preloaded; // Blank fallback if there's no entry.
+	}
+
+	fallbackStorage = Get(tuneHvscPath);
+	return fallbackStorage;
+}
+
+void Stil::AbortPreload()
+{
+	_abortPreloadFlag = true;
+	if (_preloadThread.joinable())
+	{
+		_preloadThread.join();
+	}
+
+	_abortPreloadFlag = false;
+	_preloaded = false;
+	_preloadedEntries.clear();
+}
+
+Stil::Info Stil::ParseEntry(size_t offset) const
+{
+	Stil::Info data;
+
+	const std::string_view content = _stilFile.View();
+	size_t lineStart = offset;
+
+	int subsongKey = 1; // Reminder: this is not index, but an unordered dict key!
+
+	while (lineStart < content.size())
+	{
+		size_t lineEnd = content.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos)
+		{
+			lineEnd = content.size();
+		}
+
+		std::string_view line = content.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		ClipCarriageReturn(line);
+
+		// Treat an empty line as the end of this tune's data
+		if (line.empty())
+		{
+			break;
+		}
+
+		const char firstChar = line.front(); // Reminder: shouldn't call .front() on an empty string, thus we have a preceding check for it above.
+
+		// Treat beginning of the next tune as the end of this tune's data
+		if (firstChar == '/')
+		{
+			break;
+		}
 
-				// Extract NAME, TITLE, ARTIST, AUTHOR, COMMENT fields
-				if (line.length() > STIL_LABEL_LENGTH)
+		// Skip a comment line
+		if (firstChar == STIL_CHAR_COMMENT)
+		{
+			continue;
+		}
+
+		// Subsong selector
+		if (firstChar == '(' && line.length() > 2 && line.at(1) == '#')
+		{
+			int parsedKey = 0;
+			if (std::from_chars(line.data() + 2, line.data() + line.length(), parsedKey).ec == std::errc())
+			{
+				subsongKey = parsedKey;
+			}
+
+			continue;
+		}
+
+		// Extract NAME, TITLE, ARTIST, AUTHOR, COMMENT fields
+		if (line.length() > STIL_LABEL_LENGTH)
+		{
+			const std::string_view fieldLabel = line.substr(0, STIL_LABEL_LENGTH);
+
+			if (fieldLabel == "   NAME: ")
+			{
+				AddLineContent(data.names, subsongKey, line);
+				continue;
+			}
+
+			if (fieldLabel == "  TITLE: ")
+			{
+				AddLineContent(data.titles, subsongKey, line);
+				continue;
+			}
+
+			if (fieldLabel == " ARTIST: ")
+			{
+				AddLineContent(data.artists, subsongKey, line);
+				continue;
+			}
+
+			if (fieldLabel == " AUTHOR: ")
+			{
+				AddLineContent(data.authors, subsongKey, line);
+				continue;
+			}
+
+			if (fieldLabel == "COMMENT: ")
+			{
+				AddLineContent(data.comments, subsongKey, line);
+				continue;
+			}
+			else if (fieldLabel == "         ") // Multi-line comment's next line.
+			{
+				// Append it only if an actual comment exists (it would be weird if not, but we do this check anyway)
+				if (data.comments.find(subsongKey) != data.comments.end() && !data.comments.at(subsongKey).back().empty())
 				{
-					const std::string& fieldLabel = line.substr(0, STIL_LABEL_LENGTH);
-
-					if (fieldLabel == "   NAME: ")
-					{
-						AddLineContent(data.names, subsongKey, line);
-						continue;
-					}
-
-					if (fieldLabel == "  TITLE: ")
-					{
-						AddLineContent(data.titles, subsongKey, line);
-						continue;
-					}
-
-					if (fieldLabel == " ARTIST: ")
-					{
-						AddLineContent(data.artists, subsongKey, line);
-						continue;
-					}
-
-					if (fieldLabel == " AUTHOR: ")
-					{
-						AddLineContent(data.authors, subsongKey, line);
-						continue;
-					}
-
-					if (fieldLabel == "COMMENT: ")
-					{
-						AddLineContent(data.comments, subsongKey, line);
-						continue;
-					}
-					else if (fieldLabel == "         ") // Multi-line comment's next line.
-					{
-						// Append it only if an actual comment exists (it would be weird if not, but we do this check anyway)
-						if (data.comments.find(subsongKey) != data.comments.end() && !data.comments.at(subsongKey).back().empty())
-						{
-							data.comments[subsongKey].back().append(" ").append(line.substr(STIL_LABEL_LENGTH));
-						}
-
-						continue;
-					}
+					data.comments[subsongKey].back().append(" ").append(line.substr(STIL_LABEL_LENGTH));
 				}
+
+				continue;
 			}
 		}
 	}
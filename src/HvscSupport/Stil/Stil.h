@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2024-2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2024-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,9 +19,13 @@
 #pragma once
 
 #include "Common.h"
+#include "PreIndex.h"
+#include "../../Util/MemoryMappedFile.h"
+#include <atomic>
 #include <filesystem>
-#include <fstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -58,10 +62,29 @@ public:
 
 	bool IsLoaded() const;
 
-	Info Get(const std::string& tuneHvscPath);
+	Info Get(const std::string& tuneHvscPath) const;
+
+	/// @brief Parses all STIL entries into memory on a background thread. Once done, the lookups no longer touch the STIL.txt at all.
+	void PreloadAsync();
+	bool IsPreloaded() const;
+
+	/// @brief Allocation-free lookup for the preloaded mode. Returns nullptr if not preloaded (yet) or if there's no entry for the tune.
+	const Info* TryGetPreloaded(std::string_view tuneHvscPath) const;
+
+	/// @brief Returns the preloaded entry (no copy) if the preload is done, otherwise parses the entry into the fallbackStorage and returns that. Decided once, so it's safe while the preload finishes concurrently.
+	const Info& GetPreloadedOrParse(const std::string& tuneHvscPath, Info& fallbackStorage) const;
+
+private:
+	Info ParseEntry(size_t offset) const;
+	void AbortPreload();
 
 private:
 	std::filesystem::path _stilFilepath;
-	std::ifstream _stilDataStream;
-	HvscPathsIndex _hvscPathsIndex;
+	MemoryMappedFile _stilFile;
+	PreIndex _preIndex;
+
+	std::unordered_map<std::string_view, Info> _preloadedEntries; // Keys point into the mapped STIL.txt.
+	std::thread _preloadThread;
+	std::atomic_bool _preloaded = false;
+	std::atomic_bool _abortPreloadFlag = false;
 };
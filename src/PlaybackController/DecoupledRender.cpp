@@ -0,0 +1,153 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "DecoupledRender.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring> // memcpy & memset
+
+static constexpr size_t MAX_CHUNK_FRAMES = 512; // Keep the emulation chunks small so the ring gets topped up often.
+static constexpr std::chrono::milliseconds PRODUCER_MAX_WAIT_MS(20); // The ring is full, wait for the callback to drain it. The callback never locks, so a signal may slip by just before the wait, which the next callback's signal (or this timeout) covers.
+
+DecoupledRender::~DecoupledRender()
+{
+	Stop();
+}
+
+void DecoupledRender::Start(IBufferWriter& source, int numChannels, size_t depthFrames, size_t callbackFrames)
+{
+	Stop();
+
+	_depthFrames = std::max<size_t>(depthFrames, 2 * std::max<size_t>(callbackFrames, 1));
+
+	size_t capacity = 1;
+	while (capacity < _depthFrames)
+	{
+		capacity <<= 1;
+	}
+
+	if (capacity != _capacityFrames || numChannels != _numChannels)
+	{
+		_ring = std::make_unique<short[]>(capacity * numChannels);
+	}
+
+	_capacityFrames = capacity;
+	_numChannels = numChannels;
+
+	_writtenFrames = 0;
+	_readFrames = 0;
+	_sourceEnded = false;
+	_abortFlag = false;
+
+	_thread = std::thread(&DecoupledRender::ProducerLoop, this, std::ref(source));
+}
+
+void DecoupledRender::Stop()
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_drainMutex);
+			_abortFlag = true;
+		}
+
+		_drainCv.notify_all();
+		_thread.join();
+	}
+
+	_abortFlag = false;
+	_writtenFrames = 0;
+	_readFrames = 0;
+}
+
+bool DecoupledRender::IsRunning() const
+{
+	return _thread.joinable();
+}
+
+bool DecoupledRender::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
+{
+	short* out = static_cast<short*>(buffer);
+
+	const size_t read = _readFrames.load(std::memory_order_relaxed);
+	const size_t available = _writtenFrames.load(std::memory_order_acquire) - read;
+
+	if (available == 0 && _sourceEnded.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	const size_t frames = std::min<size_t>(available, framesPerBuffer);
+	const size_t mask = _capacityFrames - 1;
+
+	// Copy in (at most) two parts due to the wrap-around
+	const size_t start = read & mask;
+	const size_t firstPart = std::min(frames, _capacityFrames - start);
+	std::memcpy(out, _ring.get() + (start * _numChannels), firstPart * _numChannels * sizeof(short));
+	std::memcpy(out + (firstPart * _numChannels), _ring.get(), (frames - firstPart) * _numChannels * sizeof(short));
+
+	// Underrun: pad with silence rather than blocking the callback
+	if (frames < framesPerBuffer)
+	{
+		std::memset(out + (frames * _numChannels), 0, (framesPerBuffer - frames) * _numChannels * sizeof(short));
+	}
+
+	_readFrames.store(read + frames, std::memory_order_release);
+	_drainCv.notify_one();
+	return true;
+}
+
+size_t DecoupledRender::GetBufferedFrames() const
+{
+	return _writtenFrames.load(std::memory_order_acquire) - _readFrames.load(std::memory_order_acquire);
+}
+
+void DecoupledRender::ProducerLoop(IBufferWriter& source)
+{
+	const size_t mask = _capacityFrames - 1;
+
+	while (!_abortFlag)
+	{
+		const size_t written = _writtenFrames.load(std::memory_order_relaxed);
+		const size_t free = _depthFrames - (written - _readFrames.load(std::memory_order_acquire));
+		if (free == 0)
+		{
+			std::unique_lock<std::mutex> lock(_drainMutex);
+			_drainCv.wait_for(lock, PRODUCER_MAX_WAIT_MS, [this, written]()
+			{
+				return _abortFlag || written - _readFrames.load(std::memory_order_acquire) < _depthFrames;
+			});
+
+			continue;
+		}
+
+		// Render straight into the ring (never across the wrap-around)
+		const size_t start = written & mask;
+		const size_t chunk = std::min({free, MAX_CHUNK_FRAMES, _capacityFrames - start});
+
+		const bool success = source.TryFillBuffer(_ring.get() + (start * _numChannels), static_cast<unsigned long>(chunk));
+		if (!success)
+		{
+			_sourceEnded.store(true, std::memory_order_release);
+			return;
+		}
+
+		_writtenFrames.store(written + chunk, std::memory_order_release);
+	}
+}
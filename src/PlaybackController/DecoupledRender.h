@@ -0,0 +1,69 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "PlaybackWrappers/IBufferWriter.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/// @brief Decouples the emulation from the real-time audio callback: a producer thread renders ahead into a lock-free single-producer/single-consumer ring, so the callback only has to copy.
+class DecoupledRender : public IBufferWriter
+{
+public:
+	DecoupledRender() = default;
+	DecoupledRender(DecoupledRender&) = delete;
+
+	~DecoupledRender();
+
+public:
+	/// @brief Starts (or restarts) rendering from the source. The depth is the maximum amount of frames rendered ahead of the playback.
+	/// The depth is raised to at least twice the callbackFrames (the expected audio callback buffer size), as a shallower ring would underrun on every callback.
+	void Start(IBufferWriter& source, int numChannels, size_t depthFrames, size_t callbackFrames);
+
+	/// @brief Stops the producer and discards any buffered audio. The source must not be touched by anyone else before this is called.
+	void Stop();
+
+	bool IsRunning() const;
+	bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) override;
+
+	/// @brief Returns the amount of frames rendered but not yet played (i.e., how far the source is ahead of the playback).
+	size_t GetBufferedFrames() const;
+
+private:
+	void ProducerLoop(IBufferWriter& source);
+
+private:
+	int _numChannels = 0;
+	size_t _depthFrames = 0;
+	size_t _capacityFrames = 0; // Power of two (>= depth).
+	std::unique_ptr<short[]> _ring;
+
+	// Monotonic frame counters (wrapped into the ring by the mask); the producer owns the write one and the consumer owns the read one
+	alignas(64) std::atomic_size_t _writtenFrames = 0;
+	alignas(64) std::atomic_size_t _readFrames = 0;
+
+	std::thread _thread;
+	std::mutex _drainMutex;
+	std::condition_variable _drainCv; // The consumer signals it (without locking) after draining, so the full ring's producer can top it up.
+	std::atomic_bool _abortFlag = false;
+	std::atomic_bool _sourceEnded = false;
+};
@@ -0,0 +1,229 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "OfflineRender.h"
+#include "WavFileWriter.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	constexpr unsigned long CHUNK_FRAMES = 16384;
+}
+
+OfflineRender::Settings::Settings(const PlaybackController& playback) :
+	playbackConfig(playback.GetSyncedPlaybackConfig()),
+	channelMatrix(playback.GetChannelMatrixConfig()),
+	roms(playback.GetRomPaths())
+{
+	static constexpr unsigned int MAX_SIDS = 3;
+	static constexpr unsigned int MAX_VOICES = 4; // Including the digi.
+
+	voicesEnabled.assign(MAX_SIDS, std::vector<bool>(MAX_VOICES, true));
+	filtersEnabled.assign(MAX_SIDS, true);
+
+	if (playback.IsValidSongLoaded())
+	{
+		for (unsigned int sid = 0; sid < MAX_SIDS; ++sid)
+		{
+			for (unsigned int voice = 0; voice < MAX_VOICES; ++voice)
+			{
+				voicesEnabled[sid][voice] = playback.IsVoiceEnabled(sid, voice);
+			}
+
+			filtersEnabled[sid] = playback.IsFilterEnabled(sid);
+		}
+	}
+}
+
+OfflineRender::OfflineRender(std::vector<Job>&& jobs, const Settings& settings, unsigned int maxWorkers) :
+	_jobs(std::move(jobs)),
+	_settings(settings),
+	_statuses(_jobs.size(), JobStatus::Pending)
+{
+	const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	const unsigned int numWorkers = (maxWorkers == 0) ? cores : std::min(maxWorkers, cores);
+	const size_t effectiveWorkers = std::min(static_cast<size_t>(numWorkers), _jobs.size());
+
+	_workers.reserve(effectiveWorkers);
+	for (size_t i = 0; i < effectiveWorkers; ++i)
+	{
+		_workers.emplace_back(&OfflineRender::WorkerLoop, this);
+	}
+}
+
+OfflineRender::~OfflineRender()
+{
+	Abort();
+}
+
+bool OfflineRender::TryRenderToWav(const Job& job, const Settings& settings, const std::atomic_bool* abortFlag)
+{
+	SidDecoder decoder;
+	return TryInitDecoder(decoder, settings) && TryRender(decoder, job, settings, abortFlag);
+}
+
+size_t OfflineRender::GetJobsCount() const
+{
+	return _jobs.size();
+}
+
+size_t OfflineRender::GetFinishedCount() const
+{
+	return _finishedCount;
+}
+
+OfflineRender::JobStatus OfflineRender::GetJobStatus(size_t jobIndex) const
+{
+	std::lock_guard<std::mutex> lock(_statusMutex);
+	return _statuses.at(jobIndex);
+}
+
+bool OfflineRender::IsDone() const
+{
+	return _finishedCount == _jobs.size();
+}
+
+void OfflineRender::Wait()
+{
+	for (std::thread& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+}
+
+void OfflineRender::Abort()
+{
+	_abortFlag = true;
+	Wait();
+}
+
+bool OfflineRender::TryInitDecoder(SidDecoder& decoder, const Settings& settings)
+{
+	const PlaybackController::SyncedPlaybackConfig& config = settings.playbackConfig;
+	if (!decoder.TryInitEmulation(config.sidConfig, config.filterConfig, config.useNtscForMus, config.audioConfig.channelCount))
+	{
+		return false;
+	}
+
+	if (!settings.roms.kernal.empty() || !settings.roms.basic.empty() || !settings.roms.chargen.empty())
+	{
+		decoder.TrySetRoms(settings.roms.kernal, settings.roms.basic, settings.roms.chargen); // Missing ROMs only matter to the tunes which need them (and those fail to load then).
+	}
+
+	return true;
+}
+
+bool OfflineRender::TryRender(SidDecoder& decoder, const Job& job, const Settings& settings, const std::atomic_bool* abortFlag)
+{
+	const std::unique_ptr<BufferHolder> tuneBuffer = (job.loadTune) ? job.loadTune() : nullptr;
+	if (tuneBuffer == nullptr)
+	{
+		return false;
+	}
+
+	const BufferHolder& buffer = *tuneBuffer;
+	const bool loaded = (buffer.size[1] == 0)
+		? decoder.TryLoadSong(job.tuneFileName, buffer.buffer[0], buffer.size[0], job.subsong)
+		: decoder.TryLoadMusStrSong(job.tuneFileName, buffer.buffer[0], buffer.size[0], buffer.buffer[1], buffer.size[1]);
+
+	if (!loaded)
+	{
+		return false;
+	}
+
+	decoder.SetChannelMatrix(settings.channelMatrix.GetEffective(decoder.GetCurrentTuneSidChipsRequired()));
+
+	// Voices & filters (reminder: loading a tune doesn't reset these, so apply them in full for every job)
+	const unsigned int maxSids = static_cast<unsigned int>(decoder.GetSidVoicesEnabledStatus().size());
+	for (unsigned int sid = 0; sid < maxSids; ++sid)
+	{
+		const unsigned int maxVoices = static_cast<unsigned int>(decoder.GetSidVoicesEnabledStatus().at(sid).size());
+		for (unsigned int voice = 0; voice < maxVoices; ++voice)
+		{
+			const bool enable = sid >= settings.voicesEnabled.size() || voice >= settings.voicesEnabled.at(sid).size() || settings.voicesEnabled.at(sid).at(voice);
+			decoder.ToggleVoice(sid, voice, enable);
+		}
+
+		decoder.ToggleFilter(sid, sid >= settings.filtersEnabled.size() || settings.filtersEnabled.at(sid));
+	}
+
+	const unsigned int sampleRate = decoder.GetSidConfig().frequency;
+	const unsigned int numChannels = settings.playbackConfig.audioConfig.channelCount;
+
+	WavFileWriter writer;
+	if (!writer.TryOpen(job.outputPath, sampleRate, numChannels))
+	{
+		std::cerr << "OfflineRender: can't create " << job.outputPath << std::endl;
+		return false;
+	}
+
+	const uint64_t totalFrames = static_cast<uint64_t>(job.durationMs) * sampleRate / 1000;
+	std::vector<short> chunk(CHUNK_FRAMES * numChannels);
+
+	bool success = true;
+	for (uint64_t rendered = 0; rendered < totalFrames && success;)
+	{
+		if (abortFlag != nullptr && *abortFlag)
+		{
+			success = false;
+			break;
+		}
+
+		const unsigned long frames = static_cast<unsigned long>(std::min<uint64_t>(CHUNK_FRAMES, totalFrames - rendered));
+		success = decoder.TryFillBuffer(chunk.data(), frames) && writer.TryWrite(chunk.data(), frames);
+		rendered += frames;
+	}
+
+	success = writer.TryClose() && success;
+	if (!success)
+	{
+		std::error_code ec;
+		std::filesystem::remove(job.outputPath, ec); // Don't leave incomplete renders behind.
+	}
+
+	return success;
+}
+
+void OfflineRender::WorkerLoop()
+{
+	SidDecoder decoder; // One emulation instance per worker, reused for all of its jobs.
+	const bool initialized = TryInitDecoder(decoder, _settings);
+
+	while (!_abortFlag)
+	{
+		const size_t index = _nextJob++;
+		if (index >= _jobs.size())
+		{
+			return;
+		}
+
+		const bool success = initialized && TryRender(decoder, _jobs[index], _settings, &_abortFlag);
+
+		{
+			std::lock_guard<std::mutex> lock(_statusMutex);
+			_statuses[index] = (success) ? JobStatus::Done : JobStatus::Failed;
+		}
+
+		++_finishedCount;
+	}
+}
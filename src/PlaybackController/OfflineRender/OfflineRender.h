@@ -0,0 +1,115 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "../PlaybackController.h"
+#include "../PlaybackWrappers/Input/SidDecoder/SidDecoder.h"
+#include "../../Util/BufferHolder.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Renders tunes to WAV files faster than real time (no audio device involved). Jobs are spread across worker threads, each with its own emulation instance.
+class OfflineRender
+{
+public:
+	struct Settings
+	{
+		Settings() = delete;
+		explicit Settings(const PlaybackController::SyncedPlaybackConfig& aPlaybackConfig) :
+			playbackConfig(aPlaybackConfig)
+		{
+		}
+
+		/// @brief Takes over everything from the live playback (the user's config without the current tune's overrides, channel matrix config, voices & filters, ROMs).
+		explicit Settings(const PlaybackController& playback);
+
+		PlaybackController::SyncedPlaybackConfig playbackConfig;
+		PlaybackController::ChannelMatrixConfig channelMatrix; // Resolved per tune.
+		SidDecoder::SidVoicesEnabledStatus voicesEnabled; // Optional (empty means all enabled).
+		SidDecoder::SidFiltersEnabledStatus filtersEnabled; // Optional (empty means all enabled).
+		PlaybackController::RomPaths roms; // Optional (empty means none).
+	};
+
+	/// @brief Provides the tune's file content (for a MUS+STR pair, the STR goes into the second buffer). Called from a worker thread, right before the job is rendered.
+	using TuneLoader = std::function<std::unique_ptr<BufferHolder>()>;
+
+	struct Job
+	{
+		std::filesystem::path tuneFileName; // Needed for the MUS detection.
+		TuneLoader loadTune; // Deferred, so that the caller only lists the jobs (and only the tunes being rendered are held in memory).
+		unsigned int subsong = 0; // Zero means the default subsong.
+		uint_least32_t durationMs = 0;
+		std::filesystem::path outputPath;
+	};
+
+	enum class JobStatus
+	{
+		Pending,
+		Done,
+		Failed
+	};
+
+public:
+	OfflineRender() = delete;
+	OfflineRender(OfflineRender&) = delete;
+
+	/// @brief Starts rendering immediately. Pass zero maxWorkers to use all the cores.
+	OfflineRender(std::vector<Job>&& jobs, const Settings& settings, unsigned int maxWorkers = 0);
+	~OfflineRender();
+
+public:
+	/// @brief Renders a single job on the calling thread.
+	static bool TryRenderToWav(const Job& job, const Settings& settings, const std::atomic_bool* abortFlag = nullptr);
+
+public:
+	size_t GetJobsCount() const;
+	size_t GetFinishedCount() const;
+	JobStatus GetJobStatus(size_t jobIndex) const;
+	bool IsDone() const;
+
+	/// @brief Blocks until all the jobs are finished (or aborted).
+	void Wait();
+
+	/// @brief Stops all workers (the partially rendered files are deleted).
+	void Abort();
+
+private:
+	static bool TryInitDecoder(SidDecoder& decoder, const Settings& settings);
+	static bool TryRender(SidDecoder& decoder, const Job& job, const Settings& settings, const std::atomic_bool* abortFlag);
+
+	void WorkerLoop();
+
+private:
+	const std::vector<Job> _jobs;
+	const Settings _settings;
+
+	std::vector<JobStatus> _statuses;
+	mutable std::mutex _statusMutex;
+
+	std::atomic_size_t _nextJob = 0;
+	std::atomic_size_t _finishedCount = 0;
+	std::atomic_bool _abortFlag = false;
+	std::vector<std::thread> _workers;
+};
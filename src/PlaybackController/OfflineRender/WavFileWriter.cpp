@@ -0,0 +1,120 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "WavFileWriter.h"
+
+#include <limits>
+
+namespace
+{
+	constexpr uint32_t WAV_HEADER_SIZE = 44;
+	constexpr uint32_t RIFF_SIZE_OFFSET = 4;
+	constexpr uint32_t DATA_SIZE_OFFSET = 40;
+	constexpr uint16_t BITS_PER_SAMPLE = 16;
+
+	// WAV is little-endian regardless of the host
+	void WriteLe(std::ofstream& file, uint32_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; ++i)
+		{
+			file.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+}
+
+WavFileWriter::~WavFileWriter()
+{
+	TryClose();
+}
+
+bool WavFileWriter::TryOpen(const std::filesystem::path& filepath, unsigned int sampleRate, unsigned int numChannels)
+{
+	TryClose();
+
+	_file.open(filepath, std::ios::binary | std::ios::trunc);
+	if (!_file.good())
+	{
+		return false;
+	}
+
+	_numChannels = numChannels;
+	_dataBytes = 0;
+
+	const uint32_t blockAlign = numChannels * (BITS_PER_SAMPLE / 8);
+
+	_file.write("RIFF", 4);
+	WriteLe(_file, 0, 4); // Patched on close.
+	_file.write("WAVE", 4);
+
+	_file.write("fmt ", 4);
+	WriteLe(_file, 16, 4); // PCM format chunk size.
+	WriteLe(_file, 1, 2); // PCM.
+	WriteLe(_file, numChannels, 2);
+	WriteLe(_file, sampleRate, 4);
+	WriteLe(_file, sampleRate * blockAlign, 4);
+	WriteLe(_file, blockAlign, 2);
+	WriteLe(_file, BITS_PER_SAMPLE, 2);
+
+	_file.write("data", 4);
+	WriteLe(_file, 0, 4); // Patched on close.
+
+	return _file.good();
+}
+
+bool WavFileWriter::TryWrite(const short* samples, size_t frames)
+{
+	const size_t count = frames * _numChannels;
+
+	_scratch.resize(count * sizeof(short));
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint16_t sample = static_cast<uint16_t>(samples[i]);
+		_scratch[i * 2] = static_cast<char>(sample & 0xFF);
+		_scratch[(i * 2) + 1] = static_cast<char>(sample >> 8);
+	}
+
+	_file.write(_scratch.data(), _scratch.size());
+	_dataBytes += count * sizeof(short);
+	return _file.good();
+}
+
+bool WavFileWriter::TryClose()
+{
+	if (!_file.is_open())
+	{
+		return false;
+	}
+
+	const bool fits = _dataBytes + WAV_HEADER_SIZE - 8 <= std::numeric_limits<uint32_t>::max(); // RIFF limit (~6 hours of 48kHz stereo).
+	const uint32_t dataBytes = (fits) ? static_cast<uint32_t>(_dataBytes) : 0;
+
+	_file.seekp(RIFF_SIZE_OFFSET);
+	WriteLe(_file, dataBytes + WAV_HEADER_SIZE - 8, 4);
+	_file.seekp(DATA_SIZE_OFFSET);
+	WriteLe(_file, dataBytes, 4);
+
+	const bool success = fits && _file.good();
+	_file.close();
+
+	return success;
+}
+
+bool WavFileWriter::IsOpen() const
+{
+	return _file.is_open();
+}
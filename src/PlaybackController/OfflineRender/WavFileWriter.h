@@ -0,0 +1,49 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/// @brief Minimal streaming writer for 16-bit PCM WAV files (the header sizes are patched in on Close).
+class WavFileWriter
+{
+public:
+	WavFileWriter() = default;
+	WavFileWriter(WavFileWriter&) = delete;
+
+	~WavFileWriter();
+
+public:
+	bool TryOpen(const std::filesystem::path& filepath, unsigned int sampleRate, unsigned int numChannels);
+	bool TryWrite(const short* samples, size_t frames);
+
+	/// @brief Finalizes the header and closes the file. Returns false if anything failed along the way.
+	bool TryClose();
+
+	bool IsOpen() const;
+
+private:
+	std::ofstream _file;
+	unsigned int _numChannels = 0;
+	uint64_t _dataBytes = 0;
+	std::vector<char> _scratch; // Little-endian conversion buffer.
+};
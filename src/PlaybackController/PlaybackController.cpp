@@ -19,6 +19,7 @@
 #include "PlaybackController.h"
 #include "../Util/HelpersGeneral.h"
 #include <sidplayfp/SidTuneInfo.h>
+#include <cmath>
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
@@ -60,6 +61,8 @@ PlaybackController::State PlaybackController::StateHolder::Get() const
 
 namespace Static
 {
+    static constexpr int MIN_PRERENDER_DURATION_MS = PortAudioOutput::MIN_BUFFER_LATENCY_MS * 1000; // Min duration/latency padding to prevent short tunes (e.g., 7ms SFX and such) ending prematurely.
+
     static std::string GetSidName(const SidTuneInfo& tuneInfo, int sidNum)
     {
         switch (tuneInfo.sidModel(sidNum))
@@ -139,6 +142,7 @@ PlaybackController::SwitchAudioDeviceResult PlaybackController::TrySwitchPlaybac
 
     const bool needResetAudioOutput = (needResetSidDecoder && _preRender != nullptr) || // -> Reset the prerender (in Instant Seeking mode) when the SID decoder gets reset since it'd hold an invalid reference to it then.
                                       (newConfig.audioConfig.lowLatency != _portAudioOutput->GetAudioConfig().lowLatency) ||
+                                      (newConfig.audioConfig.decoupledRenderDepthMs != _portAudioOutput->GetAudioConfig().decoupledRenderDepthMs) ||
                                       (newConfig.audioConfig.channelCount != _portAudioOutput->GetAudioConfig().channelCount) ||
                                       (newConfig.audioConfig.preferredOutputDevice != _portAudioOutput->GetAudioConfig().preferredOutputDevice) ||
                                       (newConfig.audioConfig.sampleRate != _portAudioOutput->GetAudioConfig().sampleRate);
@@ -146,12 +150,18 @@ PlaybackController::SwitchAudioDeviceResult PlaybackController::TrySwitchPlaybac
     SwitchAudioDeviceResult result = SwitchAudioDeviceResult::OnTheFly;
     bool success = true;
 
+    if (needResetSidDecoder || needResetAudioOutput)
+    {
+        DiscardNext(); // Prepared with the old config.
+    }
+
     const bool enablePreRender = _preRender != nullptr;
 
     if (needResetSidDecoder)
     {
         Stop();
         _preRender = nullptr; // SID params changed, any pre-rendered content is no longer valid.
+        _preRenderAdjusted = false;
 
         success = TryResetSidDecoder(newConfig);
         result = (success) ? SwitchAudioDeviceResult::Stopped : SwitchAudioDeviceResult::Failure;
@@ -174,6 +184,11 @@ PlaybackController::SwitchAudioDeviceResult PlaybackController::TrySwitchPlaybac
     return result;
 }
 
+void PlaybackController::SetPreRenderDiskCache(const std::filesystem::path& folder, uint64_t capBytes)
+{
+    _preRenderDiskCache.SetLocation(folder, capBytes);
+}
+
 RomUtil::RomStatus PlaybackController::TrySetRoms(const std::filesystem::path& pathKernal, const std::filesystem::path& pathBasic, const std::filesystem::path& pathChargen)
 {
     const RomUtil::RomStatus& preCheckStatus = RomUtil::PreCheckRoms(pathKernal, pathBasic, pathChargen);
@@ -182,7 +197,17 @@ RomUtil::RomStatus PlaybackController::TrySetRoms(const std::filesystem::path& p
         return preCheckStatus;
     }
 
+    DiscardNext(); // Prepared with the old ROMs.
     _loadedRoms = _sidDecoder->TrySetRoms(pathKernal, pathBasic, pathChargen);
+    _romPaths = {pathKernal, pathBasic, pathChargen};
+
+    PreRenderDiskCache::KeyBuilder romsDigest("roms");
+    for (const RomUtil::RomType type : {RomUtil::RomType::Kernal, RomUtil::RomType::Basic, RomUtil::RomType::Chargen})
+    {
+        romsDigest.Add(_sidDecoder->GetRomImage(type));
+    }
+
+    _romsDigest = romsDigest.Build();
     return _loadedRoms;
 }
 
@@ -193,9 +218,7 @@ PlaybackController::PlaybackAttemptStatus PlaybackController::TryPlayFromBuffer(
     _activeTuneHolder = std::make_unique<TuneHolder>(filepathForUid, loadedBufferToAdopt);
     // Reminder: loadedBufferToAdopt var is now invalid
 
-    const bool successInput = (_activeTuneHolder->bufferHolder->size[1] == 0)
-        ? _sidDecoder->TryLoadSong(_activeTuneHolder->filepath.filename(), _activeTuneHolder->bufferHolder->buffer[0], _activeTuneHolder->bufferHolder->size[0], subsong)
-        : _sidDecoder->TryLoadMusStrSong(filepathForUid.filename(), _activeTuneHolder->bufferHolder->buffer[0], _activeTuneHolder->bufferHolder->size[0], _activeTuneHolder->bufferHolder->buffer[1], _activeTuneHolder->bufferHolder->size[1]);
+    const bool successInput = TryLoadTune(*_sidDecoder, *_activeTuneHolder, subsong);
 
     const bool successOutput = FinalizeTryPlay(successInput, preRenderDurationMs);
 
@@ -227,6 +250,105 @@ bool PlaybackController::TryPlaySubsong(unsigned int subsong, int preRenderDurat
     return false;
 }
 
+bool PlaybackController::TryPrepareNext(const std::filesystem::path& filepathForUid, std::unique_ptr<BufferHolder>& loadedBufferToAdopt, unsigned int subsong, int preRenderDurationMs)
+{
+    DiscardNext();
+
+    if (_state == State::Undefined)
+    {
+        return false;
+    }
+
+    std::unique_ptr<NextTune> next = std::make_unique<NextTune>();
+    next->tuneHolder = std::make_unique<TuneHolder>(filepathForUid, loadedBufferToAdopt);
+    // Reminder: loadedBufferToAdopt var is now invalid
+    next->subsong = subsong;
+    next->preRenderDurationMs = preRenderDurationMs;
+
+    next->sidDecoder = TryCreateTwinDecoder(*next->tuneHolder, subsong);
+    if (next->sidDecoder == nullptr)
+    {
+        return false;
+    }
+
+    if (preRenderDurationMs > 0)
+    {
+        next->preRender = std::make_unique<PreRender>();
+        StartPreRender(*next->preRender, *next->sidDecoder, preRenderDurationMs, nullptr); // No live twin needed, it has a head start.
+    }
+
+    _nextTune = std::move(next);
+    return true;
+}
+
+bool PlaybackController::IsNextPrepared(const std::filesystem::path& filepathForUid, unsigned int subsong, int preRenderDurationMs) const
+{
+    return _nextTune != nullptr &&
+           _nextTune->tuneHolder->filepath == filepathForUid &&
+           _nextTune->subsong == subsong &&
+           _nextTune->preRenderDurationMs == preRenderDurationMs;
+}
+
+PlaybackController::PlaybackAttemptStatus PlaybackController::TryPlayNext()
+{
+    if (_nextTune == nullptr || _state == State::Undefined)
+    {
+        return PlaybackAttemptStatus::InputError;
+    }
+
+    PrepareTryPlay();
+
+    std::unique_ptr<NextTune> next = std::move(_nextTune);
+
+    // Carry over the realtime adjustments made since the preparation (unless pre-rendering, which has its own thread using the decoder by now)
+    if (next->preRender == nullptr)
+    {
+        CopyRealtimeAdjustments(*_sidDecoder, *next->sidDecoder);
+    }
+
+    // Swap in (the old pre-render references the old decoder, so it must go first)
+    _preRender = std::move(next->preRender);
+    _preRenderAdjusted = false;
+    _sidDecoder = std::move(next->sidDecoder);
+    _activeTuneHolder = std::move(next->tuneHolder);
+
+    if (_preRender != nullptr)
+    {
+        _decoupledRender = nullptr; // The pre-render is already decoupled on its own.
+    }
+    else if (_decoupledRender == nullptr && GetAudioConfig().decoupledRenderDepthMs > 0)
+    {
+        _decoupledRender = std::make_unique<DecoupledRender>();
+    }
+
+    bool success = TryBindAudioOutput(GetAudioConfig());
+    if (success)
+    {
+        StartDecoupledRender();
+        success = _portAudioOutput->TryStartStream();
+    }
+
+    if (!success)
+    {
+        if (_preRender != nullptr)
+        {
+            _preRender->Stop();
+        }
+
+        StopDecoupledRender();
+
+        _activeTuneHolder = nullptr;
+    }
+
+    _state = (success) ? State::Playing : State::Stopped;
+    return (success) ? PlaybackAttemptStatus::Success : PlaybackAttemptStatus::OutputError;
+}
+
+void PlaybackController::DiscardNext()
+{
+    _nextTune = nullptr;
+}
+
 void PlaybackController::Pause()
 {
     if (_state == State::Playing)
@@ -251,6 +373,7 @@ void PlaybackController::Resume()
 #ifdef __WXGTK__
         _portAudioOutput->ResetStream(_portAudioOutput->GetAudioConfig().sampleRate * _playbackSpeedFactor); // Needed for stability on Linux.
 #endif
+        StartDecoupledRender(); // No-op if already running (e.g., restarts it after a seek).
         _portAudioOutput->TryStartStream();
         _state = State::Playing;
     }
@@ -294,13 +417,15 @@ void PlaybackController::Stop()
             {
                 _preRender->Stop();
             }
+
+            StopDecoupledRender();
         }
 
         _state = State::Stopped;
     }
 }
 
-void PlaybackController::SeekTo(uint_least32_t targetTimeMs)
+void PlaybackController::SeekTo(uint_least32_t targetTimeMs, uint_least32_t songDurationMs)
 {
     if (_state == State::Stopped || _state == State::Undefined)
     {
@@ -325,9 +450,11 @@ void PlaybackController::SeekTo(uint_least32_t targetTimeMs)
     _seekOperation.safeCtimeMs = 0;
     _seekOperation.safeTargetTimeMs = targetTimeMs;
 
+    StopDecoupledRender(); // The seek thread takes over the SID decoder (and whatever was rendered ahead is obsolete anyway).
+
     // Start seeking in a new thread
     _state = State::Seeking;
-    _seekOperation.seekThread = std::thread([this, targetTimeMs]
+    _seekOperation.seekThread = std::thread([this, targetTimeMs, songDurationMs]
     {
         if (_preRender != nullptr) // Instant seeking mode
         {
@@ -341,7 +468,7 @@ void PlaybackController::SeekTo(uint_least32_t targetTimeMs)
             _sidDecoder->SeekTo(targetTimeMs, [this](uint_least32_t cTimeMs, bool done) -> bool
             {
                 return OnSeekStatusReceived(cTimeMs, done);
-            });
+            }, songDurationMs);
         }
     });
 }
@@ -351,6 +478,11 @@ void PlaybackController::AbortSeek()
     if (_state == State::Seeking)
     {
         _seekOperation.abortFlag = true;
+        if (_preRender != nullptr)
+        {
+            _preRender->InterruptSeek(); // Otherwise it'd only notice the abort once the render thread progresses.
+        }
+
         _seekOperation.seekThread.join();
     }
     else
@@ -387,7 +519,8 @@ uint_least32_t PlaybackController::GetTime() const
         return std::max(0, _preRender->GetCurrentSongTimeMs() - currentLatencyMs);
     }
 
-    return std::max(0, static_cast<int>(_sidDecoder->GetTime()) - currentLatencyMs);
+    const int renderedAheadMs = (_decoupledRender == nullptr) ? 0 : static_cast<int>(_decoupledRender->GetBufferedFrames() * 1000 / _sidDecoder->GetSidConfig().frequency);
+    return std::max(0, static_cast<int>(_sidDecoder->GetTime()) - renderedAheadMs - currentLatencyMs);
 }
 
 double PlaybackController::GetPreRenderProgressFactor() const
@@ -623,6 +756,16 @@ PortAudioOutput::AudioConfig PlaybackController::GetAudioConfig() const
     return _portAudioOutput->GetAudioConfig();
 }
 
+PlaybackController::SyncedPlaybackConfig PlaybackController::GetSyncedPlaybackConfig() const
+{
+    return SyncedPlaybackConfig(GetAudioConfig(), _sidDecoder->GetInitSidConfig(), _sidDecoder->GetFilterConfig(), _sidDecoder->WillUseNtscForMus());
+}
+
+const PlaybackController::RomPaths& PlaybackController::GetRomPaths() const
+{
+    return _romPaths;
+}
+
 int PlaybackController::GetCurrentTuneSize(bool bulkSize) const
 {
     const SidTuneInfo& tuneInfo = _sidDecoder->GetCurrentSongInfo();
@@ -639,9 +782,43 @@ void PlaybackController::SetVolume(float volume)
     _portAudioOutput->SetVolume(volume);
 }
 
-void PlaybackController::SetChannelMatrix(const MultiSidChannelMatrix& matrix)
+void PlaybackController::SetChannelMatrix(const ChannelMatrixConfig& config)
 {
-    _sidDecoder->SetChannelMatrix(matrix);
+    _channelMatrixConfig = config;
+    if (ApplyChannelMatrix(*_sidDecoder))
+    {
+        OnPreRenderAdjusted();
+    }
+
+    SidDecoder* liveTwin = GetLiveTwinDecoder();
+    if (liveTwin != nullptr)
+    {
+        ApplyChannelMatrix(*liveTwin);
+    }
+
+    if (_nextTune != nullptr)
+    {
+        SidDecoder& nextDecoder = *_nextTune->sidDecoder;
+        const bool changed = _channelMatrixConfig.GetEffective(nextDecoder.GetCurrentTuneSidChipsRequired()) != nextDecoder.GetChannelMatrix();
+        if (changed && _nextTune->preRender != nullptr)
+        {
+            DiscardNext(); // Already (partially) rendered with the old matrix.
+        }
+        else
+        {
+            ApplyChannelMatrix(nextDecoder);
+        }
+    }
+}
+
+const PlaybackController::ChannelMatrixConfig& PlaybackController::GetChannelMatrixConfig() const
+{
+    return _channelMatrixConfig;
+}
+
+const MultiSidChannelMatrix& PlaybackController::GetChannelMatrix() const
+{
+    return _sidDecoder->GetChannelMatrix();
 }
 
 bool PlaybackController::ToggleVoice(unsigned int sidNum, unsigned int voice, bool enable)
@@ -651,6 +828,14 @@ bool PlaybackController::ToggleVoice(unsigned int sidNum, unsigned int voice, bo
         if (sidNum + 1 <= GetCurrentTuneSidChipsRequired())
         {
             _sidDecoder->ToggleVoice(sidNum, voice, enable);
+            OnPreRenderAdjusted();
+
+            SidDecoder* liveTwin = GetLiveTwinDecoder();
+            if (liveTwin != nullptr)
+            {
+                liveTwin->ToggleVoice(sidNum, voice, enable);
+            }
+
             EmitSignal(SignalsPlaybackController::SIGNAL_VOICE_TOGGLED);
             return true;
         }
@@ -666,6 +851,14 @@ bool PlaybackController::ToggleFilter(unsigned int sidNum, bool enable)
         if (sidNum + 1 <= GetCurrentTuneSidChipsRequired())
         {
             _sidDecoder->ToggleFilter(sidNum, enable);
+            OnPreRenderAdjusted();
+
+            SidDecoder* liveTwin = GetLiveTwinDecoder();
+            if (liveTwin != nullptr)
+            {
+                liveTwin->ToggleFilter(sidNum, enable);
+            }
+
             EmitSignal(SignalsPlaybackController::SIGNAL_VOICE_TOGGLED);
             return true;
         }
@@ -729,6 +922,8 @@ bool PlaybackController::TryResetSidDecoder(const SyncedPlaybackConfig& newConfi
     }
 
     _preRender = nullptr; // Some SID params changed, any pre-rendered content is no longer valid.
+    _preRenderAdjusted = false;
+    StopDecoupledRender();
 
     const bool success = _sidDecoder->TryInitEmulation(newConfig.sidConfig, newConfig.filterConfig, newConfig.useNtscForMus, newConfig.audioConfig.channelCount);
     if (success)
@@ -760,11 +955,196 @@ bool PlaybackController::TryResetAudioOutput(const PortAudioOutput::AudioConfig&
     }
 
     _preRender = (enablePreRender) ? std::make_unique<PreRender>() : nullptr; // Enable the pre-render output if desired, otherwise destroy the old instance.
+    _preRenderAdjusted = false;
+    _decoupledRender = (!enablePreRender && audioConfig.decoupledRenderDepthMs > 0) ? std::make_unique<DecoupledRender>() : nullptr; // The pre-render is already decoupled on its own.
+
+    return TryBindAudioOutput(audioConfig);
+}
+
+bool PlaybackController::TryBindAudioOutput(const PortAudioOutput::AudioConfig& audioConfig)
+{
+    // Use either the pre-render, the decoupled realtime or the (synchronous) realtime audio output
+    IBufferWriter* decoder = _sidDecoder.get();
+    if (_preRender != nullptr)
+    {
+        decoder = _preRender.get();
+    }
+    else if (_decoupledRender != nullptr)
+    {
+        decoder = _decoupledRender.get();
+    }
 
-    IBufferWriter* decoder = (_preRender == nullptr) ? _sidDecoder.get() : static_cast<IBufferWriter*>(_preRender.get()); // Use either the pre-render or the realtime audio output.
     return _portAudioOutput != nullptr && _portAudioOutput->TryInit(audioConfig, decoder, _playbackSpeedFactor);
 }
 
+void PlaybackController::StartPreRender(PreRender& preRender, SidDecoder& sidDecoder, int durationMs, const TuneHolder* liveTwinTune)
+{
+    const int sampleRate = static_cast<int>(sidDecoder.GetSidConfig().frequency);
+    const int channelCount = GetAudioConfig().channelCount;
+    durationMs = std::max(Static::MIN_PRERENDER_DURATION_MS, durationMs);
+
+    const size_t frames = PreRender::CalcFrames(sampleRate, durationMs);
+    const std::string cacheKey = (_preRenderDiskCache.IsEnabled()) ? CalcPreRenderCacheKey(sidDecoder, frames) : "";
+
+    if (!cacheKey.empty())
+    {
+        std::unique_ptr<PreRenderDiskCache::Player> cached = _preRenderDiskCache.TryOpen(cacheKey, frames, channelCount);
+        if (cached != nullptr)
+        {
+            preRender.DoPreRender(std::move(cached), sampleRate, channelCount, durationMs); // Decoding is way faster than the emulation, so no live twin either.
+            return;
+        }
+    }
+
+    // The live twin covers the start of the playback until the render thread gets ahead of it (without it, that'd be silence on slow machines or with heavy multi-SID tunes)
+    std::unique_ptr<SidDecoder> liveDecoder = (liveTwinTune == nullptr) ? nullptr : TryCreateTwinDecoder(*liveTwinTune, sidDecoder.GetCurrentSubsong());
+    if (liveDecoder != nullptr && liveDecoder->GetCurrentSubsong() != sidDecoder.GetCurrentSubsong())
+    {
+        liveDecoder = nullptr; // Not a true twin (shouldn't happen), the timelines wouldn't match.
+    }
+
+    std::unique_ptr<PreRenderDiskCache::Recorder> recorder = (cacheKey.empty()) ? nullptr : _preRenderDiskCache.CreateRecorder(cacheKey, sidDecoder, frames, channelCount);
+    if (recorder != nullptr)
+    {
+        preRender.DoPreRender(std::move(recorder), sampleRate, channelCount, durationMs, std::move(liveDecoder));
+    }
+    else
+    {
+        preRender.DoPreRender(sidDecoder, sampleRate, channelCount, durationMs, std::move(liveDecoder));
+    }
+}
+
+std::string PlaybackController::CalcPreRenderCacheKey(const SidDecoder& sidDecoder, size_t frames) const
+{
+    const char* const md5 = sidDecoder.CalcCurrentTuneMd5();
+    if (md5 == nullptr || *md5 == '\0')
+    {
+        return "";
+    }
+
+    PreRenderDiskCache::KeyBuilder key(md5);
+    key.Add(sidDecoder.GetCurrentSubsong()).Add(frames).Add(GetAudioConfig().channelCount);
+
+    const SidConfig& sidConfig = sidDecoder.GetSidConfig(); // Effective one (i.e., incl. the MUS NTSC override).
+    key.Add(sidConfig.frequency).Add(sidConfig.defaultC64Model).Add(sidConfig.forceC64Model).Add(sidConfig.defaultSidModel).Add(sidConfig.forceSidModel);
+    key.Add(sidConfig.digiBoost).Add(sidConfig.powerOnDelay);
+
+    const SidDecoder::FilterConfig& filterConfig = sidDecoder.GetFilterConfig();
+    key.Add(filterConfig.filter6581Curve).Add(filterConfig.filter6581Range).Add(filterConfig.filter8580Curve).Add(filterConfig.enableOld6581caps);
+
+    const MultiSidChannelMatrix& matrix = sidDecoder.GetChannelMatrix();
+    for (const MultiSidChannelMatrix::ChannelVolume& volume : {matrix.tune2Sid_First, matrix.tune2Sid_Second, matrix.tune3Sid_First, matrix.tune3Sid_Second, matrix.tune3Sid_Third})
+    {
+        key.Add(volume.left).Add(volume.right);
+    }
+
+    for (const std::vector<bool>& voices : sidDecoder.GetSidVoicesEnabledStatus())
+    {
+        for (const bool enabled : voices)
+        {
+            key.Add(enabled);
+        }
+    }
+
+    for (const bool enabled : sidDecoder.GetSidFiltersEnabledStatus())
+    {
+        key.Add(enabled);
+    }
+
+    // Some tunes use the ROM code (hashed by the content, the paths alone wouldn't notice a replaced ROM file)
+    key.Add(std::string_view(_romsDigest));
+
+    return key.Build();
+}
+
+std::unique_ptr<SidDecoder> PlaybackController::TryCreateTwinDecoder(const TuneHolder& tuneHolder, unsigned int subsong) const
+{
+    // Same config, ROMs and realtime adjustments as the current decoder
+    std::unique_ptr<SidDecoder> twin = std::make_unique<SidDecoder>();
+    if (!twin->TryInitEmulation(_sidDecoder->GetInitSidConfig(), _sidDecoder->GetFilterConfig(), _sidDecoder->WillUseNtscForMus(), GetAudioConfig().channelCount))
+    {
+        return nullptr;
+    }
+
+    twin->SetRoms(*_sidDecoder); // The same images (no disk access).
+
+    if (!TryLoadTune(*twin, tuneHolder, subsong))
+    {
+        return nullptr;
+    }
+
+    CopyRealtimeAdjustments(*_sidDecoder, *twin);
+    ApplyChannelMatrix(*twin); // Its own tune's matrix (which may be a different one, e.g., a next tune with a different SID count).
+    return twin;
+}
+
+bool PlaybackController::TryLoadTune(SidDecoder& sidDecoder, const TuneHolder& tuneHolder, unsigned int subsong)
+{
+    const BufferHolder& bufferHolder = *tuneHolder.bufferHolder;
+    return (bufferHolder.size[1] == 0)
+        ? sidDecoder.TryLoadSong(tuneHolder.filepath.filename(), bufferHolder.buffer[0], bufferHolder.size[0], subsong)
+        : sidDecoder.TryLoadMusStrSong(tuneHolder.filepath.filename(), bufferHolder.buffer[0], bufferHolder.size[0], bufferHolder.buffer[1], bufferHolder.size[1]);
+}
+
+void PlaybackController::CopyRealtimeAdjustments(const SidDecoder& from, SidDecoder& to)
+{
+    const SidDecoder::SidVoicesEnabledStatus& voices = from.GetSidVoicesEnabledStatus();
+    for (unsigned int sidNum = 0; sidNum < voices.size(); ++sidNum)
+    {
+        for (unsigned int voice = 0; voice < voices[sidNum].size(); ++voice)
+        {
+            to.ToggleVoice(sidNum, voice, voices[sidNum][voice]);
+        }
+
+        to.ToggleFilter(sidNum, from.GetSidFiltersEnabledStatus().at(sidNum));
+    }
+}
+
+bool PlaybackController::ApplyChannelMatrix(SidDecoder& sidDecoder) const
+{
+    const MultiSidChannelMatrix& effective = _channelMatrixConfig.GetEffective(sidDecoder.GetCurrentTuneSidChipsRequired());
+    if (effective == sidDecoder.GetChannelMatrix())
+    {
+        return false;
+    }
+
+    sidDecoder.SetChannelMatrix(effective);
+    return true;
+}
+
+SidDecoder* PlaybackController::GetLiveTwinDecoder() const
+{
+    return (_preRender == nullptr) ? nullptr : static_cast<SidDecoder*>(_preRender->GetLiveRenderer()); // The StartPreRender only ever uses a twin decoder as the live renderer.
+}
+
+void PlaybackController::OnPreRenderAdjusted()
+{
+    if (_preRender != nullptr)
+    {
+        _preRenderDiskCache.DiscardPendingRecordings();
+        _preRenderAdjusted = true;
+    }
+}
+
+void PlaybackController::StartDecoupledRender()
+{
+    if (_decoupledRender != nullptr && !_decoupledRender->IsRunning())
+    {
+        const unsigned int frequency = _sidDecoder->GetSidConfig().frequency;
+        const size_t depthFrames = static_cast<size_t>(GetAudioConfig().decoupledRenderDepthMs) * frequency / 1000;
+        const size_t callbackFrames = static_cast<size_t>(std::ceil(GetAudioConfig().suggestedLatency * frequency)); // The stream's buffer size is unspecified (auto), its latency is the best estimate.
+        _decoupledRender->Start(*_sidDecoder.get(), GetAudioConfig().channelCount, depthFrames, callbackFrames);
+    }
+}
+
+void PlaybackController::StopDecoupledRender()
+{
+    if (_decoupledRender != nullptr)
+    {
+        _decoupledRender->Stop();
+    }
+}
+
 void PlaybackController::PrepareTryPlay()
 {
     if (_state == State::Seeking)
@@ -784,6 +1164,8 @@ void PlaybackController::PrepareTryPlay()
             _preRender->Stop();
         }
     }
+
+    StopDecoupledRender(); // Always, since the SID decoder is about to be reconfigured.
 }
 
 bool PlaybackController::FinalizeTryPlay(bool isSuccessful, int preRenderDurationMs, bool reusePreRender)
@@ -801,10 +1183,12 @@ bool PlaybackController::FinalizeTryPlay(bool isSuccessful, int preRenderDuratio
                 _portAudioOutput->ResetStream(GetAudioConfig().sampleRate * _playbackSpeedFactor);
             }
 
-            if (!reusePreRender || _preRender->GetPreRenderProgressFactor() != 1.0)
+            // The final matrix must be in place before the render starts (the disk cache key depends on it too)
+            const bool matrixChanged = ApplyChannelMatrix(*_sidDecoder);
+            if (!reusePreRender || matrixChanged || _preRenderAdjusted || !_preRender->CanReplayFromStart())
             {
-                static constexpr int MIN_BUFFER_DURATION = PortAudioOutput::MIN_BUFFER_LATENCY_MS * 1000; // Min duration/latency padding to prevent short tunes (e.g., 7ms SFX and such) ending prematurely.
-                _preRender->DoPreRender(*_sidDecoder.get(), _sidDecoder->GetSidConfig().frequency, GetAudioConfig().channelCount, std::max(MIN_BUFFER_DURATION, preRenderDurationMs));
+                StartPreRender(*_preRender, *_sidDecoder, preRenderDurationMs, _activeTuneHolder.get());
+                _preRenderAdjusted = false;
             }
         }
         else
@@ -817,6 +1201,8 @@ bool PlaybackController::FinalizeTryPlay(bool isSuccessful, int preRenderDuratio
             {
                 _portAudioOutput->ResetStream(GetAudioConfig().sampleRate * _playbackSpeedFactor);
             }
+
+            StartDecoupledRender();
         }
 
         isSuccessful = _portAudioOutput->TryStartStream();
@@ -828,6 +1214,8 @@ bool PlaybackController::FinalizeTryPlay(bool isSuccessful, int preRenderDuratio
                 _preRender->Stop();
             }
 
+            StopDecoupledRender();
+
             _activeTuneHolder = nullptr;
         }
     }
@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include "DecoupledRender.h"
 #include "PreRender.h"
+#include "PreRenderDiskCache.h"
 #include "PlaybackWrappers/Output/PortAudioOutput.h"
 #include "PlaybackWrappers/Input/SidDecoder/SidDecoder.h"
 #include "PlaybackWrappers/Input/SidDecoder/MultiSidChannelMatrix.h"
@@ -88,6 +90,25 @@ public:
         bool useNtscForMus;
     };
 
+    struct RomPaths
+    {
+        std::filesystem::path kernal;
+        std::filesystem::path basic;
+        std::filesystem::path chargen;
+    };
+
+    struct ChannelMatrixConfig
+    {
+        MultiSidChannelMatrix matrix;
+        bool flattenMultiSid = false; // The multi-SID tunes get the default (flat) matrix instead (e.g., for the virtual stereo).
+
+        /// @brief Gets the matrix for a tune requiring this many SIDs.
+        MultiSidChannelMatrix GetEffective(int sidChipsRequired) const
+        {
+            return (flattenMultiSid && sidChipsRequired > 1) ? MultiSidChannelMatrix() : matrix;
+        }
+    };
+
 private:
     class StateHolder
     {
@@ -130,6 +151,15 @@ private:
         const std::unique_ptr<const BufferHolder> bufferHolder;
     };
 
+    struct NextTune
+    {
+        std::unique_ptr<TuneHolder> tuneHolder;
+        std::unique_ptr<SidDecoder> sidDecoder;
+        std::unique_ptr<PreRender> preRender; // Declared after the decoder so it gets destroyed first (it references the decoder).
+        unsigned int subsong = 0;
+        int preRenderDurationMs = 0;
+    };
+
 public:
     PlaybackController();
     PlaybackController(PlaybackController&) = delete;
@@ -140,6 +170,9 @@ public:
     bool TryInit(const SyncedPlaybackConfig& config);
     SwitchAudioDeviceResult TrySwitchPlaybackConfiguration(const SyncedPlaybackConfig& newConfig);
 
+    /// @brief Sets the folder and the size cap (0 = disabled) of the persistent cache of the complete pre-renders.
+    void SetPreRenderDiskCache(const std::filesystem::path& folder, uint64_t capBytes);
+
     // Paths should be absolute.
     RomUtil::RomStatus TrySetRoms(const std::filesystem::path& pathKernal, const std::filesystem::path& pathBasic, const std::filesystem::path& pathChargen);
 
@@ -148,11 +181,23 @@ public:
     bool TryReplayCurrentSong(int preRenderDurationMs, bool reusePreRender = false);
     bool TryPlaySubsong(unsigned int subsong, int preRenderDurationMs, bool reusePreRender = false);
 
+    /// @brief Loads the tune on a standby SID decoder (and pre-renders it if preRenderDurationMs > 0) while the current one keeps playing, so that the TryPlayNext() can switch to it immediately. Replaces any previously prepared tune.
+    bool TryPrepareNext(const std::filesystem::path& filepathForUid, std::unique_ptr<BufferHolder>& loadedBufferToAdopt, unsigned int subsong, int preRenderDurationMs);
+
+    /// @brief Returns true if the TryPrepareNext() was called with these same parameters (and not discarded since).
+    bool IsNextPrepared(const std::filesystem::path& filepathForUid, unsigned int subsong, int preRenderDurationMs) const;
+
+    /// @brief Swaps in the prepared tune and starts playing it.
+    PlaybackAttemptStatus TryPlayNext();
+
+    void DiscardNext();
+
     void Pause();
     void Resume();
     void Stop();
 
-    void SeekTo(uint_least32_t targetTimeMs);
+    /// @brief The songDurationMs (zero if unknown) only helps the regular mode's seek acceleration.
+    void SeekTo(uint_least32_t targetTimeMs, uint_least32_t songDurationMs = 0);
     void AbortSeek();
 
     // Gets the target time milliseconds parameter of the last SeekTo() call or zero.
@@ -194,13 +239,24 @@ public:
     SidConfig GetSidConfig() const;
     PortAudioOutput::AudioConfig GetAudioConfig() const;
 
+    /// @brief Gets the user's configuration without the current tune's overrides (e.g., the MUS NTSC one), to set up other decoders the same way (e.g., to render offline).
+    SyncedPlaybackConfig GetSyncedPlaybackConfig() const;
+
+    /// @brief Gets the paths of the ROMs passed to the last TrySetRoms() call.
+    const RomPaths& GetRomPaths() const;
+
     // Returns Length of raw C64 data without load address. If bulkSize is true, Returns Length of single-file sidtune file.
     int GetCurrentTuneSize(bool bulkSize = false) const;
 
     float GetVolume() const;
     void SetVolume(float volume);
 
-    void SetChannelMatrix(const MultiSidChannelMatrix& matrix);
+    /// @brief Each tune gets the matrix effective for its SID count (the current tune right away, the prepared next one as well).
+    void SetChannelMatrix(const ChannelMatrixConfig& config);
+    const ChannelMatrixConfig& GetChannelMatrixConfig() const;
+
+    /// @brief Gets the matrix effective for the current tune.
+    const MultiSidChannelMatrix& GetChannelMatrix() const;
 
     bool ToggleVoice(unsigned int sidNum, unsigned int voice, bool enable);
     bool ToggleFilter(unsigned int sidNum, bool enable);
@@ -222,6 +278,34 @@ public:
 private:
     bool TryResetSidDecoder(const SyncedPlaybackConfig& newConfig);
     bool TryResetAudioOutput(const PortAudioOutput::AudioConfig& audioConfig, bool enablePreRender);
+    bool TryBindAudioOutput(const PortAudioOutput::AudioConfig& audioConfig);
+
+    static bool TryLoadTune(SidDecoder& sidDecoder, const TuneHolder& tuneHolder, unsigned int subsong);
+
+    /// @brief Starts pre-rendering the decoder's loaded tune: served from the disk cache if it's there, otherwise emulated (and recorded into the cache).
+    /// If the liveTwinTune is given, a live twin decoder covers the start of the playback while the emulation is behind.
+    void StartPreRender(PreRender& preRender, SidDecoder& sidDecoder, int durationMs, const TuneHolder* liveTwinTune);
+
+    /// @brief Covers everything the rendered audio depends on (the volume, playback speed and virtual stereo are applied on the output side). Returns an empty string if the tune has no MD5.
+    std::string CalcPreRenderCacheKey(const SidDecoder& sidDecoder, size_t frames) const;
+
+    /// @brief Creates a fresh decoder with the same config, ROMs and realtime adjustments as the current one, with the tune loaded. Returns nullptr on failure.
+    std::unique_ptr<SidDecoder> TryCreateTwinDecoder(const TuneHolder& tuneHolder, unsigned int subsong) const;
+
+    /// @brief Copies the voices' & filters' enabled status (the channel matrix depends on the tune, see the ApplyChannelMatrix).
+    static void CopyRealtimeAdjustments(const SidDecoder& from, SidDecoder& to);
+
+    /// @brief Applies the channel matrix effective for the decoder's loaded tune. Returns true if that changed the decoder's matrix.
+    bool ApplyChannelMatrix(SidDecoder& sidDecoder) const;
+
+    /// @brief Returns the current pre-render's live twin (if any), which needs the same realtime adjustments as the current decoder.
+    SidDecoder* GetLiveTwinDecoder() const;
+
+    /// @brief Call after a realtime adjustment of the current decoder: the pre-render no longer matches its cache key (nor can it be replayed as is).
+    void OnPreRenderAdjusted();
+
+    void StartDecoupledRender();
+    void StopDecoupledRender();
 
     void PrepareTryPlay();
     bool FinalizeTryPlay(bool isSuccessful, int preRenderDurationMs, bool reusePreRender = false);
@@ -237,7 +321,10 @@ private:
     std::unique_ptr<TuneHolder> _activeTuneHolder;
     std::unique_ptr<SidDecoder> _sidDecoder;
     std::unique_ptr<PortAudioOutput> _portAudioOutput;
+    PreRenderDiskCache _preRenderDiskCache; // Declared before the pre-renders, as their recorders reference it.
     std::unique_ptr<PreRender> _preRender;
+    std::unique_ptr<DecoupledRender> _decoupledRender; // Only used in the regular (non pre-render) mode if enabled.
+    std::unique_ptr<NextTune> _nextTune;
 
     StateHolder _state;
     SeekOperation _seekOperation{};
@@ -245,6 +332,10 @@ private:
     double _playbackSpeedFactor = 1.0;
 
     RomUtil::RomStatus _loadedRoms{};
+    RomPaths _romPaths;
+    std::string _romsDigest; // Of the loaded ROM images, for the pre-render cache key (a ROM file may get replaced at the same path).
+    ChannelMatrixConfig _channelMatrixConfig;
+    bool _preRenderAdjusted = false; // The current pre-render got realtime adjustments mid-render.
 
 private:
     struct SeekProcessStatus
@@ -26,5 +26,7 @@ public:
     using SeekStatusCallback = std::function<bool(int, bool)>;
 
 public:
+    virtual ~IBufferWriter() = default;
+
     virtual bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) = 0;
 };
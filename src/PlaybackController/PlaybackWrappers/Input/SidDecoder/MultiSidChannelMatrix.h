@@ -24,6 +24,11 @@ struct MultiSidChannelMatrix
 	{
 		float left = 1.0f;
 		float right = 1.0f;
+
+		bool operator==(const ChannelVolume& other) const
+		{
+			return left == other.left && right == other.right;
+		}
 	};
 
 	ChannelVolume tune2Sid_First;
@@ -32,4 +37,15 @@ struct MultiSidChannelMatrix
 	ChannelVolume tune3Sid_First;
 	ChannelVolume tune3Sid_Second;
 	ChannelVolume tune3Sid_Third;
+
+	bool operator==(const MultiSidChannelMatrix& other) const
+	{
+		return tune2Sid_First == other.tune2Sid_First && tune2Sid_Second == other.tune2Sid_Second &&
+			   tune3Sid_First == other.tune3Sid_First && tune3Sid_Second == other.tune3Sid_Second && tune3Sid_Third == other.tune3Sid_Third;
+	}
+
+	bool operator!=(const MultiSidChannelMatrix& other) const
+	{
+		return !(*this == other);
+	}
 };
@@ -0,0 +1,165 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "SeekKeyframes.h"
+
+#include <algorithm>
+
+SeekKeyframes::~SeekKeyframes()
+{
+	Clear();
+}
+
+void SeekKeyframes::Build(const EngineFactory& factory, unsigned int fastForwardCycles, uint_least32_t songDurationMs)
+{
+	if (_started)
+	{
+		return;
+	}
+
+	_started = true;
+	_abort = false;
+	_nextToBuild = 0;
+
+	// Every keyframe gets fast-forwarded from the start, so spread them over the song (a short one gets fewer and denser ones, nothing is built past its end)
+	uint_least32_t spacingMs = SPACING_MS;
+	size_t count = MAX_KEYFRAMES;
+	if (songDurationMs > 0)
+	{
+		spacingMs = std::max(MIN_SPACING_MS, songDurationMs / static_cast<uint_least32_t>(MAX_KEYFRAMES + 1));
+		count = std::min(MAX_KEYFRAMES, static_cast<size_t>((songDurationMs - 1) / spacingMs));
+	}
+
+	_keyframes = std::vector<Keyframe>(count);
+	for (size_t i = 0; i < _keyframes.size(); ++i)
+	{
+		_keyframes[i].timeMs = static_cast<uint_least32_t>(i + 1) * spacingMs;
+	}
+
+	const unsigned int numWorkers = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_WORKERS); // Leave room for the playback itself.
+	for (unsigned int i = 0; i < numWorkers; ++i)
+	{
+		_workers.emplace_back(&SeekKeyframes::WorkerLoop, this, factory, fastForwardCycles);
+	}
+}
+
+void SeekKeyframes::Clear()
+{
+	_abort = true;
+	for (std::thread& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+	_workers.clear();
+	_keyframes.clear(); // Reminder: the engines reference the tune, so this must happen before the tune gets destroyed.
+	_captured.clear();
+	_started = false;
+}
+
+bool SeekKeyframes::TrySwapNearest(uint_least32_t targetMs, uint_least32_t currentMs, std::unique_ptr<ReSIDfpBuilder>& builder, std::unique_ptr<sidplayfp>& player)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	Keyframe* nearest = FindNearest(_keyframes, targetMs, currentMs, nullptr);
+	nearest = FindNearest(_captured, targetMs, currentMs, nearest);
+	if (nearest == nullptr)
+	{
+		return false;
+	}
+
+	// Reminder: swap (rather than move) so the pointers are never null, other threads may still be reading e.g. the config of the live engine.
+	const uint_least32_t recycledTimeMs = player->timeMs();
+	builder.swap(nearest->engine.builder);
+	player.swap(nearest->engine.player);
+	nearest->timeMs = recycledTimeMs;
+
+	return true;
+}
+
+void SeekKeyframes::Capture(Engine&& replacement, std::unique_ptr<ReSIDfpBuilder>& builder, std::unique_ptr<sidplayfp>& player)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_captured.size() >= MAX_CAPTURED_KEYFRAMES)
+	{
+		_captured.erase(_captured.begin());
+	}
+
+	Keyframe& captured = _captured.emplace_back();
+	captured.timeMs = player->timeMs();
+	captured.ready = true;
+	captured.engine = std::move(replacement);
+
+	builder.swap(captured.engine.builder);
+	player.swap(captured.engine.player);
+}
+
+SeekKeyframes::Keyframe* SeekKeyframes::FindNearest(std::vector<Keyframe>& keyframes, uint_least32_t targetMs, uint_least32_t currentMs, Keyframe* nearest)
+{
+	for (Keyframe& keyframe : keyframes)
+	{
+		if (keyframe.ready && keyframe.timeMs <= targetMs && keyframe.timeMs > currentMs && (nearest == nullptr || keyframe.timeMs > nearest->timeMs))
+		{
+			nearest = &keyframe;
+		}
+	}
+
+	return nearest;
+}
+
+void SeekKeyframes::WorkerLoop(EngineFactory factory, unsigned int fastForwardCycles)
+{
+	while (!_abort)
+	{
+		const size_t index = _nextToBuild++;
+		if (index >= _keyframes.size())
+		{
+			return;
+		}
+
+		Keyframe& keyframe = _keyframes[index];
+		if (!factory(keyframe.engine))
+		{
+			keyframe.engine = Engine();
+			continue;
+		}
+
+		sidplayfp& player = *keyframe.engine.player;
+		uint_least32_t cTimeMs = 0;
+		while (cTimeMs < keyframe.timeMs && !_abort)
+		{
+			player.play(fastForwardCycles);
+
+			const uint_least32_t newTimeMs = player.timeMs();
+			if (newTimeMs == cTimeMs) [[unlikely]]
+			{
+				break; // The emulation got stuck (shouldn't happen).
+			}
+
+			cTimeMs = newTimeMs;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		keyframe.ready = cTimeMs >= keyframe.timeMs;
+		keyframe.timeMs = cTimeMs;
+	}
+}
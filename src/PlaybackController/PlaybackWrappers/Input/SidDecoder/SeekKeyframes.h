@@ -0,0 +1,95 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include <sidplayfp/sidplayfp.h>
+#include <sidplayfp/builders/residfp.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Seek acceleration: whole emulator instances parked at known playback positions.
+/// libsidplayfp can't snapshot/restore the machine state, so a "keyframe" here is an entire (muted) engine which was fast-forwarded to its position in the background.
+/// A seek swaps in the nearest keyframe behind the target and only needs to emulate the remainder, while the swapped-out engine becomes a keyframe at its own position.
+/// For the same reason the keyframes can't be chained off each other (continuing one consumes it): the layout is spread over the song duration instead, so the total fast-forwarding stays proportional to it.
+class SeekKeyframes
+{
+public:
+	struct Engine
+	{
+		std::unique_ptr<ReSIDfpBuilder> builder; // Must outlive the player.
+		std::unique_ptr<sidplayfp> player;
+	};
+
+	/// @brief Must prepare a loaded, muted engine identical (config, ROMs, tune) to the live one. Called from the worker threads.
+	using EngineFactory = std::function<bool(Engine& engine)>;
+
+	static constexpr uint_least32_t SPACING_MS = 30000; // When the song duration is unknown.
+	static constexpr uint_least32_t MIN_SPACING_MS = 15000;
+	static constexpr size_t MAX_KEYFRAMES = 16; // Each one is a complete emulator instance (roughly 100-200 KiB).
+	static constexpr size_t MAX_CAPTURED_KEYFRAMES = 2; // Live engines parked by the rewinds (the oldest one gets dropped).
+	static constexpr unsigned int MAX_WORKERS = 4;
+
+public:
+	SeekKeyframes() = default;
+	SeekKeyframes(SeekKeyframes&) = delete;
+	~SeekKeyframes();
+
+public:
+	/// @brief Starts fast-forwarding the keyframes to their regularly spaced positions within the song duration (in parallel, in the background). Does nothing if already started.
+	/// @param songDurationMs Zero if unknown (the default spacing is used then).
+	void Build(const EngineFactory& factory, unsigned int fastForwardCycles, uint_least32_t songDurationMs);
+
+	/// @brief Aborts the building and discards all keyframes. Must be called whenever the tune or the emulation config changes.
+	void Clear();
+
+	/// @brief Swaps the given engine with the ready keyframe nearest before (or at) the targetMs, but only if it's ahead of the currentMs (pass zero when rewinding).
+	/// @return True if swapped (the given engine is now the keyframe's one, continue from its timeMs()).
+	bool TrySwapNearest(uint_least32_t targetMs, uint_least32_t currentMs, std::unique_ptr<ReSIDfpBuilder>& builder, std::unique_ptr<sidplayfp>& player);
+
+	/// @brief Swaps in the replacement engine (usually a fresh one) and keeps the given one as a keyframe at the position the playback got it to, instead of discarding it.
+	void Capture(Engine&& replacement, std::unique_ptr<ReSIDfpBuilder>& builder, std::unique_ptr<sidplayfp>& player);
+
+private:
+	struct Keyframe
+	{
+		Engine engine;
+		uint_least32_t timeMs = 0;
+		bool ready = false; // Guarded by the _mutex (the engine itself is only touched by its worker until ready).
+	};
+
+	void WorkerLoop(EngineFactory factory, unsigned int fastForwardCycles);
+
+private:
+	static Keyframe* FindNearest(std::vector<Keyframe>& keyframes, uint_least32_t targetMs, uint_least32_t currentMs, Keyframe* nearest);
+
+private:
+	std::vector<Keyframe> _keyframes;
+	std::vector<Keyframe> _captured; // Guarded by the _mutex (always ready).
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::atomic_size_t _nextToBuild = 0;
+	std::atomic_bool _abort = false;
+	bool _started = false;
+};
@@ -36,7 +36,9 @@ namespace MusLoadHelper
         uint_least32_t musDataLength = 0;
         const uint_least8_t* strData = nullptr;
         uint_least32_t strDataLength = 0;
-    } _data;
+    };
+
+    thread_local Data _data; // Per-thread since the offline render loads tunes on several threads at once.
 
     static bool IsMusFormat(std::filesystem::path fileName)
     {
@@ -110,23 +112,39 @@ namespace
     }
 
     constexpr unsigned int LIBSIDPLAYFP_SEEK_CYCLES = 20000; // Roughly 20ms. For seeking, greater value is marginally better for speed. This particular max value is hardcoded in the lib itself.
+
+    // Disable voices and filters of all SIDs -- yields additional ~4x speedup when seeking
+    void MuteForSeeking(sidplayfp& engine)
+    {
+        const unsigned int maxSids = engine.info().numberOfSIDs();
+        for (unsigned int sid = 0; sid < maxSids; ++sid)
+        {
+            engine.mute(sid, 0, true); // Voice 1
+            engine.mute(sid, 1, true); // Voice 2
+            engine.mute(sid, 2, true); // Voice 3
+            engine.mute(sid, 3, true); // Digi
+            engine.filter(sid, false);
+        }
+    }
 }
 
 SidDecoder::SidDecoder() :
-    _rs(ReSIDfpBuilder(""))
+    _sidEngine(std::make_unique<sidplayfp>()),
+    _rs(std::make_unique<ReSIDfpBuilder>(""))
 {
 }
 
 SidDecoder::~SidDecoder()
 {
-    _sidEngine.load(0);
+    _keyframes.Clear();
+    _sidEngine->load(0);
 }
 
 bool SidDecoder::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
 {
     if (!_mixer)
     {
-        _mixer = std::make_unique<SidMixer>(_sidEngine, _outChannels);
+        _mixer = std::make_unique<SidMixer>(*_sidEngine, _outChannels);
         _mixer->ApplyChannelMatrix(_channelMatrixCache);
     }
 
@@ -136,21 +154,23 @@ bool SidDecoder::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
 
 bool SidDecoder::TryInitEmulation(const SidConfig& sidConfig, const FilterConfig& filterConfig, bool useNtscForMus, int outChannels)
 {
+    _keyframes.Clear();
+
     // Configure the engine
     _sidConfigCache = sidConfig;
-    _sidConfigCache.sidEmulation = &_rs;
+    _sidConfigCache.sidEmulation = _rs.get();
 
-    if (!_sidEngine.config(_sidConfigCache))
+    if (!_sidEngine->config(_sidConfigCache))
     {
-        std::cerr << _sidEngine.error() << std::endl;
+        std::cerr << _sidEngine->error() << std::endl;
         return false;
     }
 
     _filterConfigCache = std::make_unique<FilterConfig>(filterConfig);
-    _rs.filter6581Curve(_filterConfigCache->filter6581Curve);
-    _rs.filter6581Range(_filterConfigCache->filter6581Range);
-    _rs.filter8580Curve(_filterConfigCache->filter8580Curve);
-    _rs.enableOld6581caps(_filterConfigCache->enableOld6581caps);
+    _rs->filter6581Curve(_filterConfigCache->filter6581Curve);
+    _rs->filter6581Range(_filterConfigCache->filter6581Range);
+    _rs->filter8580Curve(_filterConfigCache->filter8580Curve);
+    _rs->enableOld6581caps(_filterConfigCache->enableOld6581caps);
 
     _useNtscForMus = useNtscForMus;
     _outChannels = outChannels;
@@ -182,19 +202,50 @@ RomUtil::RomStatus SidDecoder::TrySetRoms(const std::filesystem::path& pathKerna
     status.Mark(RomUtil::RomType::Basic, basic != 0);
     status.Mark(RomUtil::RomType::Chargen, chargen != 0);
 
-    _sidEngine.setRoms(
-        reinterpret_cast<const uint8_t*>(kernal),
-        reinterpret_cast<const uint8_t*>(basic),
-        reinterpret_cast<const uint8_t*>(chargen)
-    );
-
-    delete[] kernal;
-    delete[] basic;
-    delete[] chargen;
+    // Kept for the seek keyframe engines and the twin decoders
+    _roms.kernal.reset(kernal);
+    _roms.basic.reset(basic);
+    _roms.chargen.reset(chargen);
 
+    ApplyRoms();
     return status;
 }
 
+void SidDecoder::SetRoms(const SidDecoder& romSource)
+{
+    _roms.kernal = romSource._roms.kernal;
+    _roms.basic = romSource._roms.basic;
+    _roms.chargen = romSource._roms.chargen;
+
+    ApplyRoms();
+}
+
+std::string_view SidDecoder::GetRomImage(RomUtil::RomType type) const
+{
+    switch (type)
+    {
+        case RomUtil::RomType::Kernal:
+            return (_roms.kernal != nullptr) ? std::string_view(_roms.kernal.get(), RomUtil::ROM_SIZE_KERNAL) : std::string_view();
+        case RomUtil::RomType::Basic:
+            return (_roms.basic != nullptr) ? std::string_view(_roms.basic.get(), RomUtil::ROM_SIZE_BASIC) : std::string_view();
+        case RomUtil::RomType::Chargen:
+            return (_roms.chargen != nullptr) ? std::string_view(_roms.chargen.get(), RomUtil::ROM_SIZE_CHARGEN) : std::string_view();
+        default:
+            return std::string_view();
+    }
+}
+
+void SidDecoder::ApplyRoms()
+{
+    _keyframes.Clear();
+
+    _sidEngine->setRoms(
+        reinterpret_cast<const uint8_t*>(_roms.kernal.get()),
+        reinterpret_cast<const uint8_t*>(_roms.basic.get()),
+        reinterpret_cast<const uint8_t*>(_roms.chargen.get())
+    );
+}
+
 void SidDecoder::PrepareLoadSong()
 {
     UnloadActiveTune();
@@ -237,6 +288,8 @@ bool SidDecoder::TryLoadMusStrSong(const std::filesystem::path& fileName, const
 
 bool SidDecoder::TrySetSubsong(unsigned int subsong)
 {
+    _keyframes.Clear();
+
     // Check if the tune is valid
     if (!_tune->get().getStatus())
     {
@@ -247,22 +300,22 @@ bool SidDecoder::TrySetSubsong(unsigned int subsong)
     // Handle the MUS NTSC option
     if (_useNtscForMus && MusLoadHelper::IsMusFormat(_tune->filepath))
     {
-        SidConfig config = _sidEngine.config();
+        SidConfig config = _sidEngine->config();
         config.defaultC64Model = SidConfig::c64_model_t::NTSC;
-        _sidEngine.config(config); // Apply the NTSC override option.
+        _sidEngine->config(config); // Apply the NTSC override option.
     }
     else if (_sidConfigCache.defaultC64Model == SidConfig::c64_model_t::NTSC)
     {
-        _sidEngine.config(_sidConfigCache); // Undo any previously applied MUS NTSC override option.
+        _sidEngine->config(_sidConfigCache); // Undo any previously applied MUS NTSC override option.
     }
 
     // Select song
     _tune->get().selectSong(subsong);
 
     // Load tune into engine
-    if (!_sidEngine.load(&_tune->get()))
+    if (!_sidEngine->load(&_tune->get()))
     {
-        std::cerr << _sidEngine.error() << std::endl;
+        std::cerr << _sidEngine->error() << std::endl;
         return false;
     }
 
@@ -278,7 +331,7 @@ bool SidDecoder::WillUseNtscForMus() const
 
 uint_least32_t SidDecoder::GetTime() const
 {
-    return _sidEngine.timeMs();
+    return _sidEngine->timeMs();
 }
 
 int SidDecoder::GetCurrentSubsong() const
@@ -356,7 +409,7 @@ const char* SidDecoder::CalcCurrentTuneMd5() const
 
 const SidInfo& SidDecoder::GetEngineInfo() const
 {
-    return _sidEngine.info();
+    return _sidEngine->info();
 }
 
 const SidDecoder::SidVoicesEnabledStatus& SidDecoder::GetSidVoicesEnabledStatus() const
@@ -371,7 +424,12 @@ const SidDecoder::SidFiltersEnabledStatus& SidDecoder::GetSidFiltersEnabledStatu
 
 const SidConfig& SidDecoder::GetSidConfig() const
 {
-    return _sidEngine.config();
+    return _sidEngine->config();
+}
+
+const SidConfig& SidDecoder::GetInitSidConfig() const
+{
+    return _sidConfigCache;
 }
 
 const SidDecoder::FilterConfig& SidDecoder::GetFilterConfig() const
@@ -379,34 +437,47 @@ const SidDecoder::FilterConfig& SidDecoder::GetFilterConfig() const
     return *_filterConfigCache;
 }
 
-void SidDecoder::SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callback)
+void SidDecoder::SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callback, uint_least32_t songDurationMs)
 {
     _seeking = true;
     _mixer = nullptr;
 
-    uint_least32_t cTimeMs = _sidEngine.timeMs();
-    if (cTimeMs >= timeMs)
+    uint_least32_t cTimeMs = _sidEngine->timeMs();
+    const bool rewind = cTimeMs >= timeMs;
+
+    // Jump to the nearest keyframe (if closer than where we'd start from otherwise), and get the keyframes going for the subsequent seeks
+    const SidConfig config = _sidEngine->config(); // Copy, the engine may get swapped out below.
+    _keyframes.Build([this, config](SeekKeyframes::Engine& engine) { return TryCreateKeyframeEngine(engine, config); }, LIBSIDPLAYFP_SEEK_CYCLES, std::max(songDurationMs, timeMs));
+    if (_keyframes.TrySwapNearest(timeMs, (rewind) ? 0 : cTimeMs, _rs, _sidEngine))
     {
-        cTimeMs = 0;
-        _sidEngine.reset();
+        cTimeMs = _sidEngine->timeMs();
+        _sidConfigCache.sidEmulation = _rs.get();
     }
-
-    // Disable voices and filters of all SIDs -- yields additional ~4x speedup when seeking
-    const unsigned int maxSids = _sidEngine.info().numberOfSIDs();
-    for (unsigned int sid = 0; sid < maxSids; ++sid)
+    else if (rewind)
     {
-        _sidEngine.mute(sid, 0, true); // Voice 1
-        _sidEngine.mute(sid, 1, true); // Voice 2
-        _sidEngine.mute(sid, 2, true); // Voice 3
-        _sidEngine.mute(sid, 3, true); // Digi
-        _sidEngine.filter(sid, false);
+        // Keep the position the playback got to as a keyframe (rather than resetting it away) and start over with a fresh engine
+        SeekKeyframes::Engine fresh;
+        if (cTimeMs > 0 && TryCreateKeyframeEngine(fresh, config))
+        {
+            _keyframes.Capture(std::move(fresh), _rs, _sidEngine);
+            _sidConfigCache.sidEmulation = _rs.get();
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(_tuneAccessMutex);
+            _sidEngine->reset();
+        }
+
+        cTimeMs = 0;
     }
 
+    MuteForSeeking(*_sidEngine);
+
     // Seeking: decode until target timeMs
     bool aborted = false;
     while (cTimeMs < timeMs)
     {
-        _sidEngine.play(LIBSIDPLAYFP_SEEK_CYCLES);
+        _sidEngine->play(LIBSIDPLAYFP_SEEK_CYCLES);
 
         if (callback(cTimeMs, false))
         {
@@ -414,7 +485,7 @@ void SidDecoder::SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callbac
             break;
         }
 
-        cTimeMs = _sidEngine.timeMs();
+        cTimeMs = _sidEngine->timeMs();
     }
 
     // Restore explicitly disabled voices back to their canonical state
@@ -428,6 +499,28 @@ void SidDecoder::SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callbac
     }
 }
 
+uint_least32_t SidDecoder::Emulate(unsigned int cycles)
+{
+    while (cycles > 0)
+    {
+        const unsigned int step = std::min(cycles, LIBSIDPLAYFP_SEEK_CYCLES);
+        _sidEngine->play(step);
+        cycles -= step;
+    }
+
+    return _sidEngine->timeMs();
+}
+
+bool SidDecoder::TryGetSidRegisters(unsigned int sidNum, uint8_t (&regs)[32]) const
+{
+    return _sidEngine->getSidStatus(sidNum, regs);
+}
+
+uint_least16_t SidDecoder::GetCia1TimerA() const
+{
+    return _sidEngine->getCia1TimerA();
+}
+
 void SidDecoder::ToggleVoice(unsigned int sidNum, unsigned int voice, bool enable)
 {
     // Remember as canonical state
@@ -436,7 +529,7 @@ void SidDecoder::ToggleVoice(unsigned int sidNum, unsigned int voice, bool enabl
     // Apply immediately, unless seeking (the seek operation will do it when finished)
     if (!_seeking)
     {
-        _sidEngine.mute(sidNum, voice, !enable); // Reminder: inverted, makes sense due to a "mute" verb.
+        _sidEngine->mute(sidNum, voice, !enable); // Reminder: inverted, makes sense due to a "mute" verb.
     }
 }
 
@@ -448,7 +541,7 @@ void SidDecoder::ToggleFilter(unsigned int sidNum, bool enable)
     // Apply immediately, unless seeking (the seek operation will do it when finished)
     if (!_seeking)
     {
-        _sidEngine.filter(sidNum, enable);
+        _sidEngine->filter(sidNum, enable);
     }
 }
 
@@ -461,24 +554,66 @@ void SidDecoder::SetChannelMatrix(const MultiSidChannelMatrix& matrix)
     }
 }
 
+const MultiSidChannelMatrix& SidDecoder::GetChannelMatrix() const
+{
+    return _channelMatrixCache;
+}
+
 void SidDecoder::UnloadActiveTune()
 {
+    _keyframes.Clear();
+
     if (_tune != nullptr)
     {
-        _sidEngine.load(0);
+        _sidEngine->load(0);
         _tune = nullptr;
     }
 }
 
+bool SidDecoder::TryCreateKeyframeEngine(SeekKeyframes::Engine& engine, SidConfig config) const
+{
+    // Reminder: called from the keyframe worker threads, the SidDecoder's state used here stays unchanged while the keyframes exist (they get cleared first on any change).
+    engine.builder = std::make_unique<ReSIDfpBuilder>("");
+    engine.player = std::make_unique<sidplayfp>();
+
+    config.sidEmulation = engine.builder.get();
+    if (!engine.player->config(config))
+    {
+        return false;
+    }
+
+    engine.builder->filter6581Curve(_filterConfigCache->filter6581Curve);
+    engine.builder->filter6581Range(_filterConfigCache->filter6581Range);
+    engine.builder->filter8580Curve(_filterConfigCache->filter8580Curve);
+    engine.builder->enableOld6581caps(_filterConfigCache->enableOld6581caps);
+
+    engine.player->setRoms(
+        reinterpret_cast<const uint8_t*>(_roms.kernal.get()),
+        reinterpret_cast<const uint8_t*>(_roms.basic.get()),
+        reinterpret_cast<const uint8_t*>(_roms.chargen.get())
+    );
+
+    {
+        std::lock_guard<std::mutex> lock(_tuneAccessMutex);
+        if (!engine.player->load(&_tune->get()))
+        {
+            return false;
+        }
+    }
+
+    MuteForSeeking(*engine.player);
+    return true;
+}
+
 void SidDecoder::ApplyCanonicalVoiceAndFilterStates()
 {
-    const unsigned int maxSids = _sidEngine.info().numberOfSIDs();
+    const unsigned int maxSids = _sidEngine->info().numberOfSIDs();
     for (unsigned int sid = 0; sid < maxSids; ++sid)
     {
-        _sidEngine.mute(sid, 0, !_sidVoicesEnabledStatus.at(sid).at(0)); // Voice 1
-        _sidEngine.mute(sid, 1, !_sidVoicesEnabledStatus.at(sid).at(1)); // Voice 2
-        _sidEngine.mute(sid, 2, !_sidVoicesEnabledStatus.at(sid).at(2)); // Voice 3
-        _sidEngine.mute(sid, 3, !_sidVoicesEnabledStatus.at(sid).at(3)); // Digi
-        _sidEngine.filter(sid, _sidFiltersEnabledStatus.at(sid));
+        _sidEngine->mute(sid, 0, !_sidVoicesEnabledStatus.at(sid).at(0)); // Voice 1
+        _sidEngine->mute(sid, 1, !_sidVoicesEnabledStatus.at(sid).at(1)); // Voice 2
+        _sidEngine->mute(sid, 2, !_sidVoicesEnabledStatus.at(sid).at(2)); // Voice 3
+        _sidEngine->mute(sid, 3, !_sidVoicesEnabledStatus.at(sid).at(3)); // Digi
+        _sidEngine->filter(sid, _sidFiltersEnabledStatus.at(sid));
     }
 }
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "MultiSidChannelMatrix.h"
+#include "SeekKeyframes.h"
 #include "SidMixer.h"
 #include "TuneUtil.h"
 #include "../../IBufferWriter.h"
@@ -31,6 +32,8 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <string_view>
 #include <vector>
 
 struct SidTuneEx
@@ -105,6 +108,12 @@ public:
 
     RomUtil::RomStatus TrySetRoms(const std::filesystem::path& pathKernal, const std::filesystem::path& pathBasic, const std::filesystem::path& pathChargen);
 
+    /// @brief Shares the ROM images already loaded by another decoder (no disk access).
+    void SetRoms(const SidDecoder& romSource);
+
+    /// @brief Returns the loaded ROM image (empty if not loaded).
+    std::string_view GetRomImage(RomUtil::RomType type) const;
+
     [[deprecated("Unicode paths not supported for filepath variant, rather use the oneFileFormatSidtune variant and do custom file loading.")]]
     bool TryLoadSong(const std::filesystem::path& filePath, unsigned int subsong = 0);
 
@@ -139,22 +148,43 @@ public:
     const SidVoicesEnabledStatus& GetSidVoicesEnabledStatus() const;
     const SidFiltersEnabledStatus& GetSidFiltersEnabledStatus() const;
     const SidConfig& GetSidConfig() const;
+
+    /// @brief Gets the config as passed to the TryInitEmulation() (i.e., without the MUS NTSC override which the GetSidConfig() may include).
+    const SidConfig& GetInitSidConfig() const;
     const FilterConfig& GetFilterConfig() const;
 
-    void SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callback);
+    /// @brief Emulates up to the timeMs (muted). The songDurationMs (zero if unknown) only shapes the seek keyframes layout.
+    void SeekTo(uint_least32_t timeMs, const SeekStatusCallback& callback, uint_least32_t songDurationMs = 0);
+
+    /// @brief Advances the emulation by (roughly) the given number of CPU cycles without producing any audio. Returns the new playback time in milliseconds.
+    uint_least32_t Emulate(unsigned int cycles);
+
+    /// @brief Gets the last values written to the SID's registers. Returns false if there's no such SID.
+    bool TryGetSidRegisters(unsigned int sidNum, uint8_t (&regs)[32]) const;
+
+    /// @brief Gets the CIA 1 Timer A value as programmed by the tune (the play routine's period for the CIA-timed tunes).
+    uint_least16_t GetCia1TimerA() const;
+
     void ToggleVoice(unsigned int sidNum, unsigned int voice, bool enable);
     void ToggleFilter(unsigned int sidNum, bool enable);
 
     void SetChannelMatrix(const MultiSidChannelMatrix& matrix);
+    const MultiSidChannelMatrix& GetChannelMatrix() const;
 
     void UnloadActiveTune();
 
 private:
     void PrepareLoadSong();
 
+    // Hands the _roms over to the active engine.
+    void ApplyRoms();
+
     // Applies the SidVoicesEnabledStatus and SidFiltersEnabledStatus to SIDs.
     void ApplyCanonicalVoiceAndFilterStates();
 
+    // Prepares an engine identical to the active one (for the seek keyframes). The config must be the active engine's one (i.e., including the MUS NTSC override if any).
+    bool TryCreateKeyframeEngine(SeekKeyframes::Engine& engine, SidConfig config) const;
+
 private:
     bool _useNtscForMus = false;
     bool _seeking = false;
@@ -165,7 +195,17 @@ private:
     std::unique_ptr<FilterConfig> _filterConfigCache;
     SidVoicesEnabledStatus _sidVoicesEnabledStatus;
     SidFiltersEnabledStatus _sidFiltersEnabledStatus;
-    sidplayfp _sidEngine;
+    std::unique_ptr<sidplayfp> _sidEngine; // Pointer since the seek keyframes swap it.
     std::unique_ptr<SidTuneEx> _tune;
-    ReSIDfpBuilder _rs;
+    std::unique_ptr<ReSIDfpBuilder> _rs; // Goes together with the _sidEngine.
+    mutable std::mutex _tuneAccessMutex; // Serializes the engine (re)loads of the _tune: the keyframe workers load it concurrently and the SidTune isn't thread-safe.
+
+    struct
+    {
+        std::shared_ptr<char[]> kernal; // Shared with the twin decoders (read-only).
+        std::shared_ptr<char[]> basic;
+        std::shared_ptr<char[]> chargen;
+    } _roms;
+
+    SeekKeyframes _keyframes;
 };
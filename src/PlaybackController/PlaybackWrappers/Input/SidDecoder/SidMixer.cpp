@@ -22,8 +22,8 @@
 #include <sidplayfp/sidplayfp.h>
 #include <sidplayfp/SidInfo.h>
 
+#include <algorithm>
 #include <cmath>
-#include <cstdint>
 
 static constexpr float VOLUME_FACTOR_1SID = 1.0f;
 static const float VOLUME_FACTOR_2SID = 1.0f / std::sqrt(2.0f);
@@ -36,69 +36,100 @@ SidMixer::SidMixer(sidplayfp& sidEngine, unsigned int outChannels) :
 	_outChannels(outChannels)
 {
 	_sidEngine.buffers(_sidChipsBuffers);
+	ApplyChannelMatrix({});
 }
 
 void SidMixer::FillBuffer(void* buffer, unsigned long framesPerBuffer)
 {
-	short* const out = static_cast<short*>(buffer);
-	const unsigned long capacity = (_outChannels == 2) ? framesPerBuffer << 1 : framesPerBuffer; // *2 for stereo
+	short* out = static_cast<short*>(buffer);
 
-	unsigned int written = 0;
-	while (written < capacity)
+	unsigned long remaining = framesPerBuffer;
+	while (remaining > 0)
 	{
 		_samplesLen = (_samplesLen == 0) ? _sidEngine.play(LIBSIDPLAYFP_PLAY_CYCLES) : _samplesLen;
 
-		for (; _samplesPos < _samplesLen; ++_samplesPos)
+		const unsigned long frames = std::min(remaining, static_cast<unsigned long>(_samplesLen - _samplesPos));
+		(this->*_mixKernel)(out, _samplesPos, frames);
+
+		out += frames * _outChannels;
+		remaining -= frames;
+		_samplesPos += frames;
+
+		if (_samplesPos == _samplesLen)
 		{
-			for (unsigned int channel = 0; channel < _outChannels; ++channel)
-			{
-				const float panning = _channelMatrix[_numSidChips][0][channel];
-				int_least32_t tmp = std::lrintf(_sidChipsBuffers[0][_samplesPos] * _sidVolumeFactor) * panning; // SID 1
-
-				for (unsigned int chip = 1; chip < _numSidChips; ++chip) // SID 2 & 3 (if used)
-				{
-					const float panning = _channelMatrix[_numSidChips][chip][channel];
-					tmp += std::lrintf(_sidChipsBuffers[chip][_samplesPos] * _sidVolumeFactor) * panning;
-				}
-
-				out[written++] = static_cast<short>(tmp);
-
-				if (written == capacity) [[unlikely]]
-				{
-					++_samplesPos;
-					return; // overflow pending
-				}
-			}
+			_samplesPos = 0;
+			_samplesLen = 0;
 		}
-
-		_samplesPos = 0;
-		_samplesLen = 0;
 	}
 }
 
 void SidMixer::ApplyChannelMatrix(const MultiSidChannelMatrix& matrix)
 {
-	_channelMatrix =
+	using ChannelVolume = MultiSidChannelMatrix::ChannelVolume;
+	static const ChannelVolume unity;
+
+	const std::array<std::array<ChannelVolume, 3>, 4> channelMatrix =
 	{{
-		{{ // Dummy offset (zero-based array)
-			{{1.0f, 1.0f}},
-			{{1.0f, 1.0f}},
-			{{1.0f, 1.0f}}
-		}},
-		{{ // 1SID
-			{{1.0f, 1.0f}}, // SID 1
-			{{1.0f, 1.0f}}, // dummy SID 2
-			{{1.0f, 1.0f}}  // dummy SID 3
-		}},
-		{{ // 2SID
-			{{matrix.tune2Sid_First.left, matrix.tune2Sid_First.right}},   // SID 1
-			{{matrix.tune2Sid_Second.left, matrix.tune2Sid_Second.right}}, // SID 2
-			{{1.0f, 1.0f}} // dummy SID 3
-		}},
-		{{ // 3SID
-			{{matrix.tune3Sid_First.left, matrix.tune3Sid_First.right}},   // SID 1
-			{{matrix.tune3Sid_Second.left, matrix.tune3Sid_Second.right}}, // SID 2
-			{{matrix.tune3Sid_Third.left, matrix.tune3Sid_Third.right}}    // SID 3
-		}}
+		{{unity, unity, unity}}, // Dummy offset (zero-based array)
+		{{unity, unity, unity}}, // 1SID (+ dummy SID 2 & 3)
+		{{matrix.tune2Sid_First, matrix.tune2Sid_Second, unity}}, // 2SID (+ dummy SID 3)
+		{{matrix.tune3Sid_First, matrix.tune3Sid_Second, matrix.tune3Sid_Third}} // 3SID
 	}};
+
+	for (unsigned int chip = 0; chip < _gains.size(); ++chip)
+	{
+		const ChannelVolume& panning = channelMatrix.at(std::min(_numSidChips, 3u)).at(chip);
+		_gains[chip] = {panning.left * _sidVolumeFactor, panning.right * _sidVolumeFactor}; // Mono takes the left one (same as before).
+	}
+
+	const bool stereo = _outChannels == 2;
+	switch (_numSidChips)
+	{
+		case 3:
+			_mixKernel = (stereo) ? &SidMixer::MixFrames<3, 2> : &SidMixer::MixFrames<3, 1>;
+			break;
+		case 2:
+			_mixKernel = (stereo) ? &SidMixer::MixFrames<2, 2> : &SidMixer::MixFrames<2, 1>;
+			break;
+		default:
+			_mixKernel = (stereo) ? &SidMixer::MixFrames<1, 2> : &SidMixer::MixFrames<1, 1>;
+			break;
+	}
+}
+
+template <unsigned int NumSidChips, unsigned int OutChannels>
+void SidMixer::MixFrames(short* out, int samplesPos, unsigned long frames) const
+{
+	const short* const sid1 = _sidChipsBuffers[0] + samplesPos;
+	const short* const sid2 = (NumSidChips > 1) ? _sidChipsBuffers[1] + samplesPos : nullptr;
+	const short* const sid3 = (NumSidChips > 2) ? _sidChipsBuffers[2] + samplesPos : nullptr;
+
+	// Local copies so the compiler knows they can't alias the output
+	float gains[3][2];
+	for (unsigned int chip = 0; chip < 3; ++chip)
+	{
+		gains[chip][0] = _gains[chip][0];
+		gains[chip][1] = _gains[chip][1];
+	}
+
+	// Branch-free (i.e., vectorizable) body: the conditions below are all compile-time
+	for (unsigned long i = 0; i < frames; ++i)
+	{
+		for (unsigned int channel = 0; channel < OutChannels; ++channel)
+		{
+			float mixed = sid1[i] * gains[0][channel];
+			if constexpr (NumSidChips > 1)
+			{
+				mixed += sid2[i] * gains[1][channel];
+			}
+
+			if constexpr (NumSidChips > 2)
+			{
+				mixed += sid3[i] * gains[2][channel];
+			}
+
+			const float saturated = std::min(std::max(mixed, -32768.0f), 32767.0f);
+			out[(i * OutChannels) + channel] = static_cast<short>(saturated + ((saturated < 0.0f) ? -0.5f : 0.5f)); // Round half away from zero.
+		}
+	}
 }
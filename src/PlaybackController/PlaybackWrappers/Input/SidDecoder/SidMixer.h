@@ -39,6 +39,13 @@ public:
 	void FillBuffer(void* buffer, unsigned long framesPerBuffer);
 	void ApplyChannelMatrix(const MultiSidChannelMatrix& matrix);
 
+private:
+	using MixKernel = void (SidMixer::*)(short* out, int samplesPos, unsigned long frames) const;
+
+	/// @brief Mixes a run of frames from the SID chips' buffers, specialized per SID count and output channels so the compiler can vectorize it.
+	template <unsigned int NumSidChips, unsigned int OutChannels>
+	void MixFrames(short* out, int samplesPos, unsigned long frames) const;
+
 private:
 	sidplayfp& _sidEngine;
 
@@ -50,5 +57,6 @@ private:
 	int _samplesPos = 0;
 	int _samplesLen = 0;
 
-	std::array<std::array<std::array<float, 2>, 3>, 4> _channelMatrix;
+	std::array<std::array<float, 2>, 3> _gains{}; // Per-chip panning (for the current SID count) with the volume factor already folded in.
+	MixKernel _mixKernel = nullptr;
 };
@@ -31,6 +31,7 @@ public:
         float volume = 1.0f;
         double sampleRate = 0.0;
         bool lowLatency = false;
+        int decoupledRenderDepthMs = 0; // Zero: the emulation runs directly in the audio callback. Otherwise it's rendered ahead (by up to this much) on a separate thread.
         PaDeviceIndex preferredOutputDevice = paNoDevice;
     };
 
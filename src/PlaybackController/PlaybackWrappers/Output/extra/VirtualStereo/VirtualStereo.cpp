@@ -19,128 +19,70 @@
 #include "VirtualStereo.h"
 
 #include <algorithm>
-#include <cstring> // memcpy
+#include <cstring> // memcpy, memmove
 #include <cmath>
 #include <cstdint>
+#include <limits>
 
 static constexpr size_t CHANNELS = 2;
 static constexpr size_t FULL_TAIL_OFFSET = 2;
+static constexpr size_t CHUNK_FRAMES = 1024; // The output buffer is processed in chunks of up to this size, so the delay line can be allocated upfront (the buffer size isn't known until the callback).
+
+namespace
+{
+	inline short Saturate(long sample)
+	{
+		return static_cast<short>(std::clamp<long>(sample, std::numeric_limits<short>::min(), std::numeric_limits<short>::max()));
+	}
+}
 
 VirtualStereo::VirtualStereo(unsigned int sampleRate, unsigned int offsetMs, float sideVolumeFactor) :
 	_framesOffset(static_cast<unsigned int>(std::floor(sampleRate * (offsetMs / 1000.0)))),
-	_delayBuffer(_framesOffset * CHANNELS * FULL_TAIL_OFFSET)
+	_delayLine((_framesOffset * FULL_TAIL_OFFSET + CHUNK_FRAMES) * CHANNELS, 0) // Silence preceding the playback.
 {
 	ChangeSideVolumeFactor(sideVolumeFactor);
 }
 
 void VirtualStereo::Apply(short* const out, const size_t framesPerBuffer)
 {
-	const size_t samplesPerBuffer = framesPerBuffer * CHANNELS;
-
-	// Warm-up
-	if (!_delayBuffer.IsSaturated())
+	for (size_t frame = 0; frame < framesPerBuffer; frame += CHUNK_FRAMES)
 	{
-		const size_t delayBufferRemaining = _delayBuffer.GetCapacity() - _delayBuffer.GetLength();
-		const size_t samplesToWrite = (samplesPerBuffer > delayBufferRemaining) ? delayBufferRemaining : samplesPerBuffer;
-		_delayBuffer.CopyFrom(out, samplesToWrite);
+		ApplyChunk(out + frame * CHANNELS, std::min(CHUNK_FRAMES, framesPerBuffer - frame));
 	}
+}
 
-	const bool readyFirst = _delayBuffer.GetLength() >= _framesOffset * CHANNELS;
-	const bool readySecond = _delayBuffer.IsSaturated();
-
-	short* tailSampleStraight = nullptr;
-	size_t tailLenStraight = 0;
-
-	short* tailSampleWrapped = nullptr;
-	size_t tailLenWrapped = 0;
+void VirtualStereo::ApplyChunk(short* const out, const size_t frames)
+{
+	const size_t samplesPerBuffer = frames * CHANNELS;
+	const size_t historySamples = _framesOffset * CHANNELS * FULL_TAIL_OFFSET;
 
-	if (readyFirst)
-	{
-		// Store pristine samples
-		_snapshotBuffer.CopyFrom(out, samplesPerBuffer);
+	// Append the pristine samples after the history
+	short* const history = _delayLine.data();
+	short* const current = history + historySamples;
+	std::memcpy(current, out, samplesPerBuffer * sizeof(short));
 
-		// Get tail
-		_delayBuffer.Peek(tailSampleStraight, tailLenStraight, tailSampleWrapped, tailLenWrapped, _delayBuffer.GetLength());
-	}
+	const short* const center = current - (_framesOffset * CHANNELS); // 1x delay (center "present" in HaaS domain)
+	const short* const right = history; // 2x delay (HaaS (n) ms virtual right delayed)
 
-	// Pan the original left (HaaS (-n) ms virtual left preceding)
-	for (size_t frame = 0; frame < framesPerBuffer; ++frame)
-	{
-		out[2 * frame] = std::lrintf(out[2 * frame] * _sideVolumeFactor); // quieter left
-		out[(2 * frame) + 1] = 0; // mute right
-	}
+	const float sideVolumeFactor = _sideVolumeFactor; // Read once, as it may be changed meanwhile.
+	const float centerVolumeFactor = _centerVolumeFactor;
 
-	// Center 1x delay (center "present" in HaaS domain)
-	if (readyFirst)
+	for (size_t sample = 0; sample < samplesPerBuffer; sample += CHANNELS)
 	{
-		const size_t halfTailFrames = std::min(framesPerBuffer, _framesOffset);
-		const size_t halfTailSamples = halfTailFrames * CHANNELS;
-
-		const size_t tailSamplesReadOffset = (!readySecond) ? _warmupReadSamples : _framesOffset * CHANNELS;
-		if (!readySecond)
-		{
-			_warmupReadSamples += halfTailSamples;
-		}
-
-		// Render the 50% of the previous tail first
-		for (size_t frame = 0; frame < halfTailFrames; ++frame)
-		{
-			const size_t writeSample = frame * CHANNELS;
-
-			size_t readSample = tailSamplesReadOffset + writeSample;
-			const short* const tailChunk = ((readSample < tailLenStraight) ? tailSampleStraight : tailSampleWrapped);
-			readSample = (readSample < tailLenStraight) ? readSample : readSample - tailLenStraight;
-
-			out[writeSample] += std::lrintf(*(tailChunk + readSample) * _centerVolumeFactor); //  left
-			out[writeSample + 1] += std::lrintf(*(tailChunk + readSample + 1) * _centerVolumeFactor); // right
-		}
+		// Quieter original left (HaaS (-n) ms virtual left preceding) + center
+		out[sample] = Saturate(std::lrintf(current[sample] * sideVolumeFactor) + std::lrintf(center[sample] * centerVolumeFactor));
 
-		// Render rest of the current frame shifted forward (as needed, depending on the current output buffer size)
-		const short* shiftSamples = _snapshotBuffer.GetData();
-		for (size_t frame = halfTailFrames; frame < framesPerBuffer; ++frame)
-		{
-			const size_t sample = frame * CHANNELS;
-			out[sample] += std::lrintf(*shiftSamples++ * _centerVolumeFactor); // left
-			out[sample + 1] += std::lrintf(*shiftSamples++ * _centerVolumeFactor); // right
-		}
+		// Original right is muted, center + quieter expansion right
+		out[sample + 1] = Saturate(std::lrintf(center[sample + 1] * centerVolumeFactor) + std::lrintf(right[sample + 1] * sideVolumeFactor));
 	}
 
-	// Expansion right -- 2x delay (HaaS (n) ms virtual right delayed)
-	if (readySecond)
-	{
-		const size_t maxTailFrames = std::min(framesPerBuffer, _framesOffset * FULL_TAIL_OFFSET);
-		const size_t maxTailSamples = maxTailFrames * CHANNELS;
-
-		// Render the previous tail first
-		for (size_t frame = 0; frame < maxTailFrames; ++frame)
-		{
-			const size_t writeSample = frame * CHANNELS;
-			const short* const tailChunk = ((writeSample < tailLenStraight) ? tailSampleStraight : tailSampleWrapped);
-			const size_t readSample = (writeSample < tailLenStraight) ? writeSample : writeSample - tailLenStraight;
-
-			// skipped left
-			out[writeSample + 1] += std::lrintf(*(tailChunk + readSample + 1) * _sideVolumeFactor); // quieter right
-		}
-
-		// Render rest of the current frame shifted forward (as needed, depending on the current output buffer size)
-		const short* shiftSamples = _snapshotBuffer.GetData();
-		for (size_t frame = maxTailFrames; frame < framesPerBuffer; ++frame)
-		{
-			const size_t sample = frame * CHANNELS;
-			++shiftSamples; // skip left
-			out[sample + 1] += std::lrintf(*shiftSamples++ * _sideVolumeFactor); // quieter right
-		}
-
-		// Remember the new full tail
-		_delayBuffer.Advance(maxTailSamples);
-		_delayBuffer.CopyFrom(_snapshotBuffer.GetData() + samplesPerBuffer - maxTailSamples, maxTailSamples);
-	}
+	// Remember the new full tail
+	std::memmove(history, history + samplesPerBuffer, historySamples * sizeof(short));
 }
 
 void VirtualStereo::Reset()
 {
-	_delayBuffer.Reset();
-	_warmupReadSamples = 0;
+	std::fill(_delayLine.begin(), _delayLine.end(), 0);
 }
 
 void VirtualStereo::ChangeSideVolumeFactor(float factor)
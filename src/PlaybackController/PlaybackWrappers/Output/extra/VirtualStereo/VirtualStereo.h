@@ -18,8 +18,8 @@
 
 #pragma once
 
-#include "CircularBuffer.h"
-#include "LinearBuffer.h"
+#include <cstddef>
+#include <vector>
 
 class VirtualStereo
 {
@@ -36,11 +36,15 @@ public:
 
 	void ChangeSideVolumeFactor(float factor);
 
+private:
+	/// @brief Applies the effect to a chunk which fits the _delayLine (doesn't allocate, it's called from the audio callback).
+	void ApplyChunk(short* const out, const size_t frames);
+
 private:
 	const size_t _framesOffset = 0;
-	size_t _warmupReadSamples = 0;
-	CircularBuffer _delayBuffer;
-	LinearBuffer _snapshotBuffer;
+
+	/// @brief The last (2 * _framesOffset) input frames followed by the current chunk, so that every delay tap is a plain offset into a contiguous array (no wrap-around branches).
+	std::vector<short> _delayLine;
 
 	float _sideVolumeFactor = 0.5; // 0.5 is maximum
 	float _centerVolumeFactor = 0.5;
@@ -23,123 +23,284 @@
 #include <cstring> // memcpy & memset
 
 static constexpr int GRANULARITY = 4096; // Buffer granularity in thread fill-loop.
-static constexpr std::chrono::milliseconds SEEK_CHECK_SLEEP_MS(15); // Note: increasing this value decreases the indicator smoothness. 15ms should be ideal (especially due to MSW system timer resolution).
+
+static constexpr size_t PAGE_FRAMES = 16384; // ~0.34s at 48kHz.
+static constexpr size_t MAX_RESIDENT_BYTES = 256 * 1024 * 1024; // Above this (~23 minutes of 48kHz stereo) the oldest pages behind the playhead get recycled.
+static constexpr size_t RECYCLE_MARGIN_PAGES = 2; // Pages kept behind the playhead even when recycling.
+static constexpr std::chrono::milliseconds THROTTLE_SLEEP_MS(10); // When the memory budget is exhausted, the renderer waits for the playhead to move on.
+
+static constexpr size_t LIVE_HANDOVER_MARGIN_FRAMES = GRANULARITY; // How far ahead of the playhead the render thread must be before the playback switches over from the live renderer.
 
 PreRender::~PreRender()
 {
 	DestroyData();
 }
 
-void PreRender::DoPreRender(IBufferWriter& renderer, int sampleRate, int numChannels, int durationMs)
+void PreRender::DoPreRender(IBufferWriter& renderer, int sampleRate, int numChannels, int durationMs, std::unique_ptr<IBufferWriter> liveRenderer)
 {
 	AbortPreRender();
 
+	_liveRenderer = std::move(liveRenderer);
+	_livePosition = 0;
+	_liveActive = _liveRenderer != nullptr;
+
 	const double sampleRatePerMs = sampleRate / 1000.0;
+	const size_t frames = CalcFrames(sampleRate, durationMs);
+
+	// Pages are sized per channel count
+	if (numChannels != _numChannels)
+	{
+		_pagesStorage.clear();
+	}
+
 	_numChannels = numChannels;
-	_stridePerMs = sampleRatePerMs * numChannels;
+	_framesPerMs = sampleRatePerMs;
 
-	const int frames = std::ceil(durationMs * sampleRatePerMs);
-	const size_t size = frames * _numChannels * sizeof(short);
+	_pageCount = (frames + PAGE_FRAMES - 1) / PAGE_FRAMES;
 
-	short* result = static_cast<short*>(realloc(_waveBufferContent, size));
-	if (result == nullptr)
+	// Return all pages of the previous song to the pool, releasing those this song can never use (otherwise the pool would keep the longest song's high-water mark)
+	const size_t pagesNeeded = std::min(_pageCount, GetMaxResidentPages());
+	if (_pagesStorage.size() > pagesNeeded)
 	{
-		DestroyData();
-		return; // Out of memory. Should probably throw an exception rather than refusing to play?
+		_pagesStorage.resize(pagesNeeded);
 	}
 
-	_waveBufferContent = result;
-	_waveBufferSize = size;
+	_freePages.clear();
+	for (const Page& page : _pagesStorage)
+	{
+		_freePages.push_back(page.get());
+	}
+
+	_pageTable = std::make_unique<std::atomic<short*>[]>(_pageCount);
+	for (size_t i = 0; i < _pageCount; ++i)
+	{
+		_pageTable[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	_firstResidentPage = 0;
+	_residentPagesCount = 0;
 
 	_playbackPosition = 0;
-	_preRenderedSize = 0;
+	_seekTarget = 0;
+	_totalFrames = frames;
+	_preRenderedFrames = 0;
 	_abortPreRenderFlag = false;
+	_renderThreadDone = false;
 
-	_thread = std::thread([this, frames, size, &renderer]
-    {
-		const size_t maxFramesPerBuffer = std::min(GRANULARITY, frames);
+	_thread = std::thread([this, frames, &renderer]
+	{
+		RenderLoop(renderer, frames);
 
-		while (!_abortPreRenderFlag && _preRenderedSize < size)
 		{
-			size_t chunk = maxFramesPerBuffer;
+			std::lock_guard<std::mutex> lock(_progressMutex);
+			_renderThreadDone = true;
+		}
 
-			// Ensure the last one is trimmed-down
-			const size_t payloadSize = chunk * _numChannels * sizeof(short);
-			size_t newSize = _preRenderedSize + payloadSize;
-			if (newSize > size)
-			{
-				chunk = (size - _preRenderedSize) / _numChannels / sizeof(short);
-				newSize = size;
-			}
+		_progressCv.notify_all();
+	});
+}
 
-			const bool success = renderer.TryFillBuffer(static_cast<short*>(_waveBufferContent) + (_preRenderedSize / sizeof(short)), chunk); // Reminder: calls SidDecoder's TryFillBuffer(), not ours.
-			if (success)
-			{
-				_preRenderedSize = newSize;
-			}
-			else
+void PreRender::DoPreRender(std::unique_ptr<IBufferWriter> ownedRenderer, int sampleRate, int numChannels, int durationMs, std::unique_ptr<IBufferWriter> liveRenderer)
+{
+	AbortPreRender(); // The previous owned renderer may still be in use.
+	_ownedRenderer = std::move(ownedRenderer);
+	DoPreRender(*_ownedRenderer, sampleRate, numChannels, durationMs, std::move(liveRenderer));
+}
+
+size_t PreRender::CalcFrames(int sampleRate, int durationMs)
+{
+	return static_cast<size_t>(std::ceil(durationMs * (sampleRate / 1000.0)));
+}
+
+void PreRender::RenderLoop(IBufferWriter& renderer, size_t frames)
+{
+	const size_t maxResidentPages = GetMaxResidentPages();
+
+	size_t rendered = 0;
+	while (!_abortPreRenderFlag && rendered < frames)
+	{
+		const size_t pageIndex = rendered / PAGE_FRAMES;
+		const size_t offsetInPage = rendered % PAGE_FRAMES;
+
+		short* page = _pageTable[pageIndex].load(std::memory_order_relaxed);
+		if (page == nullptr)
+		{
+			// Stay within the memory budget: recycle the oldest page behind the playhead or wait for the playhead to move on
+			while (_residentPagesCount >= maxResidentPages && !TryRecycleOldestPage())
 			{
-				break;
+				if (_abortPreRenderFlag)
+				{
+					return;
+				}
+
+				std::this_thread::sleep_for(THROTTLE_SLEEP_MS);
 			}
+
+			page = AcquirePage();
+
+			std::lock_guard<std::mutex> lock(_recycleMutex);
+			_pageTable[pageIndex].store(page, std::memory_order_release);
+			++_residentPagesCount;
 		}
-	});
+
+		const size_t chunk = std::min({static_cast<size_t>(GRANULARITY), PAGE_FRAMES - offsetInPage, frames - rendered});
+
+		const bool success = renderer.TryFillBuffer(page + (offsetInPage * _numChannels), static_cast<unsigned long>(chunk)); // Reminder: calls SidDecoder's TryFillBuffer(), not ours.
+		if (!success)
+		{
+			break;
+		}
+
+		rendered += chunk;
+
+		{
+			std::lock_guard<std::mutex> lock(_progressMutex); // Pairs with the seek's predicate check (no lost wakeups).
+			_preRenderedFrames.store(rendered, std::memory_order_release);
+		}
+
+		_progressCv.notify_all();
+	}
 }
 
 bool PreRender::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
 {
-	const size_t length = framesPerBuffer * _numChannels;
-	const size_t framesTo = length * sizeof(short);
-	_playbackPosition += length;
+	short* out = static_cast<short*>(buffer);
+
+	size_t startPosition = _playbackPosition.load();
+	size_t position = startPosition;
+	const size_t available = _preRenderedFrames.load(std::memory_order_acquire);
 
-	if ((_playbackPosition * _numChannels) + framesTo > _preRenderedSize)
+	if (TryFillFromLiveRenderer(buffer, framesPerBuffer, startPosition, available))
 	{
-		std::memset(buffer, 0, framesTo);
+		_playbackPosition.compare_exchange_strong(startPosition, startPosition + framesPerBuffer); // If a seek happened meanwhile, its position wins.
 		return true;
 	}
 
-	std::memcpy(buffer, _waveBufferContent + _playbackPosition, framesTo);
+	size_t remaining = framesPerBuffer;
+	while (remaining > 0)
+	{
+		const size_t pageIndex = position / PAGE_FRAMES;
+		const size_t offsetInPage = position % PAGE_FRAMES;
+		const size_t chunk = std::min(remaining, PAGE_FRAMES - offsetInPage);
+		const size_t chunkSamples = chunk * _numChannels;
+
+		const short* const page = (position + chunk <= available && pageIndex < _pageCount) ? _pageTable[pageIndex].load(std::memory_order_acquire) : nullptr;
+		if (page == nullptr)
+		{
+			std::memset(out, 0, chunkSamples * sizeof(short)); // Not rendered yet (or already recycled).
+		}
+		else
+		{
+			std::memcpy(out, page + (offsetInPage * _numChannels), chunkSamples * sizeof(short));
+		}
+
+		out += chunkSamples;
+		position += chunk;
+		remaining -= chunk;
+	}
+
+	_playbackPosition.compare_exchange_strong(startPosition, position); // If a seek happened meanwhile, its position wins.
 	return true;
 }
 
 int PreRender::GetCurrentSongTimeMs() const
 {
-	return _playbackPosition / _stridePerMs;
+	return (_framesPerMs == 0) ? 0 : static_cast<int>(_playbackPosition / _framesPerMs);
 }
 
 double PreRender::GetPreRenderProgressFactor() const
 {
-	if (_waveBufferSize == 0)
+	if (_totalFrames == 0)
 	{
 		return 0.0;
 	}
 
-	return std::clamp(static_cast<double>(_preRenderedSize) / _waveBufferSize, 0.0, 1.0);
+	return std::clamp(static_cast<double>(_preRenderedFrames) / _totalFrames, 0.0, 1.0);
+}
+
+bool PreRender::CanReplayFromStart() const
+{
+	std::lock_guard<std::mutex> lock(_recycleMutex);
+	return _totalFrames > 0 && _preRenderedFrames == _totalFrames && _firstResidentPage == 0;
 }
 
 void PreRender::Stop()
 {
 	AbortPreRender();
 	_playbackPosition = 0;
+	_seekTarget = 0;
+
+	_liveActive = false;
+	_liveRenderer = nullptr;
+	_ownedRenderer = nullptr; // Reminder: an unfinished cache recording gets discarded along with it.
 }
 
 void PreRender::SeekTo(int timeMs, const SeekStatusCallback& callback)
 {
-	int availTimeMs = (_preRenderedSize / sizeof(short)) / _stridePerMs;
-	while (availTimeMs < timeMs)
+	const size_t wantedPlaybackPosition = std::min(static_cast<size_t>(timeMs * _framesPerMs), static_cast<size_t>(_totalFrames));
+
+	{
+		std::lock_guard<std::mutex> lock(_progressMutex);
+		_seekInterrupted = false;
+	}
+
+	_seekTarget = wantedPlaybackPosition; // Otherwise a target beyond the memory budget would never be reached while the playhead is parked.
+
+	// Wait for the render thread to get there (it notifies after every chunk, so the progress gets reported at that granularity)
+	size_t available = _preRenderedFrames;
+	while (available < wantedPlaybackPosition && !_renderThreadDone)
 	{
-		if (callback(availTimeMs, false))
+		if (callback(static_cast<int>(available / _framesPerMs), false))
 		{
+			CancelSeekTarget();
 			return;
 		}
 
-		std::this_thread::sleep_for(SEEK_CHECK_SLEEP_MS);
+		std::unique_lock<std::mutex> lock(_progressMutex);
+		_progressCv.wait(lock, [this, available]() { return _preRenderedFrames != available || _renderThreadDone || _seekInterrupted; });
+		_seekInterrupted = false; // The callback gets asked again anyway.
+		available = _preRenderedFrames;
+	}
+
+	size_t newPosition = 0;
+	{
+		std::lock_guard<std::mutex> lock(_recycleMutex);
+		const size_t firstResidentFrame = _firstResidentPage * PAGE_FRAMES; // Seeking before it isn't possible anymore if the song exceeded the memory budget.
+		newPosition = std::clamp(std::min(wantedPlaybackPosition, static_cast<size_t>(_preRenderedFrames)), firstResidentFrame, static_cast<size_t>(_totalFrames)); // Only falls short of the wanted position if the rendering failed midway.
+		_liveActive = false; // The live renderer can't jump (the TryFillFromLiveRenderer also notices the position mismatch in case it's mid-buffer right now).
+		_playbackPosition = newPosition;
+		_seekTarget = 0;
+	}
+
+	callback(static_cast<int>(newPosition / _framesPerMs), true);
+}
+
+void PreRender::CancelSeekTarget()
+{
+	std::lock_guard<std::mutex> lock(_recycleMutex);
+	_seekTarget = 0;
+
+	const size_t firstResidentFrame = _firstResidentPage * PAGE_FRAMES;
+	if (_playbackPosition < firstResidentFrame)
+	{
+		_liveActive = false;
+		_playbackPosition = std::min(firstResidentFrame, static_cast<size_t>(_preRenderedFrames));
+	}
+}
 
-		availTimeMs = (_preRenderedSize / sizeof(short)) / _stridePerMs;
+void PreRender::InterruptSeek()
+{
+	{
+		std::lock_guard<std::mutex> lock(_progressMutex);
+		_seekInterrupted = true;
 	}
 
-	const size_t wantedPlaybackPosition = timeMs * _stridePerMs;
-	_playbackPosition = std::min(wantedPlaybackPosition, static_cast<size_t>(_waveBufferSize) / sizeof(short));
-	callback(timeMs, true);
+	_progressCv.notify_all();
+}
+
+IBufferWriter* PreRender::GetLiveRenderer() const
+{
+	return _liveRenderer.get();
 }
 
 void PreRender::AbortPreRender()
@@ -157,8 +318,85 @@ void PreRender::DestroyData()
 {
 	AbortPreRender();
 
-	free(_waveBufferContent);
-	_waveBufferContent = nullptr;
-	_waveBufferSize = 0;
-	_preRenderedSize = 0;
+	_liveActive = false;
+	_liveRenderer = nullptr;
+	_ownedRenderer = nullptr;
+
+	_pageTable = nullptr;
+	_pageCount = 0;
+	_firstResidentPage = 0;
+	_residentPagesCount = 0;
+
+	_freePages.clear();
+	_pagesStorage.clear();
+
+	_totalFrames = 0;
+	_preRenderedFrames = 0;
+}
+
+bool PreRender::TryFillFromLiveRenderer(void* buffer, unsigned long framesPerBuffer, size_t position, size_t available)
+{
+	if (!_liveActive.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	// The live timeline only moves forward in lockstep with the playhead, so once they part ways (seek, song end) or the render thread gets ahead, the live renderer is done for good
+	const size_t totalFrames = _totalFrames;
+	const size_t needed = std::min(position + framesPerBuffer + LIVE_HANDOVER_MARGIN_FRAMES, totalFrames);
+	if (position != _livePosition || position >= totalFrames || available >= needed)
+	{
+		_liveActive = false; // Handover: from here on the pre-rendered data is identical to what the live renderer would produce.
+		return false;
+	}
+
+	if (!_liveRenderer->TryFillBuffer(buffer, framesPerBuffer))
+	{
+		_liveActive = false;
+		return false;
+	}
+
+	_livePosition += framesPerBuffer;
+	return true;
+}
+
+size_t PreRender::GetMaxResidentPages() const
+{
+	const size_t pageBytes = PAGE_FRAMES * _numChannels * sizeof(short);
+	return std::max(RECYCLE_MARGIN_PAGES + 2, MAX_RESIDENT_BYTES / pageBytes);
+}
+
+short* PreRender::AcquirePage()
+{
+	if (!_freePages.empty())
+	{
+		short* const page = _freePages.front();
+		_freePages.pop_front();
+		return page;
+	}
+
+	_pagesStorage.emplace_back(std::make_unique<short[]>(PAGE_FRAMES * _numChannels));
+	return _pagesStorage.back().get();
+}
+
+bool PreRender::TryRecycleOldestPage()
+{
+	std::lock_guard<std::mutex> lock(_recycleMutex);
+
+	if (_residentPagesCount == 0)
+	{
+		return false;
+	}
+
+	const size_t oldestPageEndFrame = (_firstResidentPage + 1 + RECYCLE_MARGIN_PAGES) * PAGE_FRAMES;
+	if (std::max(_playbackPosition.load(), _seekTarget.load()) < oldestPageEndFrame)
+	{
+		return false; // Still needed (or about to be).
+	}
+
+	_freePages.push_back(_pageTable[_firstResidentPage].exchange(nullptr));
+	++_firstResidentPage;
+	--_residentPagesCount;
+
+	return true;
 }
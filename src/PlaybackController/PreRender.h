@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2023-2024 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2023-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,8 +20,12 @@
 
 #include "PlaybackWrappers/IBufferWriter.h"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 class PreRender : public IBufferWriter
 {
@@ -32,29 +36,88 @@ public:
 	~PreRender();
 
 public:
-	void DoPreRender(IBufferWriter& renderer, int sampleRate, int numChannels, int durationMs);
+	/// @brief Starts rendering the song in a background thread.
+	/// The optional liveRenderer must be a freshly started twin of the renderer (same config, tune and subsong): the playback consumes it directly while the render thread is behind the playhead, then hands over to the pre-rendered data (sample-accurately, as both timelines start at frame 0).
+	void DoPreRender(IBufferWriter& renderer, int sampleRate, int numChannels, int durationMs, std::unique_ptr<IBufferWriter> liveRenderer = nullptr);
+
+	/// @brief Same as above, but the PreRender keeps the renderer alive for as long as it's needed (e.g., a disk cache player or recorder).
+	void DoPreRender(std::unique_ptr<IBufferWriter> ownedRenderer, int sampleRate, int numChannels, int durationMs, std::unique_ptr<IBufferWriter> liveRenderer = nullptr);
+
+	/// @brief Number of frames the DoPreRender renders for the given duration.
+	static size_t CalcFrames(int sampleRate, int durationMs);
+
 	bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) override;
 
 public:
 	int GetCurrentSongTimeMs() const;
 	double GetPreRenderProgressFactor() const;
 
+	/// @brief Returns true if the whole song is rendered and still resident (i.e., it can be replayed from the start without rendering it again).
+	bool CanReplayFromStart() const;
+
 	void Stop();
+	/// @brief Waits for the render thread to reach the target (reporting the progress via the callback, which can abort the seek by returning true).
 	void SeekTo(int timeMs, const SeekStatusCallback& callback);
 
+	/// @brief Returns the live renderer (if any), so that the realtime adjustments can be forwarded to it.
+	IBufferWriter* GetLiveRenderer() const;
+
+	/// @brief Wakes up a waiting SeekTo so that it consults its callback right away (call it after flagging the abort for the callback).
+	void InterruptSeek();
+
 private:
+	using Page = std::unique_ptr<short[]>;
+
+	void RenderLoop(IBufferWriter& renderer, size_t frames);
 	void AbortPreRender();
 	void DestroyData();
 
+	/// @brief Audio callback only. Returns true if the buffer was filled from the live renderer (i.e., the pre-render is still behind the playhead).
+	bool TryFillFromLiveRenderer(void* buffer, unsigned long framesPerBuffer, size_t position, size_t available);
+
+	/// @brief The memory budget in pages (for the current channel count).
+	size_t GetMaxResidentPages() const;
+
+	short* AcquirePage();
+
+	/// @brief Recycles the oldest resident page if it's safely behind the playhead (or behind the pending seek target). Returns false if nothing could be recycled.
+	bool TryRecycleOldestPage();
+
+	/// @brief Clears the pending seek target. If pages were recycled for it meanwhile, the playhead moves up to the first resident frame (the only place left to play from).
+	void CancelSeekTarget();
+
 private:
 	int _numChannels = 0;
-	double _stridePerMs = 0; // _sampleRatePerMs * _numChannels
+	double _framesPerMs = 0;
 
-	size_t _playbackPosition = 0;
+	std::atomic_size_t _playbackPosition = 0; // In frames.
+	std::atomic_size_t _seekTarget = 0; // In frames. Where a waiting SeekTo wants to get: the pages behind it may be recycled even if the playhead is still parked.
 
 	std::thread _thread;
-	std::atomic<short*> _waveBufferContent = nullptr;
-	std::atomic_size_t _waveBufferSize = 0;
-	std::atomic_size_t _preRenderedSize = 0;
+	std::atomic_size_t _totalFrames = 0;
+	std::atomic_size_t _preRenderedFrames = 0;
 	std::atomic_bool _abortPreRenderFlag = false;
+
+	// Render progress notifications (for the seeking)
+	std::mutex _progressMutex;
+	std::condition_variable _progressCv;
+	std::atomic_bool _renderThreadDone = true; // Written under the _progressMutex.
+	bool _seekInterrupted = false; // Guarded by the _progressMutex.
+
+	std::unique_ptr<IBufferWriter> _ownedRenderer; // Only released while the render thread isn't running.
+
+	// Live fallback (the live renderer is only released while the audio stream is stopped, the callback merely deactivates it)
+	std::unique_ptr<IBufferWriter> _liveRenderer;
+	std::atomic_bool _liveActive = false;
+	size_t _livePosition = 0; // In frames. Where the live renderer's timeline is at (touched by the audio callback only while active).
+
+	// Paged storage (the page table is allocated upfront, the pages themselves only as the rendering progresses)
+	std::unique_ptr<std::atomic<short*>[]> _pageTable;
+	size_t _pageCount = 0;
+	size_t _firstResidentPage = 0;
+	size_t _residentPagesCount = 0;
+
+	std::vector<Page> _pagesStorage; // Owns all pages allocated for the current song (trimmed only when a pre-render starts), so a page pointer never dangles even if recycled.
+	std::deque<short*> _freePages; // FIFO so that a recycled page gets reused as late as possible.
+	mutable std::mutex _recycleMutex; // Guards the page recycling against seeking (the audio callback never locks).
 };
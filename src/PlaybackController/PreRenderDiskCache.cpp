@@ -0,0 +1,643 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "PreRenderDiskCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+// Layout (little-endian, native for all supported platforms): [Header][Bitstream]
+// The bitstream is a sequence of blocks (BLOCK_FRAMES each, only the last one can be shorter). A block holds, per channel, a Rice parameter followed by
+// the Rice-coded residuals of a fixed 2nd order predictor (whose state carries over between the blocks, so the entry can only be decoded from the start).
+static constexpr char PRERENDER_CACHE_MAGIC[8] = {'S', 'W', 'X', 'P', 'C', 'M', 'Z', '\0'};
+static constexpr uint32_t PRERENDER_CACHE_FORMAT_VERSION = 1;
+
+static constexpr const char* const ENTRY_EXTENSION = ".pcmz";
+static constexpr const char* const TEMP_EXTENSION = ".tmp";
+
+static constexpr size_t BLOCK_FRAMES = 4096;
+static constexpr size_t WRITE_CHUNK_BYTES = 64 * 1024; // The recorder's encoded output gets written out in chunks of (roughly) this size.
+static constexpr int RICE_PARAM_BITS = 5;
+static constexpr int RAW_RESIDUAL_BITS = 18; // Zigzagged 2nd order residuals of 16-bit samples always fit.
+static constexpr int MAX_RICE_PARAM = RAW_RESIDUAL_BITS;
+static constexpr uint32_t RICE_ESCAPE = 24; // Residuals with a quotient this large are stored raw instead (the unary part would get too long).
+
+namespace
+{
+	struct Header
+	{
+		char magic[8];
+		uint32_t formatVersion;
+		uint32_t numChannels;
+		uint64_t frames;
+		uint64_t bitstreamBytes;
+	};
+
+	constexpr uint32_t BitMask(int count)
+	{
+		return static_cast<uint32_t>((1ull << count) - 1);
+	}
+
+	inline uint32_t ZigZag(int32_t value)
+	{
+		return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+	}
+
+	inline int32_t UnZigZag(uint32_t value)
+	{
+		return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+	}
+
+	/// @brief Linear extrapolation from the channel's last two samples (older first).
+	inline int32_t Predict(const int32_t* history)
+	{
+		return 2 * history[1] - history[0];
+	}
+
+	inline void PushHistory(int32_t* history, int32_t sample)
+	{
+		history[0] = history[1];
+		history[1] = sample;
+	}
+}
+
+#pragma region KeyBuilder
+
+PreRenderDiskCache::KeyBuilder::KeyBuilder(std::string_view tuneMd5) :
+	_tuneMd5(tuneMd5),
+	_hash(0xcbf29ce484222325ull)
+{
+	Add(PRERENDER_CACHE_FORMAT_VERSION);
+}
+
+PreRenderDiskCache::KeyBuilder& PreRenderDiskCache::KeyBuilder::Add(std::string_view str)
+{
+	Add(str.size());
+	return AddBytes(str.data(), str.size());
+}
+
+std::string PreRenderDiskCache::KeyBuilder::Build() const
+{
+	char hex[17]{};
+	std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(_hash));
+	return _tuneMd5 + "-" + hex;
+}
+
+PreRenderDiskCache::KeyBuilder& PreRenderDiskCache::KeyBuilder::AddBytes(const void* data, size_t size)
+{
+	// FNV-1a (64-bit)
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		_hash ^= bytes[i];
+		_hash *= 0x100000001b3ull;
+	}
+
+	return *this;
+}
+
+#pragma endregion
+#pragma region Player
+
+bool PreRenderDiskCache::Player::TryOpen(const std::filesystem::path& filepath, size_t frames, int numChannels)
+{
+	if (!_file.TryOpen(filepath) || _file.Size() < sizeof(Header))
+	{
+		return false;
+	}
+
+	Header header{};
+	std::memcpy(&header, _file.Data(), sizeof(Header));
+
+	const bool valid = std::memcmp(header.magic, PRERENDER_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+					   header.formatVersion == PRERENDER_CACHE_FORMAT_VERSION &&
+					   header.numChannels == static_cast<uint32_t>(numChannels) &&
+					   header.frames == frames &&
+					   header.bitstreamBytes == _file.Size() - sizeof(Header); // Catches a truncated file.
+
+	if (!valid)
+	{
+		_file.Close();
+		return false;
+	}
+
+	_pos = reinterpret_cast<const uint8_t*>(_file.Data()) + sizeof(Header);
+	_end = reinterpret_cast<const uint8_t*>(_file.Data()) + _file.Size();
+	_bitBuffer = 0;
+	_bitCount = 0;
+	_ok = true;
+
+	_numChannels = numChannels;
+	_history.assign(static_cast<size_t>(numChannels) * 2, 0);
+	_remainingFrames = frames;
+	_blockPos = 0;
+	_blockFrames = 0;
+
+	return true;
+}
+
+bool PreRenderDiskCache::Player::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
+{
+	short* out = static_cast<short*>(buffer);
+
+	size_t remaining = framesPerBuffer;
+	while (remaining > 0)
+	{
+		if (_blockPos == _blockFrames && !TryDecodeBlock())
+		{
+			return false; // Corrupted, or asked for more than there is.
+		}
+
+		const size_t chunk = std::min(remaining, _blockFrames - _blockPos);
+		const size_t chunkSamples = chunk * _numChannels;
+		std::memcpy(out, _block.data() + (_blockPos * _numChannels), chunkSamples * sizeof(short));
+
+		out += chunkSamples;
+		_blockPos += chunk;
+		remaining -= chunk;
+	}
+
+	return true;
+}
+
+bool PreRenderDiskCache::Player::TryDecodeBlock()
+{
+	const size_t frames = std::min(BLOCK_FRAMES, _remainingFrames);
+	if (frames == 0 || !_ok)
+	{
+		return false;
+	}
+
+	_block.resize(frames * _numChannels);
+
+	for (int channel = 0; channel < _numChannels; ++channel)
+	{
+		const int riceParam = static_cast<int>(ReadBits(RICE_PARAM_BITS));
+		if (riceParam > MAX_RICE_PARAM)
+		{
+			_ok = false;
+			return false;
+		}
+
+		int32_t* history = _history.data() + (channel * 2);
+		for (size_t i = 0; i < frames && _ok; ++i)
+		{
+			const int32_t sample = Predict(history) + UnZigZag(ReadResidual(riceParam));
+			if (sample < -32768 || sample > 32767)
+			{
+				_ok = false;
+				break;
+			}
+
+			_block[(i * _numChannels) + channel] = static_cast<short>(sample);
+			PushHistory(history, sample);
+		}
+	}
+
+	if (!_ok)
+	{
+		return false;
+	}
+
+	_remainingFrames -= frames;
+	_blockFrames = frames;
+	_blockPos = 0;
+
+	return true;
+}
+
+uint32_t PreRenderDiskCache::Player::ReadBits(int count)
+{
+	while (_bitCount < count)
+	{
+		if (_pos == _end)
+		{
+			_ok = false;
+			return 0;
+		}
+
+		_bitBuffer = (_bitBuffer << 8) | *_pos++;
+		_bitCount += 8;
+	}
+
+	_bitCount -= count;
+	return static_cast<uint32_t>(_bitBuffer >> _bitCount) & BitMask(count);
+}
+
+uint32_t PreRenderDiskCache::Player::ReadResidual(int riceParam)
+{
+	uint32_t quotient = 0;
+	while (quotient < RICE_ESCAPE && ReadBits(1) == 1)
+	{
+		++quotient;
+	}
+
+	return (quotient == RICE_ESCAPE) ? ReadBits(RAW_RESIDUAL_BITS) : (quotient << riceParam) | ReadBits(riceParam);
+}
+
+#pragma endregion
+#pragma region Recorder
+
+PreRenderDiskCache::Recorder::Recorder(PreRenderDiskCache& cache, std::string key, std::filesystem::path tempPath, uint64_t generation, IBufferWriter& renderer, size_t frames, int numChannels) :
+	_cache(cache),
+	_key(std::move(key)),
+	_tempPath(std::move(tempPath)),
+	_generation(generation),
+	_renderer(renderer),
+	_frames(frames),
+	_numChannels(numChannels),
+	_maxEntryBytes(cache._capBytes),
+	_outStream(_tempPath, std::ios::trunc | std::ios::binary)
+{
+	_block.reserve(BLOCK_FRAMES * numChannels);
+	_residuals.resize(BLOCK_FRAMES);
+	_history.assign(static_cast<size_t>(numChannels) * 2, 0);
+	_pending.reserve(WRITE_CHUNK_BYTES);
+
+	// The header gets filled in on commit
+	_pending.resize(sizeof(Header));
+	FlushPending();
+}
+
+PreRenderDiskCache::Recorder::~Recorder()
+{
+	if (!_abandoned)
+	{
+		Abandon(); // Incomplete.
+	}
+}
+
+bool PreRenderDiskCache::Recorder::TryFillBuffer(void* buffer, unsigned long framesPerBuffer)
+{
+	if (!_renderer.TryFillBuffer(buffer, framesPerBuffer))
+	{
+		if (!_abandoned)
+		{
+			Abandon();
+		}
+
+		return false;
+	}
+
+	if (_abandoned)
+	{
+		return true;
+	}
+
+	const short* in = static_cast<const short*>(buffer);
+	size_t remaining = std::min(static_cast<size_t>(framesPerBuffer), _frames - _recordedFrames);
+	_recordedFrames += remaining;
+
+	while (remaining > 0)
+	{
+		const size_t pendingFrames = _block.size() / _numChannels;
+		const size_t chunk = std::min(remaining, BLOCK_FRAMES - pendingFrames);
+		_block.insert(_block.end(), in, in + (chunk * _numChannels));
+
+		if (pendingFrames + chunk == BLOCK_FRAMES)
+		{
+			EncodeBlock();
+		}
+
+		in += chunk * _numChannels;
+		remaining -= chunk;
+	}
+
+	if (_pending.size() >= WRITE_CHUNK_BYTES)
+	{
+		FlushPending();
+	}
+
+	if (_writtenBytes + _pending.size() > _maxEntryBytes || !_outStream.good())
+	{
+		Abandon();
+		return true;
+	}
+
+	if (_recordedFrames == _frames)
+	{
+		if (!_block.empty())
+		{
+			EncodeBlock();
+		}
+
+		Commit();
+	}
+
+	return true;
+}
+
+void PreRenderDiskCache::Recorder::EncodeBlock()
+{
+	const size_t frames = _block.size() / _numChannels;
+
+	for (int channel = 0; channel < _numChannels; ++channel)
+	{
+		// Residuals first, as the Rice parameter depends on their mean
+		int32_t* history = _history.data() + (channel * 2);
+		uint64_t sum = 0;
+		for (size_t i = 0; i < frames; ++i)
+		{
+			const int32_t sample = _block[(i * _numChannels) + channel];
+			_residuals[i] = ZigZag(sample - Predict(history));
+			sum += _residuals[i];
+			PushHistory(history, sample);
+		}
+
+		int riceParam = 0;
+		while (riceParam < MAX_RICE_PARAM && (static_cast<uint64_t>(frames) << (riceParam + 1)) <= sum)
+		{
+			++riceParam;
+		}
+
+		WriteBits(static_cast<uint32_t>(riceParam), RICE_PARAM_BITS);
+		for (size_t i = 0; i < frames; ++i)
+		{
+			WriteResidual(_residuals[i], riceParam);
+		}
+	}
+
+	_block.clear();
+}
+
+void PreRenderDiskCache::Recorder::WriteBits(uint32_t value, int count)
+{
+	_bitBuffer = (_bitBuffer << count) | (value & BitMask(count));
+	_bitCount += count;
+
+	while (_bitCount >= 8)
+	{
+		_bitCount -= 8;
+		_pending.push_back(static_cast<uint8_t>(_bitBuffer >> _bitCount));
+	}
+}
+
+void PreRenderDiskCache::Recorder::WriteResidual(uint32_t residual, int riceParam)
+{
+	const uint32_t quotient = residual >> riceParam;
+	if (quotient < RICE_ESCAPE)
+	{
+		WriteBits(BitMask(quotient) << 1, quotient + 1); // Unary, terminated by a zero.
+		WriteBits(residual, riceParam);
+	}
+	else
+	{
+		WriteBits(BitMask(RICE_ESCAPE), RICE_ESCAPE);
+		WriteBits(residual, RAW_RESIDUAL_BITS);
+	}
+}
+
+void PreRenderDiskCache::Recorder::FlushPending()
+{
+	_outStream.write(reinterpret_cast<const char*>(_pending.data()), static_cast<std::streamsize>(_pending.size()));
+	_writtenBytes += _pending.size();
+	_pending.clear();
+}
+
+void PreRenderDiskCache::Recorder::Commit()
+{
+	if (_bitCount > 0)
+	{
+		_pending.push_back(static_cast<uint8_t>(_bitBuffer << (8 - _bitCount)));
+		_bitCount = 0;
+	}
+
+	FlushPending();
+
+	Header header{};
+	std::memcpy(header.magic, PRERENDER_CACHE_MAGIC, sizeof(header.magic));
+	header.formatVersion = PRERENDER_CACHE_FORMAT_VERSION;
+	header.numChannels = static_cast<uint32_t>(_numChannels);
+	header.frames = _frames;
+	header.bitstreamBytes = _writtenBytes - sizeof(Header);
+
+	_outStream.seekp(0);
+	_outStream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	_outStream.close();
+
+	if (_outStream.good() && _writtenBytes <= _maxEntryBytes)
+	{
+		_cache.TryStore(_key, _tempPath, _generation);
+	}
+	else
+	{
+		std::error_code ec;
+		std::filesystem::remove(_tempPath, ec);
+	}
+
+	_abandoned = true; // Done.
+	_pending = std::vector<uint8_t>();
+}
+
+void PreRenderDiskCache::Recorder::Abandon()
+{
+	_abandoned = true;
+	_pending = std::vector<uint8_t>(); // Release the memory.
+
+	if (_outStream.is_open())
+	{
+		_outStream.close();
+	}
+
+	std::error_code ec;
+	std::filesystem::remove(_tempPath, ec);
+}
+
+#pragma endregion
+#pragma region PreRenderDiskCache
+
+void PreRenderDiskCache::SetLocation(const std::filesystem::path& folder, uint64_t capBytes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const bool isNewFolder = folder != _folder;
+	_folder = folder;
+	_capBytes = capBytes;
+
+	if (IsEnabledUnlocked())
+	{
+		if (isNewFolder)
+		{
+			RemoveStaleTempFiles(); // None of ours can be in there yet (a recorder never commits into a different folder than its temporary file's).
+		}
+
+		EvictExcess();
+	}
+}
+
+bool PreRenderDiskCache::IsEnabled() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return IsEnabledUnlocked();
+}
+
+std::unique_ptr<PreRenderDiskCache::Player> PreRenderDiskCache::TryOpen(const std::string& key, size_t frames, int numChannels)
+{
+	std::filesystem::path filepath;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!IsEnabledUnlocked())
+		{
+			return nullptr;
+		}
+
+		filepath = GetEntryPath(key);
+	}
+
+	std::error_code ec;
+	if (!std::filesystem::exists(filepath, ec))
+	{
+		return nullptr;
+	}
+
+	std::filesystem::last_write_time(filepath, std::filesystem::file_time_type::clock::now(), ec); // Marks it as recently used (before mapping, as that may prevent it on some platforms).
+
+	std::unique_ptr<Player> player = std::make_unique<Player>();
+	if (!player->TryOpen(filepath, frames, numChannels))
+	{
+		std::filesystem::remove(filepath, ec); // Corrupted or outdated (the key covers the frame and channel count, so it can't be a legit mismatch).
+		return nullptr;
+	}
+
+	return player;
+}
+
+std::unique_ptr<PreRenderDiskCache::Recorder> PreRenderDiskCache::CreateRecorder(const std::string& key, IBufferWriter& renderer, size_t frames, int numChannels)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!IsEnabledUnlocked())
+	{
+		return nullptr;
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(_folder, ec);
+
+	const std::filesystem::path tempPath = _folder / (key + "-" + std::to_string(_nextTempId++) + TEMP_EXTENSION); // Unique, as the same tune can be recorded twice at once (e.g., as the standby next tune).
+	return std::make_unique<Recorder>(*this, key, tempPath, _generation.load(), renderer, frames, numChannels);
+}
+
+void PreRenderDiskCache::DiscardPendingRecordings()
+{
+	++_generation;
+}
+
+bool PreRenderDiskCache::IsEnabledUnlocked() const
+{
+	return _capBytes > 0 && !_folder.empty();
+}
+
+std::filesystem::path PreRenderDiskCache::GetEntryPath(const std::string& key) const
+{
+	return _folder / (key + ENTRY_EXTENSION);
+}
+
+void PreRenderDiskCache::RemoveStaleTempFiles()
+{
+	std::error_code ec;
+	for (std::filesystem::directory_iterator it(_folder, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if (it->path().extension() == TEMP_EXTENSION)
+		{
+			std::error_code removeEc;
+			std::filesystem::remove(it->path(), removeEc);
+		}
+	}
+}
+
+bool PreRenderDiskCache::TryStore(const std::string& key, const std::filesystem::path& tempPath, uint64_t generation)
+{
+	std::lock_guard<std::mutex> lock(_mutex); // Also serializes the concurrent recorders (e.g., the standby next tune's).
+
+	std::error_code ec;
+	const uint64_t size = std::filesystem::file_size(tempPath, ec);
+	const bool accepted = !ec && IsEnabledUnlocked() && generation == _generation && size <= _capBytes && tempPath.parent_path() == _folder;
+	if (!accepted)
+	{
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+
+	// The temporary file is complete by now, so an interrupted session never leaves a truncated entry behind
+	const std::filesystem::path entryPath = GetEntryPath(key);
+	std::filesystem::remove(entryPath, ec); // The rename doesn't replace an existing file on all platforms.
+	std::filesystem::rename(tempPath, entryPath, ec);
+	if (ec)
+	{
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+
+	EvictExcess();
+	return true;
+}
+
+void PreRenderDiskCache::EvictExcess()
+{
+	struct Entry
+	{
+		std::filesystem::path path;
+		std::filesystem::file_time_type lastUsed;
+		uint64_t size = 0;
+	};
+
+	std::vector<Entry> entries;
+	uint64_t totalSize = 0;
+
+	std::error_code ec;
+	for (std::filesystem::directory_iterator it(_folder, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if (it->path().extension() != ENTRY_EXTENSION)
+		{
+			continue;
+		}
+
+		Entry entry{it->path(), it->last_write_time(ec), it->file_size(ec)};
+		if (!ec)
+		{
+			totalSize += entry.size;
+			entries.emplace_back(std::move(entry));
+		}
+
+		ec.clear();
+	}
+
+	if (totalSize <= _capBytes)
+	{
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+
+	for (const Entry& entry : entries)
+	{
+		if (totalSize <= _capBytes)
+		{
+			break;
+		}
+
+		if (std::filesystem::remove(entry.path, ec))
+		{
+			totalSize -= entry.size;
+		}
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,180 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "PlaybackWrappers/IBufferWriter.h"
+#include "../Util/MemoryMappedFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/// @brief Persistent cache of the complete pre-renders (losslessly compressed PCM files in a folder), so that replaying a tune skips the emulation altogether.
+/// The least recently used entries get evicted once the folder exceeds the size cap.
+class PreRenderDiskCache
+{
+public:
+	/// @brief Accumulates everything the rendered audio depends on into an entry key (which is also the file name stem).
+	class KeyBuilder
+	{
+	public:
+		KeyBuilder() = delete;
+		explicit KeyBuilder(std::string_view tuneMd5);
+
+	public:
+		template <typename T>
+		KeyBuilder& Add(const T& value)
+		{
+			static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Add the individual fields instead (struct padding isn't deterministic).");
+			return AddBytes(&value, sizeof(T));
+		}
+
+		KeyBuilder& Add(std::string_view str);
+
+		std::string Build() const;
+
+	private:
+		KeyBuilder& AddBytes(const void* data, size_t size);
+
+	private:
+		std::string _tuneMd5;
+		uint64_t _hash;
+	};
+
+	/// @brief Plays back a cache entry in place of the emulation (decoding it on the fly).
+	class Player : public IBufferWriter
+	{
+	public:
+		Player() = default;
+		Player(Player&) = delete;
+
+	public:
+		bool TryOpen(const std::filesystem::path& filepath, size_t frames, int numChannels);
+		bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) override;
+
+	private:
+		bool TryDecodeBlock();
+		uint32_t ReadBits(int count);
+		uint32_t ReadResidual(int riceParam);
+
+	private:
+		MemoryMappedFile _file;
+		const uint8_t* _pos = nullptr;
+		const uint8_t* _end = nullptr;
+		uint64_t _bitBuffer = 0;
+		int _bitCount = 0;
+		bool _ok = false;
+
+		std::vector<short> _block; // Decoded, interleaved.
+		std::vector<int32_t> _history; // Per channel: the last two samples (predictor state).
+		size_t _blockPos = 0; // In frames.
+		size_t _blockFrames = 0;
+		size_t _remainingFrames = 0;
+		int _numChannels = 0;
+	};
+
+	/// @brief Passes the renderer's output through unchanged while encoding it into a new cache entry (streamed into a temporary file), which gets committed once the last frame is through (otherwise it's discarded).
+	class Recorder : public IBufferWriter
+	{
+	public:
+		Recorder() = delete;
+		Recorder(Recorder&) = delete;
+		Recorder(PreRenderDiskCache& cache, std::string key, std::filesystem::path tempPath, uint64_t generation, IBufferWriter& renderer, size_t frames, int numChannels);
+
+		~Recorder();
+
+	public:
+		bool TryFillBuffer(void* buffer, unsigned long framesPerBuffer) override;
+
+	private:
+		void EncodeBlock();
+		void WriteBits(uint32_t value, int count);
+		void WriteResidual(uint32_t residual, int riceParam);
+		void FlushPending();
+		void Commit();
+		void Abandon();
+
+	private:
+		PreRenderDiskCache& _cache;
+		const std::string _key;
+		const std::filesystem::path _tempPath;
+		const uint64_t _generation; // The cache refuses the entry if its recordings got discarded meanwhile.
+		IBufferWriter& _renderer;
+		const size_t _frames;
+		const int _numChannels;
+		const uint64_t _maxEntryBytes; // An entry that can't fit into the cache anyway isn't worth the disk writes.
+
+		std::ofstream _outStream;
+		uint64_t _writtenBytes = 0; // Incl. the header placeholder.
+		std::vector<uint8_t> _pending; // Not yet written to the file.
+		uint64_t _bitBuffer = 0;
+		int _bitCount = 0;
+
+		std::vector<short> _block; // Pending, interleaved.
+		std::vector<uint32_t> _residuals; // Scratch (one channel of a block).
+		std::vector<int32_t> _history; // Per channel: the last two samples (predictor state).
+		size_t _recordedFrames = 0;
+		bool _abandoned = false;
+	};
+
+public:
+	PreRenderDiskCache() = default;
+	PreRenderDiskCache(PreRenderDiskCache&) = delete;
+
+public:
+	/// @brief Thread-safe. A zero capBytes disables the cache (the existing entries are left alone). Lowering the cap evicts the excess entries right away.
+	void SetLocation(const std::filesystem::path& folder, uint64_t capBytes);
+
+	bool IsEnabled() const;
+
+	/// @brief Returns nullptr if there's no usable entry with the exact frame and channel count. A hit counts as a use for the LRU eviction.
+	std::unique_ptr<Player> TryOpen(const std::string& key, size_t frames, int numChannels);
+
+	/// @brief Returns nullptr if disabled.
+	std::unique_ptr<Recorder> CreateRecorder(const std::string& key, IBufferWriter& renderer, size_t frames, int numChannels);
+
+	/// @brief Thread-safe. The recordings in progress won't get committed (call it when the rendered audio stops matching their keys, e.g., a realtime adjustment mid-render).
+	void DiscardPendingRecordings();
+
+private:
+	// Reminder: these expect the _mutex to be held.
+	bool IsEnabledUnlocked() const;
+	std::filesystem::path GetEntryPath(const std::string& key) const;
+	void EvictExcess();
+
+	/// @brief Removes the temporary files left behind by an interrupted session.
+	void RemoveStaleTempFiles();
+
+	/// @brief Called by the Recorder (from the render thread). Moves the complete temporary file into place (or removes it if refused).
+	bool TryStore(const std::string& key, const std::filesystem::path& tempPath, uint64_t generation);
+
+private:
+	mutable std::mutex _mutex;
+	std::filesystem::path _folder;
+	uint64_t _capBytes = 0;
+	std::atomic_uint64_t _generation = 0;
+	uint64_t _nextTempId = 0;
+};
@@ -0,0 +1,483 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "SonglengthEstimator.h"
+
+#include <sidplayfp/SidTuneInfo.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace
+{
+	constexpr unsigned int MIN_SAMPLE_PERIOD_CYCLES = 8000; // Multi-speed tunes are sampled every few play calls only (still a fixed phase).
+	constexpr uint_least16_t CIA_TIMER_KERNAL_DEFAULT_PAL = 0x4025; // Left as set by the KERNAL, so the tune is most likely driven by the raster IRQ instead.
+	constexpr uint_least16_t CIA_TIMER_KERNAL_DEFAULT_NTSC = 0x4295;
+
+	constexpr size_t WINDOW_FRAMES = 64; // Snapshots which must match at once before a repetition is considered at all.
+	constexpr uint64_t WINDOW_HASH_BASE = 0x100000001b3ULL;
+
+	constexpr uint_least32_t MIN_LOOP_MS = 4000;
+	constexpr uint_least32_t MIN_CONFIRM_MS = 20000; // Repeated bars within a song mustn't pass for the loop...
+	constexpr uint_least32_t MAX_CONFIRM_MS = 60000; // ...but long loops needn't be played through twice in full.
+	constexpr uint_least32_t SILENCE_CONFIRM_MS = 5000;
+
+	constexpr unsigned int SID_WRITABLE_REGISTERS = 0x19;
+	constexpr unsigned int SID_VOICE_REGISTERS = 7;
+	constexpr unsigned int SID_REG_CONTROL = 4;
+	constexpr unsigned int SID_REG_SUSTAIN_RELEASE = 6;
+	constexpr unsigned int SID_REG_MODE_VOLUME = 0x18;
+
+	constexpr uint_least32_t SID_RELEASE_MS[16] = { 6, 24, 48, 72, 114, 168, 204, 240, 300, 750, 1500, 2400, 3000, 9000, 15000, 24000 };
+
+	constexpr unsigned int MAX_SIDS = 3;
+	constexpr unsigned int MAX_VOICES = 4; // Including the digi.
+
+	unsigned int GetVideoFrameCycles(const SidDecoder& decoder)
+	{
+		const SidConfig& config = decoder.GetSidConfig();
+		SidConfig::c64_model_t model = config.defaultC64Model;
+
+		if (!config.forceC64Model)
+		{
+			switch (decoder.GetCurrentSongInfo().clockSpeed())
+			{
+				case SidTuneInfo::CLOCK_PAL:
+					model = SidConfig::c64_model_t::PAL;
+					break;
+				case SidTuneInfo::CLOCK_NTSC:
+					model = SidConfig::c64_model_t::NTSC;
+					break;
+				default:
+					break;
+			}
+		}
+
+		switch (model)
+		{
+			case SidConfig::c64_model_t::NTSC: [[fallthrough]];
+			case SidConfig::c64_model_t::PAL_M:
+				return 65 * 263;
+			case SidConfig::c64_model_t::OLD_NTSC:
+				return 64 * 262;
+			case SidConfig::c64_model_t::DREAN:
+				return 65 * 312;
+			case SidConfig::c64_model_t::PAL: [[fallthrough]];
+			default:
+				return 63 * 312;
+		}
+	}
+
+	/// @brief The snapshots are taken once per play routine call (as far as it can be told), so that the same music always yields the same snapshots.
+	unsigned int GetSamplePeriodCycles(const SidDecoder& decoder, unsigned int videoFrameCycles)
+	{
+		unsigned int period = videoFrameCycles;
+
+		if (decoder.GetCurrentSongInfo().songSpeed() == SidTuneInfo::SPEED_CIA_1A)
+		{
+			const uint_least16_t timer = decoder.GetCia1TimerA();
+			if (timer != 0 && timer != CIA_TIMER_KERNAL_DEFAULT_PAL && timer != CIA_TIMER_KERNAL_DEFAULT_NTSC)
+			{
+				period = static_cast<unsigned int>(timer) + 1;
+			}
+		}
+
+		return period * ((MIN_SAMPLE_PERIOD_CYCLES + period - 1) / period);
+	}
+
+	void MuteAll(SidDecoder& decoder)
+	{
+		for (unsigned int sid = 0; sid < MAX_SIDS; ++sid)
+		{
+			for (unsigned int voice = 0; voice < MAX_VOICES; ++voice)
+			{
+				decoder.ToggleVoice(sid, voice, false);
+			}
+
+			decoder.ToggleFilter(sid, false);
+		}
+	}
+
+	void AppendDuration(std::string& out, uint_least32_t durationMs)
+	{
+		char buffer[32];
+		const uint_least32_t minutes = durationMs / 60000;
+		const uint_least32_t seconds = (durationMs / 1000) % 60;
+		const uint_least32_t millis = durationMs % 1000;
+
+		const int length = std::snprintf(buffer, sizeof(buffer), "%u:%02u.%03u", static_cast<unsigned int>(minutes), static_cast<unsigned int>(seconds), static_cast<unsigned int>(millis));
+		out.append(buffer, static_cast<size_t>(std::max(0, length)));
+	}
+}
+
+SonglengthEstimator::SonglengthEstimator(const PlaybackController::SyncedPlaybackConfig& playbackConfig, const PlaybackController::RomPaths& roms) :
+	_playbackConfig(playbackConfig),
+	_roms(roms)
+{
+}
+
+SonglengthEstimator::~SonglengthEstimator()
+{
+	Abort();
+}
+
+void SonglengthEstimator::Enqueue(Job&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_abortFlag || !_knownMd5s.insert(job.tuneMd5).second)
+		{
+			return;
+		}
+
+		_jobs.emplace_back(std::move(job));
+
+		// Spawn the workers lazily (one core is left to the playback)
+		const unsigned int numWorkers = std::clamp(std::thread::hardware_concurrency(), 2u, MAX_WORKERS + 1) - 1;
+		if (_workers.size() < numWorkers)
+		{
+			_workers.emplace_back(&SonglengthEstimator::WorkerLoop, this);
+		}
+	}
+
+	_cvJobs.notify_one();
+}
+
+std::vector<SonglengthEstimator::Result> SonglengthEstimator::TakeResults()
+{
+	std::vector<Result> results;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		results.swap(_results);
+	}
+
+	return results;
+}
+
+bool SonglengthEstimator::HasResults() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_results.empty();
+}
+
+void SonglengthEstimator::Abort()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_abortFlag = true;
+		std::move(_jobs.begin(), _jobs.end(), std::back_inserter(_unfinishedJobs));
+		_jobs.clear();
+	}
+
+	_cvJobs.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+	_workers.clear();
+}
+
+std::vector<SonglengthEstimator::Job> SonglengthEstimator::TakeUnfinishedJobs()
+{
+	std::vector<Job> jobs;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		jobs.swap(_unfinishedJobs);
+	}
+
+	return jobs;
+}
+
+uint_least32_t SonglengthEstimator::Estimate(SidDecoder& decoder, const std::atomic_bool* abortFlag)
+{
+	const unsigned int numSids = static_cast<unsigned int>(std::max(1, decoder.GetCurrentTuneSidChipsRequired()));
+	const unsigned int videoFrameCycles = GetVideoFrameCycles(decoder);
+
+	const uint_least32_t firstSampleMs = decoder.Emulate(videoFrameCycles); // Lets the tune's init routine program its timer first.
+	const unsigned int samplePeriod = GetSamplePeriodCycles(decoder, videoFrameCycles);
+
+	std::vector<uint64_t> hashes;
+	std::vector<uint_least32_t> times;
+	std::unordered_map<uint64_t, size_t> windows; // Window hash -> index of the last snapshot of its first occurrence.
+
+	uint64_t windowHash = 0;
+	uint64_t windowHashOutgoingFactor = 1;
+	for (size_t i = 0; i < WINDOW_FRAMES; ++i)
+	{
+		windowHashOutgoingFactor *= WINDOW_HASH_BASE;
+	}
+
+	size_t unchangedRun = 0;
+
+	size_t candidatePeriod = 0; // In snapshots, zero if there's no loop candidate at the moment.
+	size_t candidateFirst = 0;
+	uint_least32_t candidateSinceMs = 0;
+	uint_least32_t candidateConfirmMs = 0;
+
+	bool inSilence = false;
+	uint_least32_t silenceSinceMs = 0;
+	uint_least32_t silenceTailMs = 0;
+
+	uint_least32_t timeMs = firstSampleMs;
+	while (timeMs < MAX_ANALYSIS_MS)
+	{
+		if (abortFlag != nullptr && *abortFlag)
+		{
+			return 0;
+		}
+
+		const uint_least32_t previousMs = timeMs;
+		timeMs = decoder.Emulate(samplePeriod);
+
+		// Snapshot of the SID registers
+		uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+		bool quiet = true;
+		uint_least32_t tailMs = 0;
+
+		for (unsigned int sid = 0; sid < numSids; ++sid)
+		{
+			uint8_t regs[32] = {};
+			if (!decoder.TryGetSidRegisters(sid, regs))
+			{
+				continue;
+			}
+
+			for (unsigned int reg = 0; reg < SID_WRITABLE_REGISTERS; ++reg)
+			{
+				hash = (hash ^ regs[reg]) * 0x100000001b3ULL;
+			}
+
+			if ((regs[SID_REG_MODE_VOLUME] & 0x0f) == 0)
+			{
+				continue; // Muted SID.
+			}
+
+			for (unsigned int voice = 0; voice < 3; ++voice)
+			{
+				const unsigned int base = voice * SID_VOICE_REGISTERS;
+				if ((regs[base + SID_REG_CONTROL] & 0x01) != 0)
+				{
+					quiet = false; // Gate is on.
+				}
+
+				tailMs = std::max(tailMs, SID_RELEASE_MS[regs[base + SID_REG_SUSTAIN_RELEASE] & 0x0f]);
+			}
+		}
+
+		const bool unchanged = !hashes.empty() && hash == hashes.back();
+		unchangedRun = (unchanged) ? unchangedRun + 1 : 0;
+
+		hashes.emplace_back(hash);
+		times.emplace_back(timeMs);
+		const size_t index = hashes.size() - 1;
+
+		// Song's end: nothing is sounding and nothing changes anymore (the digis change the volume constantly, so they don't pass for silence)
+		if (quiet && unchanged)
+		{
+			if (!inSilence)
+			{
+				inSilence = true;
+				silenceSinceMs = previousMs;
+				silenceTailMs = tailMs; // Lets the last notes fade out.
+			}
+
+			if (timeMs - silenceSinceMs >= SILENCE_CONFIRM_MS + silenceTailMs)
+			{
+				return (silenceSinceMs <= firstSampleMs) ? 0 : silenceSinceMs + silenceTailMs; // Silent from the start means it doesn't play on its own at all.
+			}
+		}
+		else
+		{
+			inSilence = false;
+		}
+
+		// Loop point: the snapshots keep repeating those of a while ago
+		windowHash = windowHash * WINDOW_HASH_BASE + hash;
+		if (index >= WINDOW_FRAMES)
+		{
+			windowHash -= hashes[index - WINDOW_FRAMES] * windowHashOutgoingFactor;
+		}
+
+		if (index + 1 < WINDOW_FRAMES)
+		{
+			continue;
+		}
+
+		if (candidatePeriod != 0)
+		{
+			if (hash != hashes[index - candidatePeriod])
+			{
+				candidatePeriod = 0; // Just a repeated part of the song.
+			}
+			else if (timeMs - candidateSinceMs >= candidateConfirmMs)
+			{
+				// Confirmed, so find where the loop actually starts (the matching window is just somewhere within it)
+				size_t loopStart = candidateFirst + 1 - WINDOW_FRAMES;
+				while (loopStart > 0 && hashes[loopStart - 1] == hashes[loopStart - 1 + candidatePeriod])
+				{
+					--loopStart;
+				}
+
+				return times[loopStart + candidatePeriod - 1]; // Until the second time around begins (as HVSC does).
+			}
+		}
+
+		if (candidatePeriod == 0 && unchangedRun + 1 < WINDOW_FRAMES) // Static stretches would trivially repeat themselves.
+		{
+			const auto [it, inserted] = windows.try_emplace(windowHash, index);
+			if (!inserted && timeMs - times[it->second] >= MIN_LOOP_MS)
+			{
+				candidatePeriod = index - it->second;
+				candidateFirst = it->second;
+				candidateSinceMs = timeMs;
+				candidateConfirmMs = std::clamp(timeMs - times[it->second], MIN_CONFIRM_MS, MAX_CONFIRM_MS);
+			}
+		}
+	}
+
+	return 0; // Never-ending (or looping beyond reach).
+}
+
+bool SonglengthEstimator::TryAppendToSonglengthsFile(const std::filesystem::path& filepath, const std::vector<Result>& results)
+{
+	std::error_code ec;
+	const bool exists = std::filesystem::exists(filepath, ec) && std::filesystem::file_size(filepath, ec) > 0;
+
+	std::ofstream file(filepath, std::ios::binary | std::ios::app);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::string content;
+	if (!exists)
+	{
+		content.append("; Song lengths estimated by sidplaywx (for the tunes missing from the HVSC Songlengths.md5)\n[Database]\n");
+	}
+
+	for (const Result& result : results)
+	{
+		content.append("; estimated: ").append(result.filepath).append("\n"); // Reminder: mustn't start with "; /" as that's an HVSC path for the Songlengths parser.
+		content.append(result.tuneMd5).append("=");
+
+		for (size_t i = 0; i < result.durations.size(); ++i)
+		{
+			if (i > 0)
+			{
+				content.append(" ");
+			}
+
+			AppendDuration(content, result.durations[i]);
+		}
+
+		content.append("\n");
+	}
+
+	file.write(content.data(), static_cast<std::streamsize>(content.size()));
+	file.close();
+	return file.good();
+}
+
+bool SonglengthEstimator::TryInitDecoder(SidDecoder& decoder) const
+{
+	if (!decoder.TryInitEmulation(_playbackConfig.sidConfig, _playbackConfig.filterConfig, _playbackConfig.useNtscForMus, _playbackConfig.audioConfig.channelCount))
+	{
+		return false;
+	}
+
+	if (!_roms.kernal.empty() || !_roms.basic.empty() || !_roms.chargen.empty())
+	{
+		decoder.TrySetRoms(_roms.kernal, _roms.basic, _roms.chargen); // Missing ROMs only matter to the tunes which need them (and those fail to load then).
+	}
+
+	return true;
+}
+
+bool SonglengthEstimator::TryEstimate(SidDecoder& decoder, const Job& job, Result& outResult)
+{
+	const std::unique_ptr<BufferHolder> buffer = (job.loadTune) ? job.loadTune() : nullptr;
+	if (buffer == nullptr || !decoder.TryLoadSong(job.tuneFileName, buffer->buffer[0], static_cast<uint_least32_t>(buffer->size[0]), 1))
+	{
+		return false;
+	}
+
+	outResult.tuneMd5 = job.tuneMd5;
+	outResult.filepath = job.filepath;
+
+	const unsigned int totalSubsongs = std::max(1u, job.totalSubsongs);
+	for (unsigned int subsong = 1; subsong <= totalSubsongs; ++subsong)
+	{
+		if (subsong > 1 && !decoder.TrySetSubsong(subsong))
+		{
+			decoder.UnloadActiveTune();
+			return false;
+		}
+
+		MuteAll(decoder); // Reminder: the muting doesn't affect the register state (which is all we look at), but it makes the emulation several times faster.
+		outResult.durations.emplace_back(Estimate(decoder, &_abortFlag));
+	}
+
+	decoder.UnloadActiveTune();
+	return !_abortFlag;
+}
+
+void SonglengthEstimator::WorkerLoop()
+{
+	SidDecoder decoder; // One emulation instance per worker, reused for all of its jobs.
+	const bool initialized = TryInitDecoder(decoder);
+
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cvJobs.wait(lock, [this]() { return _abortFlag || !_jobs.empty(); });
+
+			if (_abortFlag)
+			{
+				return;
+			}
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		Result result;
+		if (initialized && TryEstimate(decoder, job, result))
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_results.emplace_back(std::move(result));
+		}
+		else if (_abortFlag)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_unfinishedJobs.emplace_back(std::move(job));
+		}
+	}
+}
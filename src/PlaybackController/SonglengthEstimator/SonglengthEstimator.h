@@ -0,0 +1,114 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "../PlaybackController.h"
+#include "../PlaybackWrappers/Input/SidDecoder/SidDecoder.h"
+#include "../../Util/BufferHolder.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/// @brief Estimates the song lengths of the tunes which aren't in the Songlengths database by emulating them muted (much faster than real time) on background worker threads.
+/// The SID registers are hashed once per play routine call: a lasting repetition of that sequence marks the loop point, while a lasting silent state marks the song's end.
+class SonglengthEstimator
+{
+public:
+	/// @brief Provides the tune's file content. Called from a worker thread.
+	using TuneLoader = std::function<std::unique_ptr<BufferHolder>()>;
+
+	struct Job
+	{
+		std::string tuneMd5;
+		std::string filepath; // UTF-8. Identifies the tune to the caller (and is noted in the Songlengths file).
+		std::filesystem::path tuneFileName; // Needed for the MUS detection.
+		unsigned int totalSubsongs = 1;
+		TuneLoader loadTune;
+	};
+
+	struct Result
+	{
+		std::string tuneMd5;
+		std::string filepath;
+		std::vector<uint_least32_t> durations; // Per subsong. Zero where no estimate could be made (e.g., a never-ending tune).
+	};
+
+	static constexpr uint_least32_t MAX_ANALYSIS_MS = 10 * 60 * 1000;
+	static constexpr unsigned int MAX_WORKERS = 8;
+
+public:
+	SonglengthEstimator() = delete;
+	SonglengthEstimator(SonglengthEstimator&) = delete;
+
+	/// @brief The emulation config matters for the timing (e.g., the C64 model), the ROMs are needed by some tunes to run at all.
+	SonglengthEstimator(const PlaybackController::SyncedPlaybackConfig& playbackConfig, const PlaybackController::RomPaths& roms);
+	~SonglengthEstimator();
+
+public:
+	/// @brief Thread-safe. Queues the tune for the analysis, unless it was already queued before (by its MD5).
+	void Enqueue(Job&& job);
+
+	/// @brief Thread-safe. Takes all results finished so far.
+	std::vector<Result> TakeResults();
+
+	/// @brief Thread-safe. Returns true if there are any results ready to be taken.
+	bool HasResults() const;
+
+	/// @brief Stops the workers as soon as they finish their current subsong (the unfinished tunes are set aside, see the TakeUnfinishedJobs). Called automatically on destruction.
+	void Abort();
+
+	/// @brief Thread-safe. Takes the jobs which the Abort left unfinished (e.g., to requeue them with another estimator).
+	std::vector<Job> TakeUnfinishedJobs();
+
+public:
+	/// @brief Analyzes the loaded (sub)song on the calling thread. Returns zero if neither the end nor a loop could be determined within the MAX_ANALYSIS_MS.
+	static uint_least32_t Estimate(SidDecoder& decoder, const std::atomic_bool* abortFlag = nullptr);
+
+	/// @brief Appends the results in the Songlengths.md5 format to the file (creates it first if needed).
+	static bool TryAppendToSonglengthsFile(const std::filesystem::path& filepath, const std::vector<Result>& results);
+
+private:
+	bool TryInitDecoder(SidDecoder& decoder) const;
+	bool TryEstimate(SidDecoder& decoder, const Job& job, Result& outResult);
+
+	void WorkerLoop();
+
+private:
+	const PlaybackController::SyncedPlaybackConfig _playbackConfig;
+	const PlaybackController::RomPaths _roms;
+
+	std::deque<Job> _jobs;
+	std::vector<Job> _unfinishedJobs;
+	std::vector<Result> _results;
+	std::unordered_set<std::string> _knownMd5s; // Everything ever queued, so that re-adding the same tunes doesn't analyze them again.
+
+	std::vector<std::thread> _workers;
+	mutable std::mutex _mutex;
+	std::condition_variable _cvJobs;
+	std::atomic_bool _abortFlag = false;
+};
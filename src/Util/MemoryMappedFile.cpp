@@ -0,0 +1,140 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "MemoryMappedFile.h"
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+bool MemoryMappedFile::TryOpen(const std::filesystem::path& filepath)
+{
+	Close();
+
+#ifdef WIN32
+	HANDLE file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_data = static_cast<const char*>(view);
+	_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fd = open(filepath.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps its own reference to the file.
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	_data = static_cast<const char*>(view);
+	_size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+	return true;
+}
+
+void MemoryMappedFile::Close()
+{
+	if (_data == nullptr)
+	{
+		return;
+	}
+
+#ifdef WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	CloseHandle(static_cast<HANDLE>(_fileHandle));
+	_mappingHandle = nullptr;
+	_fileHandle = nullptr;
+#else
+	munmap(const_cast<char*>(_data), _size);
+#endif
+
+	_data = nullptr;
+	_size = 0;
+}
+
+bool MemoryMappedFile::IsOpen() const
+{
+	return _data != nullptr;
+}
+
+const char* MemoryMappedFile::Data() const
+{
+	return _data;
+}
+
+size_t MemoryMappedFile::Size() const
+{
+	return _size;
+}
+
+std::string_view MemoryMappedFile::View() const
+{
+	return std::string_view(_data, _size);
+}
@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2025 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -19,23 +19,36 @@
 #pragma once
 
 #include <cstddef>
+#include <filesystem>
+#include <string_view>
 
-class LinearBuffer
+/// @brief Read-only memory mapping of a whole file (the OS pages it in on demand).
+class MemoryMappedFile
 {
 public:
-	LinearBuffer() = default;
-	LinearBuffer(const LinearBuffer&) = delete;
-	LinearBuffer& operator=(const LinearBuffer&) = delete;
+	MemoryMappedFile() = default;
+	MemoryMappedFile(const MemoryMappedFile&) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
 
-	~LinearBuffer();
+	~MemoryMappedFile();
 
 public:
-	void CopyFrom(const short* const src, size_t length);
-	void CopyTo(short* out);
+	bool TryOpen(const std::filesystem::path& filepath);
+	void Close();
 
-	const short* GetData() const;
+	bool IsOpen() const;
+
+	const char* Data() const;
+	size_t Size() const;
+
+	std::string_view View() const;
 
 private:
-	short* _data = nullptr;
-	size_t _length = 0;
+	const char* _data = nullptr;
+	size_t _size = 0;
+
+#ifdef WIN32
+	void* _fileHandle = nullptr;
+	void* _mappingHandle = nullptr;
+#endif
 };
@@ -0,0 +1,118 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "TuneBufferCache.h"
+
+#include <cstring>
+
+TuneBufferCache::TuneBufferCache(size_t budgetBytes) :
+	_budgetBytes(budgetBytes)
+{
+}
+
+void TuneBufferCache::SetBudget(size_t budgetBytes)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_budgetBytes = budgetBytes;
+	EvictToBudget(_budgetBytes);
+}
+
+size_t TuneBufferCache::GetBudget() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _budgetBytes;
+}
+
+std::unique_ptr<BufferHolder> TuneBufferCache::TryGet(const std::wstring& key, const Stamp& stamp)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const auto it = _index.find(key);
+	if (it == _index.end())
+	{
+		return nullptr;
+	}
+
+	const EntryList::iterator entry = it->second;
+	if (!(entry->stamp == stamp))
+	{
+		Erase(entry); // File was modified since.
+		return nullptr;
+	}
+
+	_entries.splice(_entries.begin(), _entries, entry); // Mark as most recently used.
+
+	std::unique_ptr<BufferHolder> copy = std::make_unique<BufferHolder>(entry->data.size());
+	std::memcpy(copy->buffer[0], entry->data.data(), entry->data.size());
+	return copy;
+}
+
+bool TuneBufferCache::Contains(const std::wstring& key, const Stamp& stamp) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const auto it = _index.find(key);
+	return it != _index.end() && it->second->stamp == stamp;
+}
+
+void TuneBufferCache::Put(const std::wstring& key, const Stamp& stamp, const BufferHolder& content)
+{
+	const size_t size = content.size[0];
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const auto it = _index.find(key);
+	if (it != _index.end())
+	{
+		Erase(it->second);
+	}
+
+	if (size == 0 || size > _budgetBytes)
+	{
+		return;
+	}
+
+	EvictToBudget(_budgetBytes - size);
+
+	_entries.push_front(Entry{key, stamp, std::vector<uint_least8_t>(content.buffer[0], content.buffer[0] + size)});
+	_index.emplace(_entries.front().key, _entries.begin());
+	_usedBytes += size;
+}
+
+void TuneBufferCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_entries.clear();
+	_usedBytes = 0;
+}
+
+void TuneBufferCache::EvictToBudget(size_t budgetBytes)
+{
+	while (_usedBytes > budgetBytes && !_entries.empty())
+	{
+		Erase(std::prev(_entries.end()));
+	}
+}
+
+void TuneBufferCache::Erase(EntryList::iterator it)
+{
+	_usedBytes -= it->data.size();
+	_index.erase(it->key);
+	_entries.erase(it);
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "BufferHolder.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Thread-safe LRU cache of the raw tune file contents (keyed by the full path, i.e., archive path + entry for the Zip files), so that the replays, subsong switches and MUS+STR companion lookups skip both the I/O and the Zip inflation.
+class TuneBufferCache
+{
+public:
+	/// @brief Identifies the version of the file (for the Zip entries it should be the stamp of the archive itself), so that the modified files are not served stale.
+	struct Stamp
+	{
+		int64_t modified = 0;
+		uint64_t size = 0;
+
+		bool operator==(const Stamp& other) const
+		{
+			return modified == other.modified && size == other.size;
+		}
+	};
+
+public:
+	TuneBufferCache() = delete;
+	TuneBufferCache(TuneBufferCache&) = delete;
+
+	/// @brief Budget of 0 disables the cache.
+	explicit TuneBufferCache(size_t budgetBytes);
+
+	TuneBufferCache operator=(const TuneBufferCache&) = delete;
+
+public:
+	/// @brief Shrinking the budget evicts the least recently used entries immediately.
+	void SetBudget(size_t budgetBytes);
+	size_t GetBudget() const;
+
+	/// @brief Returns a fresh copy of the cached content (the callers are free to modify it), or nullptr if not cached or stale (stale entries are evicted).
+	std::unique_ptr<BufferHolder> TryGet(const std::wstring& key, const Stamp& stamp);
+
+	bool Contains(const std::wstring& key, const Stamp& stamp) const;
+
+	/// @brief Caches a copy of the first buffer. Content larger than the whole budget is not cached.
+	void Put(const std::wstring& key, const Stamp& stamp, const BufferHolder& content);
+
+	void Clear();
+
+private:
+	struct Entry
+	{
+		std::wstring key;
+		Stamp stamp;
+		std::vector<uint_least8_t> data;
+	};
+
+	using EntryList = std::list<Entry>;
+
+private:
+	void EvictToBudget(size_t budgetBytes);
+	void Erase(EntryList::iterator it);
+
+private:
+	mutable std::mutex _mutex;
+	EntryList _entries; // Most recently used first.
+	std::unordered_map<std::wstring_view, EntryList::iterator> _index; // Views into the Entry::key (list nodes never move).
+
+	size_t _budgetBytes = 0;
+	size_t _usedBytes = 0;
+};
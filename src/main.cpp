@@ -1,6 +1,6 @@
 /*
  * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
- * Copyright (C) 2021 Jasmin Rutic (bytespiller@gmail.com)
+ * Copyright (C) 2021-2026 Jasmin Rutic (bytespiller@gmail.com)
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,5 +17,30 @@
  */
 
 #include "wxApplication/MyApp.h"
+#include "wxApplication/BatchCli/BatchCli.h"
 
-wxIMPLEMENT_APP(MyApp);
+wxIMPLEMENT_APP_NO_MAIN(MyApp);
+
+// Same as the wxIMPLEMENT_APP would do, except the headless batch mode gets a chance to run without the GUI (and without a display)
+
+#ifdef WIN32
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
+{
+    if (BatchCli::IsRequested(__argc, __argv))
+    {
+        return BatchCli::Run(__argc, __argv);
+    }
+
+    return wxEntry(hInstance, hPrevInstance, lpCmdLine, nCmdShow);
+}
+#else
+int main(int argc, char** argv)
+{
+    if (BatchCli::IsRequested(argc, argv))
+    {
+        return BatchCli::Run(argc, argv);
+    }
+
+    return wxEntry(argc, argv);
+}
+#endif
@@ -0,0 +1,512 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "BatchCli.h"
+#include "../Config/AppSettings.h"
+#include "../Config/PlaybackConfig.h"
+#include "../FramePlayer/PlaylistIngest.h"
+#include "../Helpers/HelpersWx.h"
+#include "../../HvscSupport/Songlengths.h"
+#include "../../HvscSupport/Stil/Stil.h"
+#include "../../PlaybackController/OfflineRender/OfflineRender.h"
+
+#include <wx/init.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+	#include <windows.h>
+	#include <shellapi.h>
+#endif
+
+namespace
+{
+	enum ExitCode : int
+	{
+		Success = 0,
+		SomeFailed = 1,
+		UsageError = 2
+	};
+
+	constexpr const char* const USAGE =
+		"Usage: sidplaywx --cli <command> [options] <files/folders/zips...>\n"
+		"\n"
+		"Commands:\n"
+		"  info                 Print one JSON line per tune (metadata, Songlengths & STIL info).\n"
+		"  render               Render tunes to WAV files.\n"
+		"\n"
+		"Options:\n"
+		"  --songlengths <file> Songlengths.md5 (default: as set in the preferences, or the bundled one).\n"
+		"  --stil <file>        STIL.txt (default: as set in the preferences, or the bundled one).\n"
+		"  --subsongs           All subsongs (default: the default subsong only).\n"
+		"  --out <folder>       Render output folder (default: current folder).\n"
+		"  --samplerate <hz>    Render sample rate (default: 48000).\n"
+		"  --mono               Render in mono (default: as set in the preferences).\n"
+		"  --fallback <seconds> Render duration of tunes unknown to the Songlengths (default: as set in the preferences).\n"
+		"  --jobs <n>           Render worker threads (default: all cores).\n";
+
+	constexpr const char* const BUNDLED_SONGLENGTHS_FILENAME = "bundled-Songlengths.md5";
+	constexpr const char* const BUNDLED_STIL_FILENAME = "bundled-STIL.txt";
+	constexpr unsigned int DEFAULT_SAMPLE_RATE = 48000;
+	constexpr std::chrono::milliseconds PROGRESS_INTERVAL_MS(500);
+
+	struct Options
+	{
+		wxString command;
+		wxArrayString paths;
+
+		wxString songlengthsPath;
+		wxString stilPath;
+		bool allSubsongs = false;
+		wxString outFolder;
+		unsigned int sampleRate = DEFAULT_SAMPLE_RATE;
+		bool mono = false;
+		int fallbackDurationSec = -1; // Negative: from the preferences.
+		unsigned int jobs = 0;
+	};
+
+	/// @brief Returns the command line arguments as Unicode strings. On Windows the argv is in the ANSI code page (which can't represent every path), so the wide command line is parsed instead.
+	wxArrayString GetArguments(int argc, char** argv)
+	{
+		wxArrayString args;
+
+#ifdef WIN32
+		int wideArgc = 0;
+		wchar_t** wideArgv = CommandLineToArgvW(GetCommandLineW(), &wideArgc);
+		if (wideArgv != nullptr)
+		{
+			for (int i = 0; i < wideArgc; ++i)
+			{
+				args.Add(wideArgv[i]);
+			}
+
+			LocalFree(wideArgv);
+			return args;
+		}
+
+		for (int i = 0; i < argc; ++i)
+		{
+			args.Add(wxString(argv[i])); // ANSI fallback.
+		}
+#else
+		for (int i = 0; i < argc; ++i)
+		{
+			args.Add(wxString::FromUTF8(argv[i]));
+		}
+#endif
+
+		return args;
+	}
+
+	bool TryParseOptions(const wxArrayString& args, Options& outOptions)
+	{
+		const int argc = static_cast<int>(args.size());
+		if (argc < 3)
+		{
+			return false;
+		}
+
+		outOptions.command = args[2];
+		outOptions.outFolder = wxGetCwd();
+
+		for (int i = 3; i < argc; ++i)
+		{
+			const wxString& arg = args[i];
+			const bool hasValue = i + 1 < argc;
+
+			if (arg == "--subsongs")
+			{
+				outOptions.allSubsongs = true;
+			}
+			else if (arg == "--mono")
+			{
+				outOptions.mono = true;
+			}
+			else if (arg == "--songlengths" && hasValue)
+			{
+				outOptions.songlengthsPath = wxFileName(args[++i]).GetAbsolutePath();
+			}
+			else if (arg == "--stil" && hasValue)
+			{
+				outOptions.stilPath = wxFileName(args[++i]).GetAbsolutePath();
+			}
+			else if (arg == "--out" && hasValue)
+			{
+				outOptions.outFolder = wxFileName::DirName(args[++i]).GetAbsolutePath();
+			}
+			else if (arg == "--samplerate" && hasValue)
+			{
+				outOptions.sampleRate = std::wcstoul(args[++i].wc_str(), nullptr, 10);
+				if (outOptions.sampleRate < 8000 || outOptions.sampleRate > 192000)
+				{
+					return false; // libsidplayfp supports sample rates in this range only.
+				}
+			}
+			else if (arg == "--fallback" && hasValue)
+			{
+				outOptions.fallbackDurationSec = static_cast<int>(std::wcstol(args[++i].wc_str(), nullptr, 10));
+			}
+			else if (arg == "--jobs" && hasValue)
+			{
+				outOptions.jobs = std::wcstoul(args[++i].wc_str(), nullptr, 10);
+			}
+			else if (arg.StartsWith("--"))
+			{
+				return false; // Unknown option (or a missing value).
+			}
+			else
+			{
+				outOptions.paths.Add(wxFileName(args[i]).GetAbsolutePath());
+			}
+		}
+
+		return (outOptions.command == "info" || outOptions.command == "render") && !outOptions.paths.IsEmpty();
+	}
+
+	/// @brief Tries the explicit path, then the preferences one, then the bundled one.
+	template <typename Database>
+	bool TryLoadDatabase(Database& database, const wxString& explicitPath, const wxString& preferencesPath, const char* bundledFilename)
+	{
+		if (!explicitPath.IsEmpty())
+		{
+			return database.TryLoad(explicitPath.ToStdWstring()); // Already absolute.
+		}
+
+		for (const wxString& path : {preferencesPath, wxString(bundledFilename)})
+		{
+			if (!path.IsEmpty() && wxFileExists(path) && database.TryLoad(path.ToStdWstring()))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	#pragma region JSON
+
+	std::string JsonString(const std::string& utf8)
+	{
+		std::string out("\"");
+		out.reserve(utf8.size() + 2);
+
+		for (const char c : utf8)
+		{
+			switch (c)
+			{
+				case '"':
+					out.append("\\\"");
+					break;
+				case '\\':
+					out.append("\\\\");
+					break;
+				case '\n':
+					out.append("\\n");
+					break;
+				case '\r':
+					out.append("\\r");
+					break;
+				case '\t':
+					out.append("\\t");
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+					{
+						char escaped[8];
+						std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+						out.append(escaped);
+					}
+					else
+					{
+						out.push_back(c);
+					}
+					break;
+			}
+		}
+
+		out.push_back('"');
+		return out;
+	}
+
+	std::string JsonString(const wxString& str)
+	{
+		return JsonString(std::string(str.utf8_str()));
+	}
+
+	std::string JsonStilField(const Stil::Field& field)
+	{
+		std::ostringstream out;
+		out << '{';
+
+		bool first = true;
+		for (const auto& [subsong, entries] : field)
+		{
+			out << ((first) ? "" : ",") << '"' << subsong << "\":[";
+			for (size_t i = 0; i < entries.size(); ++i)
+			{
+				out << ((i == 0) ? "" : ",") << JsonString(Helpers::Wx::StringFromWin1252(entries[i]));
+			}
+
+			out << ']';
+			first = false;
+		}
+
+		out << '}';
+		return out.str();
+	}
+
+	std::string TuneToJson(const PlaylistIngest::TuneDescriptor& tune, const Stil& stil)
+	{
+		std::ostringstream out;
+		out << "{\"path\":" << JsonString(tune.filepath) << ",\"valid\":" << ((tune.valid) ? "true" : "false");
+
+		if (tune.valid)
+		{
+			out << ",\"title\":" << JsonString(tune.title)
+				<< ",\"author\":" << JsonString(tune.author)
+				<< ",\"released\":" << JsonString(tune.copyright)
+				<< ",\"subsongs\":" << tune.totalSubsongs
+				<< ",\"defaultSubsong\":" << tune.defaultSubsong
+				<< ",\"md5\":" << ((tune.md5.empty()) ? "null" : JsonString(tune.md5))
+				<< ",\"hvscPath\":" << ((tune.hvscPath.empty()) ? "null" : JsonString(tune.hvscPath));
+
+			// Durations (zero means unknown)
+			out << ",\"durationsMs\":[";
+			if (tune.subsongDurations.empty())
+			{
+				out << tune.duration;
+			}
+			else
+			{
+				for (size_t i = 0; i < tune.subsongDurations.size(); ++i)
+				{
+					out << ((i == 0) ? "" : ",") << tune.subsongDurations[i];
+				}
+			}
+			out << ']';
+
+			if (stil.IsLoaded() && !tune.hvscPath.empty())
+			{
+				const Stil::Info& info = stil.Get(tune.hvscPath);
+				out << ",\"stil\":{"
+					<< "\"names\":" << JsonStilField(info.names)
+					<< ",\"titles\":" << JsonStilField(info.titles)
+					<< ",\"artists\":" << JsonStilField(info.artists)
+					<< ",\"authors\":" << JsonStilField(info.authors)
+					<< ",\"comments\":" << JsonStilField(info.comments)
+					<< '}';
+			}
+		}
+
+		out << '}';
+		return out.str();
+	}
+
+	#pragma endregion
+
+	int RunInfo(const Options& options, const Songlengths& songlengths, const Stil& stil)
+	{
+		const wxArrayString& files = Helpers::Wx::Files::GetValidFiles(options.paths);
+
+		PlaylistIngest ingest(files, songlengths);
+		size_t invalid = 0;
+
+		while (!ingest.IsDone())
+		{
+			for (const PlaylistIngest::TuneDescriptorPtr& tune : ingest.TakeReady(PROGRESS_INTERVAL_MS))
+			{
+				invalid += (tune->valid) ? 0 : 1;
+				std::cout << TuneToJson(*tune, stil) << '\n';
+			}
+		}
+
+		std::cout.flush();
+		return (invalid == 0) ? ExitCode::Success : ExitCode::SomeFailed;
+	}
+
+	int RunRender(const Options& options, Settings::AppSettings& settings, const Songlengths& songlengths)
+	{
+		// Config (the same as the GUI playback would use, except for the audio device specifics)
+		PortAudioOutput::AudioConfig audioConfig;
+		const Settings::AppSettings::OutChannels outChannelsMode = static_cast<Settings::AppSettings::OutChannels>(settings.GetOption(Settings::AppSettings::ID::OutChannels)->GetValueAsInt());
+		const bool mono = options.mono || outChannelsMode == Settings::AppSettings::OutChannels::ForceMono;
+		audioConfig.channelCount = (mono) ? 1 : 2;
+		audioConfig.sampleRate = options.sampleRate;
+
+		const bool useNtscForMus = settings.GetOption(Settings::AppSettings::ID::UseNtscForMus)->GetValueAsBool();
+		OfflineRender::Settings renderSettings(PlaybackController::SyncedPlaybackConfig(audioConfig, Settings::LoadSidConfig(SidConfig(), settings), Settings::LoadFilterConfig(settings), useNtscForMus));
+		renderSettings.channelMatrix.matrix = (mono) ? MultiSidChannelMatrix() : Settings::LoadMultiSidChannelMatrix(settings);
+		renderSettings.roms =
+		{
+			settings.GetOption(Settings::AppSettings::ID::RomKernalPath)->GetValueAsString().ToStdWstring(),
+			settings.GetOption(Settings::AppSettings::ID::RomBasicPath)->GetValueAsString().ToStdWstring(),
+			settings.GetOption(Settings::AppSettings::ID::RomChargenPath)->GetValueAsString().ToStdWstring()
+		};
+
+		const int fallbackDurationSec = (options.fallbackDurationSec >= 0) ? options.fallbackDurationSec : settings.GetOption(Settings::AppSettings::ID::SongFallbackDuration)->GetValueAsInt();
+		const wxString& outFolder = options.outFolder;
+		if (!wxFileName::DirExists(outFolder) && !wxFileName::Mkdir(outFolder, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+		{
+			std::cerr << "Can't create the output folder: " << outFolder.utf8_str() << std::endl;
+			return ExitCode::UsageError;
+		}
+
+		// Jobs
+		std::vector<OfflineRender::Job> jobs;
+		std::set<wxString> usedNames;
+		size_t invalid = 0;
+
+		{
+			PlaylistIngest ingest(Helpers::Wx::Files::GetValidFiles(options.paths), songlengths);
+			while (!ingest.IsDone())
+			{
+				for (const PlaylistIngest::TuneDescriptorPtr& tune : ingest.TakeReady(PROGRESS_INTERVAL_MS))
+				{
+					if (!tune->valid)
+					{
+						++invalid;
+						std::cerr << "Skipped (invalid): " << tune->filepath.utf8_str() << std::endl;
+						continue;
+					}
+
+					const bool musStrPair = !tune->musCompanionStrFilePath.IsEmpty(); // Its subsongs are fake (the individual MUS+STR components), so render the pair only.
+					const bool eachSubsong = options.allSubsongs && tune->totalSubsongs > 1 && !musStrPair;
+					const int firstSubsong = (eachSubsong) ? 1 : tune->defaultSubsong;
+					const int lastSubsong = (eachSubsong) ? tune->totalSubsongs : tune->defaultSubsong;
+
+					for (int subsong = firstSubsong; subsong <= lastSubsong; ++subsong)
+					{
+						uint_least32_t durationMs = (tune->subsongDurations.empty() || musStrPair) ? tune->duration : tune->subsongDurations.at(subsong - 1);
+						if (durationMs == 0)
+						{
+							durationMs = static_cast<uint_least32_t>(fallbackDurationSec) * 1000;
+						}
+
+						OfflineRender::Job job;
+						job.tuneFileName = wxFileName(tune->filepath).GetFullName().ToStdWstring();
+						job.loadTune = [filepath = tune->filepath, musCompanionStrFilePath = tune->musCompanionStrFilePath]()
+						{
+							return Helpers::Wx::Files::GetTuneContent(filepath, musCompanionStrFilePath);
+						};
+						job.subsong = (musStrPair) ? 0 : subsong;
+						job.durationMs = durationMs;
+						job.outputPath = Helpers::Wx::Files::MakeUniqueOutputPath(outFolder, tune->filepath, (eachSubsong) ? subsong : 0, "wav", usedNames).ToStdWstring();
+						jobs.emplace_back(std::move(job));
+					}
+				}
+			}
+		}
+
+		// Render
+		std::vector<std::filesystem::path> outputPaths; // For the report (the renderer adopts the jobs).
+		outputPaths.reserve(jobs.size());
+		for (const OfflineRender::Job& job : jobs)
+		{
+			outputPaths.emplace_back(job.outputPath);
+		}
+
+		OfflineRender render(std::move(jobs), renderSettings, options.jobs);
+
+		while (!render.IsDone())
+		{
+			std::this_thread::sleep_for(PROGRESS_INTERVAL_MS);
+			std::cerr << "\rRendered " << render.GetFinishedCount() << "/" << render.GetJobsCount() << std::flush;
+		}
+
+		render.Wait();
+		std::cerr << std::endl;
+
+		size_t failed = 0;
+		for (size_t i = 0; i < render.GetJobsCount(); ++i)
+		{
+			const bool success = render.GetJobStatus(i) == OfflineRender::JobStatus::Done;
+			failed += (success) ? 0 : 1;
+			std::cout << "{\"output\":" << JsonString(wxString(outputPaths[i].wstring())) << ",\"success\":" << ((success) ? "true" : "false") << "}\n";
+		}
+
+		std::cout.flush();
+		return (failed == 0 && invalid == 0) ? ExitCode::Success : ExitCode::SomeFailed;
+	}
+}
+
+namespace BatchCli
+{
+	bool IsRequested(int argc, char** argv)
+	{
+		return argc > 1 && std::strcmp(argv[1], SWITCH) == 0;
+	}
+
+	int Run(int argc, char** argv)
+	{
+#ifdef WIN32
+		// We're a GUI subsystem executable, so the console output must be explicitly routed to the calling console
+		if (AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			std::freopen("CONOUT$", "w", stdout);
+			std::freopen("CONOUT$", "w", stderr);
+		}
+#endif
+
+		// Console-only wx (no display needed): file system, zip & string support
+		wxAppConsole::SetInstance(new wxAppConsole()); // Takes precedence over the MyApp (GUI) instance which would otherwise get created.
+		wxInitializer initializer(argc, argv);
+		if (!initializer.IsOk())
+		{
+			std::cerr << "Failed to initialize wxWidgets." << std::endl;
+			return ExitCode::UsageError;
+		}
+
+		Options options;
+		if (!TryParseOptions(GetArguments(argc, argv), options)) // Makes the paths absolute, so must precede the CWD change below.
+		{
+			std::cerr << USAGE;
+			return ExitCode::UsageError;
+		}
+
+		wxSetWorkingDirectory(wxPathOnly(wxStandardPaths::Get().GetExecutablePath())); // Same as the GUI: the settings and the paths within them are relative to the executable.
+		wxFileSystem::AddHandler(new wxZipFSHandler);
+
+		Settings::AppSettings settings;
+		settings.TryLoad(settings.GetDefaultSettings());
+
+		Songlengths songlengths;
+		if (!TryLoadDatabase(songlengths, options.songlengthsPath, settings.GetOption(Settings::AppSettings::ID::SonglengthsPath)->GetValueAsString(), BUNDLED_SONGLENGTHS_FILENAME))
+		{
+			std::cerr << "Songlengths database not loaded (durations unknown)." << std::endl;
+		}
+
+		Stil stil;
+		if (options.command == "info" && songlengths.IsLoaded()) // STIL piggybacks on the Songlengths for the HVSC paths.
+		{
+			TryLoadDatabase(stil, options.stilPath, settings.GetOption(Settings::AppSettings::ID::StilPath)->GetValueAsString(), BUNDLED_STIL_FILENAME);
+		}
+
+		return (options.command == "info") ? RunInfo(options, songlengths, stil) : RunRender(options, settings, songlengths);
+	}
+}
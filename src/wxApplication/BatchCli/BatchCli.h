@@ -0,0 +1,31 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+/// @brief Headless (no display needed) batch mode: "sidplaywx --cli <command> [options] <paths...>". Scans files/folders/zips, prints tune info as JSON lines and renders tunes to WAV files.
+namespace BatchCli
+{
+	static constexpr const char* const SWITCH = "--cli";
+
+	/// @brief Returns true if the command line asks for the batch mode (must be the first argument).
+	bool IsRequested(int argc, char** argv);
+
+	/// @brief Runs the batch mode to completion and returns the process exit code. Must be called instead of the wx GUI entry (not in addition to it).
+	int Run(int argc, char** argv);
+}
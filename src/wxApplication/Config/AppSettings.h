@@ -34,6 +34,7 @@ namespace Settings
 			// Prefs
 			static constexpr const char* const AudioOutputDevice = "AudioOutputDevice";
 			static constexpr const char* const LowLatency = "LowLatency";
+			static constexpr const char* const DecoupledRenderDepth = "DecoupledRenderDepth";
 			static constexpr const char* const OutChannels = "OutChannels";
 			static constexpr const char* const VirtualStereoSpeakerDistance = "VirtualStereoSpeakerDistance";
 			static constexpr const char* const VirtualStereoSideVolumeFactor = "VirtualStereoSideVolumeFactor";
@@ -52,7 +53,9 @@ namespace Settings
 			static constexpr const char* const PanMatrix_3Sid_ThirdRight = "PanMatrix_3Sid_ThirdRight";
 
 			static constexpr const char* const PreRenderEnabled = "PreRenderEnabled";
+			static constexpr const char* const PreRenderCacheSize = "PreRenderCacheSize";
 			static constexpr const char* const AutoPlay = "AutoPlay";
+			static constexpr const char* const PreloadNextSong = "PreloadNextSong";
 			static constexpr const char* const SongFallbackDuration = "SongFallbackDuration";
 			static constexpr const char* const SkipShorter = "SkipShorter";
 			static constexpr const char* const PopSilencer = "PopSilencer";
@@ -69,7 +72,9 @@ namespace Settings
 
 			static constexpr const char* const SonglengthsPath = "SonglengthsPath";
 			static constexpr const char* const SonglengthsTrim = "SonglengthsTrim";
+			static constexpr const char* const SonglengthsEstimate = "SonglengthsEstimate";
 			static constexpr const char* const StilPath = "StilPath";
+			static constexpr const char* const StilPreload = "StilPreload";
 
 			static constexpr const char* const DefaultC64Model = "DefaultC64Model";
 			static constexpr const char* const DefaultSidModel = "DefaultSidModel";
@@ -87,6 +92,7 @@ namespace Settings
 			static constexpr const char* const RomChargenPath = "RomChargenPath";
 
 			static constexpr const char* const RememberPlaylist = "RememberPlaylist";
+			static constexpr const char* const TuneCacheBudget = "TuneCacheBudget";
 			static constexpr const char* const MediaKeys = "MediaKeys";
 			static constexpr const char* const SingleInstance = "SingleInstance";
 			static constexpr const char* const RestoreDefaults = "RestoreDefaults";
@@ -172,6 +178,7 @@ namespace Settings
 				// Prefs
 				DefaultOption(ID::AudioOutputDevice, PREFERRED_DEFAULT_AUDIO_DEVICE_NAME),
 				DefaultOption(ID::LowLatency, true),
+				DefaultOption(ID::DecoupledRenderDepth, 0),
 				DefaultOption(ID::OutChannels, static_cast<int>(OutChannels::Default)),
 				DefaultOption(ID::VirtualStereoSpeakerDistance, 7),
 				DefaultOption(ID::VirtualStereoSideVolumeFactor, 0.18),
@@ -190,7 +197,9 @@ namespace Settings
 				DefaultOption(ID::PanMatrix_3Sid_ThirdRight, 1.0),
 
 				DefaultOption(ID::PreRenderEnabled, false),
+				DefaultOption(ID::PreRenderCacheSize, 512),
 				DefaultOption(ID::AutoPlay, true),
+				DefaultOption(ID::PreloadNextSong, true),
 				DefaultOption(ID::RepeatMode, static_cast<int>(UIElements::RepeatModeButton::RepeatMode::Normal)),
 				DefaultOption(ID::RepeatModeIncludeSubsongs, false),
 				DefaultOption(ID::RepeatModeDefaultSubsong, true),
@@ -206,7 +215,9 @@ namespace Settings
 
 				DefaultOption(ID::SonglengthsPath, ""),
 				DefaultOption(ID::SonglengthsTrim, 0),
+				DefaultOption(ID::SonglengthsEstimate, true),
 				DefaultOption(ID::StilPath, ""),
+				DefaultOption(ID::StilPreload, false),
 
 				DefaultOption(ID::DefaultC64Model, static_cast<int>(DefaultC64Model::Prefer_PAL)),
 				DefaultOption(ID::DefaultSidModel, static_cast<int>(DefaultSidModel::Prefer_MOS6581)),
@@ -224,6 +235,7 @@ namespace Settings
 				DefaultOption(ID::RomChargenPath, ""),
 
 				DefaultOption(ID::RememberPlaylist, true),
+				DefaultOption(ID::TuneCacheBudget, 32),
 				DefaultOption(ID::MediaKeys, true),
 				DefaultOption(ID::SingleInstance, 1),
 				RuntimeOption(ID::RestoreDefaults, false, DEFAULT), // RuntimeOption
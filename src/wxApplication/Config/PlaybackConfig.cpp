@@ -0,0 +1,129 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2021-2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "PlaybackConfig.h"
+
+namespace
+{
+	struct ExtractedC64ModelSetting
+	{
+		ExtractedC64ModelSetting() = delete;
+		explicit ExtractedC64ModelSetting(Settings::AppSettings& settings)
+		{
+			using DefaultC64Model = Settings::AppSettings::DefaultC64Model;
+
+			const int intValue = settings.GetOption(Settings::AppSettings::ID::DefaultC64Model)->GetValueAsInt();
+			const DefaultC64Model c64ModelOption = static_cast<DefaultC64Model>(intValue);
+
+			if (c64ModelOption == Settings::AppSettings::DefaultC64Model::Prefer_PAL || c64ModelOption == DefaultC64Model::Force_PAL)
+			{
+				defaultC64Model = SidConfig::c64_model_t::PAL;
+			}
+			else if (c64ModelOption == DefaultC64Model::Prefer_NTSC || c64ModelOption == DefaultC64Model::Force_NTSC)
+			{
+				defaultC64Model = SidConfig::c64_model_t::NTSC;
+			}
+			else if (c64ModelOption == DefaultC64Model::Prefer_Old_NTSC || c64ModelOption == DefaultC64Model::Force_Old_NTSC)
+			{
+				defaultC64Model = SidConfig::c64_model_t::OLD_NTSC;
+			}
+			else if (c64ModelOption == DefaultC64Model::Prefer_Drean || c64ModelOption == DefaultC64Model::Force_Drean)
+			{
+				defaultC64Model = SidConfig::c64_model_t::DREAN;
+			}
+			else if (c64ModelOption == DefaultC64Model::Prefer_PAL_M || c64ModelOption == DefaultC64Model::Force_PAL_M)
+			{
+				defaultC64Model = SidConfig::c64_model_t::PAL_M;
+			}
+
+			forceC64Model = intValue >= static_cast<int>(DefaultC64Model::Force_PAL);
+		};
+
+		SidConfig::c64_model_t defaultC64Model = SidConfig::c64_model_t::PAL;
+		bool forceC64Model = false;
+	};
+
+	struct ExtractedSidModelSetting
+	{
+		ExtractedSidModelSetting() = delete;
+		explicit ExtractedSidModelSetting(Settings::AppSettings& settings)
+		{
+			using DefaultSidModel = Settings::AppSettings::DefaultSidModel;
+			const DefaultSidModel sidModelOption = static_cast<DefaultSidModel>(settings.GetOption(Settings::AppSettings::ID::DefaultSidModel)->GetValueAsInt());
+			if ((sidModelOption == DefaultSidModel::Prefer_MOS8580) || (sidModelOption == DefaultSidModel::Force_MOS8580))
+			{
+				defaultSidModel = SidConfig::sid_model_t::MOS8580;
+			}
+
+			forceSidModel = (sidModelOption == DefaultSidModel::Force_MOS6581) || (sidModelOption == DefaultSidModel::Force_MOS8580);
+		};
+
+		SidConfig::sid_model_t defaultSidModel = SidConfig::sid_model_t::MOS6581;
+		bool forceSidModel = false;
+	};
+}
+
+namespace Settings
+{
+	SidConfig LoadSidConfig(SidConfig baseSidConfig, AppSettings& settings)
+	{
+		const ExtractedSidModelSetting sidModelSetting(settings);
+		baseSidConfig.defaultSidModel = sidModelSetting.defaultSidModel;
+		baseSidConfig.forceSidModel = sidModelSetting.forceSidModel;
+
+		const ExtractedC64ModelSetting c64ModelSetting(settings);
+		baseSidConfig.defaultC64Model = c64ModelSetting.defaultC64Model;
+		baseSidConfig.forceC64Model = c64ModelSetting.forceC64Model;
+
+		baseSidConfig.digiBoost = settings.GetOption(Settings::AppSettings::ID::DigiBoost)->GetValueAsBool();
+		baseSidConfig.powerOnDelay = 16; // Force predictable powerOnDelay, 16 should be minimal stable value and also so low (microseconds) that we don't have to account for it.
+
+		return baseSidConfig;
+	}
+
+	PlaybackController::FilterConfig LoadFilterConfig(AppSettings& settings)
+	{
+		return {
+			settings.GetOption(Settings::AppSettings::ID::FilterCurve6581)->GetValueAsDouble(),
+			settings.GetOption(Settings::AppSettings::ID::FilterRange6581)->GetValueAsDouble(),
+			settings.GetOption(Settings::AppSettings::ID::FilterCurve8580)->GetValueAsDouble(),
+			settings.GetOption(Settings::AppSettings::ID::Old6581caps)->GetValueAsBool()
+		};
+	}
+
+	MultiSidChannelMatrix LoadMultiSidChannelMatrix(AppSettings& settings)
+	{
+		MultiSidChannelMatrix matrix;
+
+		// 2SID
+		matrix.tune2Sid_First.left = settings.GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_FirstLeft)->GetValueAsFloat();
+		matrix.tune2Sid_First.right = settings.GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_FirstRight)->GetValueAsFloat();
+		matrix.tune2Sid_Second.left = settings.GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_SecondLeft)->GetValueAsFloat();
+		matrix.tune2Sid_Second.right = settings.GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_SecondRight)->GetValueAsFloat();
+
+		// 3SID
+		matrix.tune3Sid_First.left = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_FirstLeft)->GetValueAsFloat();
+		matrix.tune3Sid_First.right = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_FirstRight)->GetValueAsFloat();
+		matrix.tune3Sid_Second.left = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_SecondLeft)->GetValueAsFloat();
+		matrix.tune3Sid_Second.right = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_SecondRight)->GetValueAsFloat();
+		matrix.tune3Sid_Third.left = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_ThirdLeft)->GetValueAsFloat();
+		matrix.tune3Sid_Third.right = settings.GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_ThirdRight)->GetValueAsFloat();
+
+		return matrix;
+	}
+}
@@ -0,0 +1,34 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2021-2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "AppSettings.h"
+#include "../../PlaybackController/PlaybackController.h"
+#include "../../PlaybackController/PlaybackWrappers/Input/SidDecoder/MultiSidChannelMatrix.h"
+
+namespace Settings
+{
+	/// @brief Applies the SID & C64 model preferences to the base config.
+	SidConfig LoadSidConfig(SidConfig baseSidConfig, AppSettings& settings);
+
+	PlaybackController::FilterConfig LoadFilterConfig(AppSettings& settings);
+
+	/// @brief Gets the multi-SID panning matrix preferences (as-is, i.e., regardless of the mono/virtual stereo output modes).
+	MultiSidChannelMatrix LoadMultiSidChannelMatrix(AppSettings& settings);
+}
@@ -44,6 +44,7 @@ namespace Strings
 		inline constexpr const char* const MENU_ITEM_SUBMENU_PLAYLIST("Playlist");
 		inline constexpr const char* const MENU_ITEM_PLAYLIST_OPEN("Open...");
 		inline constexpr const char* const MENU_ITEM_PLAYLIST_SAVE("Save As...");
+		inline constexpr const char* const MENU_ITEM_PLAYLIST_EXPORT_WAV("Export to WAV...");
 		inline constexpr const char* const MENU_ITEM_PLAYLIST_SHUFFLE("Shuffle");
 		inline constexpr const char* const MENU_ITEM_PLAYLIST_CLEAR("Clear");
 		inline constexpr const char* const MENU_ITEM_PLAYLIST_RESET_DEMO("Demo songs");
@@ -87,9 +88,16 @@ namespace Strings
 		inline constexpr const char* const BROWSE_FILES_ALL("All Files");
 
 		inline constexpr const char* const STATUS_DISCOVERING_FILES("Discovering files...");
+		inline constexpr const char* const STATUS_DISCOVERING_FILES_IN_FOLDER("Discovering files (%i found): %s");
 		inline constexpr const char* const STATUS_CLEARING_PLAYLIST("Busy clearing playlist...");
 		inline constexpr const char* const STATUS_ADDING_FILES_WITH_COUNT("Adding %i files");
 
+		inline constexpr const char* const EXPORT_WAV_CHOOSE_FOLDER("Choose the folder for the WAV files");
+		inline constexpr const char* const EXPORT_WAV_PROGRESS_TITLE("Export to WAV");
+		inline constexpr const char* const EXPORT_WAV_PROGRESS("Rendered %i / %i");
+		inline constexpr const char* const EXPORT_WAV_DONE("Exported %i of %i songs to:\n%s");
+		inline constexpr const char* const EXPORT_WAV_NOTHING("There are no playable songs to export.");
+
 		inline constexpr const char* const STATUS_PAUSED("Paused");
 		inline constexpr const char* const STATUS_PLAYING("Playing");
 		inline constexpr const char* const STATUS_PLAYING_PRERENDER("Playing (instant)");
@@ -234,6 +242,9 @@ namespace Strings
 		inline constexpr const char* const OPT_LOW_LATENCY("Low latency");
 		inline constexpr const char* const DESC_LOW_LATENCY("Enable for more responsive controls.\nDisable if experiencing stuttering.\nNote: ongoing playback will stop when changing this setting.");
 
+		inline constexpr const char* const OPT_DECOUPLED_RENDER_DEPTH("Render-ahead buffer");
+		inline constexpr const char* const DESC_DECOUPLED_RENDER_DEPTH("Emulate on a separate thread up to this many milliseconds ahead of the playback, so that the emulation spikes (e.g., 3SID tunes) don't cause stuttering.\n0 = disabled (emulate directly in the audio callback). Values below twice the audio buffer size are raised to that.\nNot used in the instant seeking mode.\nNote: ongoing playback will stop when changing this setting.");
+
 		inline constexpr const char* const OPT_OUT_CHANNELS("Channels");
 		inline constexpr const char* const DESC_OUT_CHANNELS("- Mono: mono output for all tunes.\n- Normal: stereo for multi-SID tunes.\n- Virtual stereo: wide sound stage (ideal for headphones).");
 		inline constexpr const char* const ITEM_OUT_CHANNELS_MONO("Mono");
@@ -295,9 +306,15 @@ namespace Strings
 		inline constexpr const char* const OPT_PRERENDER("Instant seeking");
 		inline constexpr const char* const DESC_PRERENDER("Pre-render the song to allow for instant seeking.\n- Some realtime features (e.g., toggling voices, Leave Running) won't work during playback in this mode.\n- Ongoing playback will stop when changing this setting.\n(This option is also available in a Repeat Mode button's context menu.)");
 
+		inline constexpr const char* const OPT_PRERENDER_CACHE_SIZE("Instant seeking disk cache");
+		inline constexpr const char* const DESC_PRERENDER_CACHE_SIZE("Disk space (in megabytes) for keeping the complete pre-renders (losslessly compressed), so that replaying a song in the Instant seeking mode skips the emulation. The least recently played songs are dropped when full.\nThe pre-renders are specific to the current emulation settings.\n0 = disabled.");
+
 		inline constexpr const char* const OPT_AUTOPLAY("Autoplay");
 		inline constexpr const char* const DESC_AUTOPLAY("- Play added files immediately (unless enqueued).\n- Always start playback on track navigation.");
 
+		inline constexpr const char* const OPT_PRELOAD_NEXT_SONG("Preload next song");
+		inline constexpr const char* const DESC_PRELOAD_NEXT_SONG("Load the next song of the playlist in the background while the current one plays, so that the automatic transition to it is immediate.\nIn the instant seeking mode the next song gets pre-rendered as well, which uses additional memory and CPU.");
+
 		inline constexpr const char* const OPT_START_DEFAULT_SUBSONG("Start default subsong");
 		inline constexpr const char* const DESC_START_DEFAULT_SUBSONG("Start multi-tunes from their default subsong (indicated with a crown icon, isn't necessarily the first subsong).\nTurn this off to always start a multi-tune from its first subsong.\n(This option is also available in a Repeat Mode button's context menu.)");
 
@@ -352,9 +369,14 @@ namespace Strings
 		inline constexpr const char* const OPT_SONGLENGTHS_TRIM("Songlengths trim offset");
 		inline constexpr const char* const DESC_SONGLENGTHS_TRIM("Playback duration offset (in milliseconds, limited to 1 second).\nFor example a value of -500 would play the tunes for a half second shorter than the displayed time.");
 
+		inline constexpr const char* const OPT_SONGLENGTHS_ESTIMATE("Estimate missing song lengths");
+		inline constexpr const char* const DESC_SONGLENGTHS_ESTIMATE("Tunes which aren't in the Songlengths database get their song lengths estimated in the background (a fast muted emulation looks for the song's end or its loop point). The estimates are kept for the next time.\nApplies to the tunes added from now on.");
+
 		inline constexpr const char* const OPT_STIL_PATH("Path to STIL.txt file");
 		inline constexpr const char* const DESC_STIL_PATH("If missing, a bundled STIL database will be used instead (which is likely older).");
 		inline constexpr const char* const WILDCARD_DESC_STIL_TXT("STIL text file");
+		inline constexpr const char* const OPT_STIL_PRELOAD("Preload STIL into memory");
+		inline constexpr const char* const DESC_STIL_PRELOAD("Parses the whole STIL database once in the background so that the STIL info lookups are instant (uses more memory).");
 
 		// Emulation
 		inline constexpr const char* const CATEGORY_EMULATION("Emulation");
@@ -410,6 +432,9 @@ namespace Strings
 		inline constexpr const char* const OPT_REMEMBER_PLAYLIST("Remember playlist");
 		inline constexpr const char* const DESC_REMEMBER_PLAYLIST("Restore the previous song list on app launch.");
 
+		inline constexpr const char* const OPT_TUNE_CACHE_BUDGET("Tune cache size");
+		inline constexpr const char* const DESC_TUNE_CACHE_BUDGET("Memory budget (in megabytes) for keeping the recently used tune files in memory, so that replaying them (especially from within Zip archives) skips the file reading and decompression.\n0 = disabled.");
+
 		inline constexpr const char* const OPT_MEDIA_KEYS("Use Media keys");
 		inline constexpr const char* const DESC_MEDIA_KEYS("Use the Media keys to control the playback.\nIf you don't have Media keys on your keyboard, you can use an utility such as AutoHotkey to emulate them with hotkeys of your choice.");
 
@@ -34,6 +34,15 @@ namespace
     constexpr int MIN_POP_SILENCER = 0;
     constexpr int MAX_POP_SILENCER = 1000;
 
+    constexpr int MIN_DECOUPLED_RENDER_DEPTH = 0;
+    constexpr int MAX_DECOUPLED_RENDER_DEPTH = 1000;
+
+    constexpr int MIN_PRERENDER_CACHE_SIZE = 0;
+    constexpr int MAX_PRERENDER_CACHE_SIZE = 65536;
+
+    constexpr int MIN_TUNE_CACHE_BUDGET = 0;
+    constexpr int MAX_TUNE_CACHE_BUDGET = 1024;
+
     constexpr double MIN_FILTER_CURVE = 0.0;
     constexpr double MAX_FILTER_CURVE = 1.0;
 
@@ -170,6 +179,7 @@ void FramePrefs::FillPropertyGrid()
         }
 
         AddWrappedPropToPage(Settings::AppSettings::ID::LowLatency, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_LOW_LATENCY), *page, Effective::Immediately, Strings::Preferences::DESC_LOW_LATENCY);
+        AddWrappedPropToPage(Settings::AppSettings::ID::DecoupledRenderDepth, TypeSerialized::Int, new wxIntProperty(Strings::Preferences::OPT_DECOUPLED_RENDER_DEPTH), *page, Effective::Immediately, Strings::Preferences::DESC_DECOUPLED_RENDER_DEPTH, MIN_DECOUPLED_RENDER_DEPTH, MAX_DECOUPLED_RENDER_DEPTH);
 
         // Out channels
         {
@@ -258,7 +268,9 @@ void FramePrefs::FillPropertyGrid()
     page->Append(new wxPropertyCategory(Strings::Preferences::CATEGORY_PLAYBACK_BEHAVIOR));
     {
         AddWrappedPropToPage(Settings::AppSettings::ID::PreRenderEnabled, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_PRERENDER), *page, Effective::Immediately, Strings::Preferences::DESC_PRERENDER);
+        AddWrappedPropToPage(Settings::AppSettings::ID::PreRenderCacheSize, TypeSerialized::Int, new wxIntProperty(Strings::Preferences::OPT_PRERENDER_CACHE_SIZE), *page, Effective::Immediately, Strings::Preferences::DESC_PRERENDER_CACHE_SIZE, MIN_PRERENDER_CACHE_SIZE, MAX_PRERENDER_CACHE_SIZE);
         AddWrappedPropToPage(Settings::AppSettings::ID::AutoPlay, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_AUTOPLAY), *page, Effective::Immediately, Strings::Preferences::DESC_AUTOPLAY);
+        AddWrappedPropToPage(Settings::AppSettings::ID::PreloadNextSong, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_PRELOAD_NEXT_SONG), *page, Effective::Immediately, Strings::Preferences::DESC_PRELOAD_NEXT_SONG);
 
         AddWrappedPropToPage(Settings::AppSettings::ID::RepeatModeDefaultSubsong, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_START_DEFAULT_SUBSONG), *page, Effective::Immediately, Strings::Preferences::DESC_START_DEFAULT_SUBSONG);
         AddWrappedPropToPage(Settings::AppSettings::ID::RepeatModeIncludeSubsongs, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_INCLUDE_SUBSONGS), *page, Effective::Immediately, Strings::Preferences::DESC_INCLUDE_SUBSONGS);
@@ -336,12 +348,15 @@ void FramePrefs::FillPropertyGrid()
         }
 
         AddWrappedPropToPage(Settings::AppSettings::ID::SonglengthsTrim, TypeSerialized::Int, new wxIntProperty(Strings::Preferences::OPT_SONGLENGTHS_TRIM), *page, Effective::Immediately, Strings::Preferences::DESC_SONGLENGTHS_TRIM, MIN_SONGLENGTHS_TRIM, MAX_SONGLENGTHS_TRIM);
+        AddWrappedPropToPage(Settings::AppSettings::ID::SonglengthsEstimate, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_SONGLENGTHS_ESTIMATE), *page, Effective::Immediately, Strings::Preferences::DESC_SONGLENGTHS_ESTIMATE);
 
         {
             wxFileProperty* filePropertyHandler = new wxFileProperty(Strings::Preferences::OPT_STIL_PATH);
             filePropertyHandler->SetAttribute(wxPG_FILE_WILDCARD, wxString::Format("%s|STIL.txt", Strings::Preferences::WILDCARD_DESC_STIL_TXT));
             AddWrappedPropToPage(Settings::AppSettings::ID::StilPath, TypeSerialized::String, filePropertyHandler, *page, Effective::Immediately, Strings::Preferences::DESC_STIL_PATH);
         }
+
+        AddWrappedPropToPage(Settings::AppSettings::ID::StilPreload, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_STIL_PRELOAD), *page, Effective::Immediately, Strings::Preferences::DESC_STIL_PRELOAD);
     }
 
     // Emulation
@@ -424,6 +439,7 @@ void FramePrefs::FillPropertyGrid()
     page->Append(new wxPropertyCategory(Strings::Preferences::CATEGORY_APPLICATION));
     {
         AddWrappedPropToPage(Settings::AppSettings::ID::RememberPlaylist, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_REMEMBER_PLAYLIST), *page, Effective::Immediately, Strings::Preferences::DESC_REMEMBER_PLAYLIST);
+        AddWrappedPropToPage(Settings::AppSettings::ID::TuneCacheBudget, TypeSerialized::Int, new wxIntProperty(Strings::Preferences::OPT_TUNE_CACHE_BUDGET), *page, Effective::Immediately, Strings::Preferences::DESC_TUNE_CACHE_BUDGET, MIN_TUNE_CACHE_BUDGET, MAX_TUNE_CACHE_BUDGET);
 #ifdef WIN32
         AddWrappedPropToPage(Settings::AppSettings::ID::MediaKeys, TypeSerialized::Int, new wxBoolProperty(Strings::Preferences::OPT_MEDIA_KEYS), *page, Effective::Immediately, Strings::Preferences::DESC_MEDIA_KEYS);
 #endif
@@ -552,6 +568,10 @@ void FramePrefs::OnButtonApply(wxCommandEvent& /*evt*/)
                     {
                         _framePlayer.ForceStopPlayback({});
                     }
+                    else if (prop.first == Settings::AppSettings::ID::PreRenderCacheSize)
+                    {
+                        _app.RefreshPreRenderDiskCache();
+                    }
                     else if (prop.first == Settings::AppSettings::ID::OutChannels || prop.first == Settings::AppSettings::ID::VirtualStereoMultiSid)
                     {
                         ImmediatelyRefreshChannelMatrix();
@@ -568,6 +588,17 @@ void FramePrefs::OnButtonApply(wxCommandEvent& /*evt*/)
                     {
                         _framePlayer.UpdateIgnoredSongs({});
                     }
+                    else if (prop.first == Settings::AppSettings::ID::StilPreload)
+                    {
+                        _framePlayer.InitStilInfo({});
+                    }
+                    else if (prop.first == Settings::AppSettings::ID::SonglengthsEstimate)
+                    {
+                        if (propertyValueInt == 0)
+                        {
+                            _framePlayer.StopSonglengthEstimation({});
+                        }
+                    }
                     else if (prop.first == Settings::AppSettings::ID::TaskbarProgress)
                     {
                         const int opt = _app.currentSettings->GetOption(Settings::AppSettings::ID::TaskbarProgress)->GetValueAsInt();
@@ -578,10 +609,21 @@ void FramePrefs::OnButtonApply(wxCommandEvent& /*evt*/)
                         if (propertyValueInt == 0)
                         {
                             Helpers::Wx::Files::TrySavePlaylist(Helpers::Wx::Files::DEFAULT_PLAYLIST_NAME, {}); // Immediately delete the default playlist file if it exists.
+
+                            const wxString metadataCachePath = Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_PLAYLIST_METADATA_CACHE_NAME);
+                            if (wxFileExists(metadataCachePath))
+                            {
+                                wxRemoveFile(metadataCachePath);
+                            }
+
                             _app.currentSettings->GetOption(Settings::AppSettings::ID::LastSongPosition)->UpdateValue(0);
                             _app.currentSettings->GetOption(Settings::AppSettings::ID::LastSubsongIndex)->UpdateValue(0);
                         }
                     }
+                    else if (prop.first == Settings::AppSettings::ID::TuneCacheBudget)
+                    {
+                        Helpers::Wx::Files::SetTuneCacheBudget(static_cast<size_t>(propertyValueInt) * 1024 * 1024);
+                    }
                     else if (prop.first == Settings::AppSettings::ID::RestoreDefaults)
                     {
                         restoreDefaults = propertyValueInt == 1;
@@ -677,6 +719,7 @@ void FramePrefs::OnButtonApply(wxCommandEvent& /*evt*/)
             if (success)
             {
                 _app.currentSettings->TrySave();
+                _framePlayer.RestartSonglengthEstimation({}); // The emulation settings or the ROMs may have changed.
             }
 
             if (requiresAppRestart)
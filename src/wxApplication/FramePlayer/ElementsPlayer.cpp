@@ -145,6 +145,7 @@ namespace FrameElements // Player class
 				wxMenu* playlistSubMenu = new wxMenu();
 				playlistSubMenu->Append(static_cast<int>(MenuItemId_Player::PlaylistOpen), Strings::FramePlayer::MENU_ITEM_PLAYLIST_OPEN);
 				playlistSubMenu->Append(static_cast<int>(MenuItemId_Player::PlaylistSave), Strings::FramePlayer::MENU_ITEM_PLAYLIST_SAVE);
+				playlistSubMenu->Append(static_cast<int>(MenuItemId_Player::PlaylistExportWav), Strings::FramePlayer::MENU_ITEM_PLAYLIST_EXPORT_WAV);
 				playlistSubMenu->AppendSeparator();
 				playlistSubMenu->Append(static_cast<int>(MenuItemId_Player::PlaylistShuffle), wxString::Format("%s\tCtrl+R", Strings::FramePlayer::MENU_ITEM_PLAYLIST_SHUFFLE));
 				playlistSubMenu->Append(static_cast<int>(MenuItemId_Player::PlaylistClear), Strings::FramePlayer::MENU_ITEM_PLAYLIST_CLEAR);
@@ -0,0 +1,80 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "FileDiscovery.h"
+#include "../Helpers/HelpersWx.h"
+
+FileDiscovery::FileDiscovery(const wxArrayString& rawPaths, PlaylistIngest& ingest) :
+	_rawPaths(rawPaths),
+	_ingest(ingest)
+{
+	_thread = std::thread(&FileDiscovery::Run, this);
+}
+
+FileDiscovery::~FileDiscovery()
+{
+	Cancel();
+}
+
+bool FileDiscovery::IsDone() const
+{
+	return _done;
+}
+
+void FileDiscovery::Cancel()
+{
+	_cancel = true;
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+}
+
+size_t FileDiscovery::GetDiscoveredCount() const
+{
+	return _discoveredCount;
+}
+
+wxString FileDiscovery::GetCurrentFolder() const
+{
+	std::lock_guard<std::mutex> lock(_currentFolderMutex);
+	return _currentFolder;
+}
+
+void FileDiscovery::Run()
+{
+	Helpers::Wx::Files::DiscoverValidFiles(_rawPaths, [this](const wxArrayString& batch, const wxString& currentFolder)
+	{
+		if (_cancel)
+		{
+			return false;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_currentFolderMutex);
+			_currentFolder = currentFolder;
+		}
+
+		_ingest.AddFiles(batch);
+		_discoveredCount += batch.GetCount();
+		return true;
+	});
+
+	_ingest.FinishAdding();
+	_done = true;
+}
@@ -0,0 +1,68 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include "PlaylistIngest.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/// @brief Walks the dropped/opened files and folders on a worker thread (see the Helpers::Wx::Files::DiscoverValidFiles), streaming the found files to the ingest as it goes, so that large trees start appearing in the playlist almost immediately.
+class FileDiscovery
+{
+public:
+	FileDiscovery() = delete;
+	FileDiscovery(FileDiscovery&) = delete;
+
+	/// @brief Starts immediately. The ingest must outlive this object (the FinishAdding is called on it once the walk is over, even if cancelled).
+	FileDiscovery(const wxArrayString& rawPaths, PlaylistIngest& ingest);
+	~FileDiscovery();
+
+public:
+	bool IsDone() const;
+
+	/// @brief Stops the walk as soon as possible. Called automatically on destruction.
+	void Cancel();
+
+	size_t GetDiscoveredCount() const;
+
+	/// @brief The folder being walked at the moment (empty if none).
+	wxString GetCurrentFolder() const;
+
+private:
+	void Run();
+
+private:
+	const wxArrayString _rawPaths;
+	PlaylistIngest& _ingest;
+
+	std::thread _thread;
+	std::atomic_bool _cancel = false;
+	std::atomic_bool _done = false;
+	std::atomic_size_t _discoveredCount = 0;
+
+	mutable std::mutex _currentFolderMutex;
+	wxString _currentFolder;
+};
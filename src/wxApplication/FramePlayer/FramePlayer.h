@@ -24,9 +24,11 @@
 #endif
 
 #include "ElementsPlayer.h"
+#include "TuneMetadataCache.h"
 #include "../Theme/ThemeManager.h"
 #include "../../HvscSupport/Songlengths.h"
 #include "../../HvscSupport/Stil/Stil.h"
+#include "../../PlaybackController/SonglengthEstimator/SonglengthEstimator.h"
 #include "../../Util/SimpleSignal/SimpleSignalListener.h"
 
 class FramePlaybackMods;
@@ -136,9 +138,11 @@ public:
     std::vector<wxString> GetCurrentPlaylistFilePaths(bool includeBlacklistedSongs);
     void DiscoverFilesAndSendToPlaylist(const wxArrayString& rawPaths, bool clearPrevious = true, bool autoPlayFirstImmediately = true);
     void UpdateIgnoredSongs(PassKey<FramePrefs>);
+    void StopSonglengthEstimation(PassKey<FramePrefs>);
+    void RestartSonglengthEstimation(PassKey<FramePrefs>);
 
 private:
-    void SendFilesToPlaylist(const wxArrayString& files, bool clearPrevious = true, bool autoPlayFirstImmediately = true);
+    void SendFilesToPlaylist(const wxArrayString& rawPaths, bool clearPrevious = true, bool autoPlayFirstImmediately = true);
     void PadColumnsWidth();
     void UpdateIgnoredSongs();
     void UpdateIgnoredSong(PlaylistTreeModelNode& mainSongNode);
@@ -146,6 +150,20 @@ private:
 
     Songlengths::HvscInfo TryGetHvscInfo(const char* md5, int subsong = 1) const;
 
+    /// @brief Queues a tune which isn't in the Songlengths database for the background song-length estimation.
+    void EnqueueSonglengthEstimation(const wxString& filepath, const std::string& tuneMd5, int totalSubsongs);
+
+    /// @brief Creates the estimator on demand (with the current playback settings).
+    SonglengthEstimator& GetSonglengthEstimator();
+
+    /// @brief Recreates the estimator with the current playback settings (e.g., after they changed), requeueing its unfinished tunes.
+    void RestartSonglengthEstimation();
+
+    /// @brief Stores the finished estimates and applies them to the playlist (deferred while the files are being added, as the ingest reads the estimated database).
+    void ApplyEstimatedSonglengths();
+    void FlushEstimatedSonglengths();
+    void StopSonglengthEstimation();
+
 #pragma endregion
 #pragma region *** input ***
 
@@ -155,12 +173,30 @@ private:
     void OpenNewPlaylist(bool autoPlayFirstImmediately);
     bool TrySaveCurrentPlaylist();
 
+    /// @brief Renders the playlist's songs (each subsong separately) to WAV files in a user-chosen folder, with the current playback settings.
+    void ExportPlaylistToWav();
+
 #pragma endregion
 #pragma region *** transport ***
 
 private:
+    struct PlaybackTarget
+    {
+        const PlaylistTreeModelNode* node = nullptr; // The effective subsong node if a main song with subsongs was activated.
+        wxString filepath;
+        wxString musCompanionStrFilePath;
+        int subsong = 0;
+        int preRenderDurationMs = 0;
+    };
+
+    /// @brief Determines what the playlist item activation would actually play. Returns false if nothing is playable.
+    bool TryResolvePlaybackTarget(const PlaylistTreeModelNode& activatedNode, PlaybackTarget& outTarget) const;
+
     bool TryPlayPlaylistItem(const PlaylistTreeModelNode& activatedNode);
 
+    /// @brief Loads the song which the repeat mode would play next (when the current one ends) in the background, if enabled in the settings.
+    void PrepareNextPlaylistItem();
+
     bool TryPlayNextValidSong();
     bool TryPlayPrevValidSong();
     bool TryPlayNextValidSubsong();
@@ -224,6 +260,7 @@ private:
     PlaylistTreeModelNode* DoFindSong(const wxString& query, const PlaylistTreeModelNode& startNode, bool forwardDirection, bool restart);
     void OnFindSong(UIElements::SignalsSearchBar signalId);
     void DoRemoveSongTreeItem(PlaylistTreeModelNode* node);
+    void DoRemoveSongTreeItems(const std::vector<PlaylistTreeModelNode*>& songs);
     void DoRemoveAllSongTreeItemsAbove(PlaylistTreeModelNode& node);
     void DoRemoveAllSongTreeItemsBelow(PlaylistTreeModelNode& node);
     void DoToggleSubsongBlacklistState(PlaylistTreeModelNode& node);
@@ -239,7 +276,11 @@ private:
 
     ThemeManager _themeManager;
     Songlengths _sidDatabase;
+    Songlengths _estimatedSidDatabase; // Consulted after the _sidDatabase.
+    std::unique_ptr<SonglengthEstimator> _songlengthEstimator; // Created on demand.
+    std::vector<SonglengthEstimator::Result> _pendingEstimates;
     Stil _stilInfo;
+    TuneMetadataCache _tuneMetadataCache;
 
     std::unique_ptr<FrameElements::ElementsPlayer> _ui;
     std::unique_ptr<wxTimer> _timerRefresh;
@@ -115,13 +115,15 @@ void FramePlayer::OnButtonRepeatMode(wxCommandEvent& evt)
 
 void FramePlayer::OnSeekBackward(wxCommandEvent& evt)
 {
-    _app.SeekTo(evt.GetExtraLong());
+    const PlaylistTreeModelNode* activeSong = _ui->treePlaylist->GetActiveSong();
+    _app.SeekTo(evt.GetExtraLong(), (activeSong != nullptr) ? GetEffectiveSongDuration(*activeSong) : 0);
     UpdateUiState();
 }
 
 void FramePlayer::OnSeekForward(wxCommandEvent& evt)
 {
-    _app.SeekTo(evt.GetExtraLong());
+    const PlaylistTreeModelNode* activeSong = _ui->treePlaylist->GetActiveSong();
+    _app.SeekTo(evt.GetExtraLong(), (activeSong != nullptr) ? GetEffectiveSongDuration(*activeSong) : 0);
     UpdateUiState();
 }
 
@@ -420,6 +422,7 @@ void FramePlayer::OnMenuOpening(wxMenuEvent& evt)
     if (menu->GetTitle().IsSameAs(Strings::FramePlayer::MENU_FILE)) // TODO: try to find a better way to detect which menu is opened (e.g., "File" in this case).
     {
         menu->Enable(static_cast<int>(MenuItemId_Player::PlaylistSave), !playlistEmpty);
+        menu->Enable(static_cast<int>(MenuItemId_Player::PlaylistExportWav), !playlistEmpty);
         menu->Enable(static_cast<int>(MenuItemId_Player::PlaylistShuffle), _ui->treePlaylist->GetSongs().size() > 1);
         menu->Enable(static_cast<int>(MenuItemId_Player::PlaylistClear), !playlistEmpty);
     }
@@ -473,6 +476,10 @@ void FramePlayer::OnMenuItemSelected(wxCommandEvent& evt)
             TrySaveCurrentPlaylist();
             break;
 
+        case MenuItemId_Player::PlaylistExportWav:
+            ExportPlaylistToWav();
+            break;
+
         case MenuItemId_Player::PlaylistShuffle:
             _ui->treePlaylist->Shuffle();
             break;
@@ -594,6 +601,8 @@ void FramePlayer::OnGlobalHotkey(wxKeyEvent& evt)
 
 void FramePlayer::OnTimerRefresh(wxTimerEvent& /*evt*/)
 {
+    ApplyEstimatedSonglengths();
+
     const PlaybackController& playbackInfo = _app.GetPlaybackInfo();
     PlaybackController::State cState = playbackInfo.GetState();
 
@@ -876,7 +885,7 @@ PlaylistTreeModelNode* FramePlayer::DoFindSong(const wxString& query, const Play
     const PlaylistTreeModelNodePtrArray& songs = _ui->treePlaylist->GetSongs();
     auto itStart = std::find_if(songs.cbegin(), songs.cend(), [&startNode](const PlaylistTreeModelNodePtr& qNode)
     {
-        return startNode.filepath.IsSameAs(qNode->filepath);
+        return startNode.uid == qNode->uid;
     });
 
     if (itStart == songs.cend())
@@ -884,14 +893,20 @@ PlaylistTreeModelNode* FramePlayer::DoFindSong(const wxString& query, const Play
         return nullptr; // startNode not found (can happen if the playlist is empty/cleared).
     }
 
-    const wxString queryLower = query.Lower();
+    const UIElements::Playlist::PlaylistSearchIndex::Matches& matches = _ui->treePlaylist->FindSongs(query.Lower());
+    if (matches.empty())
+    {
+        return nullptr;
+    }
+
+    const auto IsMatch = [&matches](const PlaylistTreeModelNodePtr& qNode)
+    {
+        return matches.find(qNode->uid) != matches.cend();
+    };
 
     if (forwardDirection)
     {
-        const auto itNextResult = std::find_if(itStart + ((restart) ? 0 : 1), songs.cend(), [&queryLower](const PlaylistTreeModelNodePtr& qNode)
-        {
-            return qNode->title.Lower().Contains(queryLower);
-        });
+        const auto itNextResult = std::find_if(itStart + ((restart) ? 0 : 1), songs.cend(), IsMatch);
 
         if (itNextResult == songs.cend())
         {
@@ -902,10 +917,7 @@ PlaylistTreeModelNode* FramePlayer::DoFindSong(const wxString& query, const Play
     }
     else
     {
-        const auto itPrevResult = std::find_if(std::reverse_iterator(itStart) - ((restart) ? 1 : 0), songs.rend(), [&queryLower](const PlaylistTreeModelNodePtr& qNode)
-        {
-            return qNode->title.Lower().Contains(queryLower);
-        });
+        const auto itPrevResult = std::find_if(std::reverse_iterator(itStart) - ((restart) ? 1 : 0), songs.rend(), IsMatch);
 
         if (itPrevResult == songs.rend())
         {
@@ -929,10 +941,22 @@ void FramePlayer::DoRemoveSongTreeItem(PlaylistTreeModelNode* node)
     UpdateUiState(); // To refresh the Next/Prev buttons.
 }
 
-void FramePlayer::DoRemoveAllSongTreeItemsAbove(PlaylistTreeModelNode& node)
+void FramePlayer::DoRemoveSongTreeItems(const std::vector<PlaylistTreeModelNode*>& songs)
 {
-    const PlaylistTreeModelNode* activeSong = _ui->treePlaylist->GetActiveSong();
+    if (PlaylistTreeModelNode* const activeSong = _ui->treePlaylist->GetActiveSong())
+    {
+        const PlaylistTreeModelNode* const activeMainSong = (activeSong->type == PlaylistTreeModelNode::ItemType::Subsong) ? activeSong->GetParent() : activeSong;
+        if (std::find(songs.cbegin(), songs.cend(), activeMainSong) != songs.cend())
+        {
+            _app.UnloadActiveTune();
+        }
+    }
 
+    _ui->treePlaylist->RemoveMany(songs); // "songs" are now invalid (but not nullptr)!
+}
+
+void FramePlayer::DoRemoveAllSongTreeItemsAbove(PlaylistTreeModelNode& node)
+{
     // Remove songs above
     {
         // Enumerate songs to remove up to the selected song
@@ -948,16 +972,7 @@ void FramePlayer::DoRemoveAllSongTreeItemsAbove(PlaylistTreeModelNode& node)
         }
 
         // Remove songs
-        for (PlaylistTreeModelNode* const cSong : removeSongs)
-        {
-            if (activeSong != nullptr && activeSong->filepath == cSong->filepath)
-            {
-                _app.UnloadActiveTune();
-                activeSong = nullptr;
-            }
-
-            _ui->treePlaylist->Remove(cSong);
-        }
+        DoRemoveSongTreeItems(removeSongs);
     }
 
     _ui->treePlaylist->EnsureVisible(node);
@@ -968,8 +983,6 @@ void FramePlayer::DoRemoveAllSongTreeItemsAbove(PlaylistTreeModelNode& node)
 
 void FramePlayer::DoRemoveAllSongTreeItemsBelow(PlaylistTreeModelNode& node)
 {
-    const PlaylistTreeModelNode* activeSong = _ui->treePlaylist->GetActiveSong();
-
     // Remove songs below
     {
         // Enumerate songs to remove after the selected song
@@ -988,16 +1001,7 @@ void FramePlayer::DoRemoveAllSongTreeItemsBelow(PlaylistTreeModelNode& node)
         }
 
         // Remove songs
-        for (PlaylistTreeModelNode* const cSong : removeSongs)
-        {
-            if (activeSong != nullptr && activeSong->filepath == cSong->filepath)
-            {
-                _app.UnloadActiveTune();
-                activeSong = nullptr;
-            }
-
-            _ui->treePlaylist->Remove(cSong);
-        }
+        DoRemoveSongTreeItems(removeSongs);
     }
 
     _ui->treePlaylist->EnsureVisible(node);
@@ -1029,7 +1033,7 @@ void FramePlayer::OnFindSong(UIElements::SignalsSearchBar signalId)
     const char* COLOR_MISS = "#FFCCCB";
 
     const wxString& query = _ui->searchBar->GetQuery();
-    if (query.IsEmpty())
+    if (query.IsEmpty() || _ui->treePlaylist->IsEmpty())
     {
         return;
     }
@@ -1046,10 +1050,11 @@ void FramePlayer::OnFindSong(UIElements::SignalsSearchBar signalId)
         }
     }
 
-    // Find next/prev
+    // Find next/prev (while typing, the current song is kept as long as it still matches)
     const bool forwardDirection = signalId != UIElements::SignalsSearchBar::SIGNAL_FIND_PREV;
+    const bool includeCurrent = signalId == UIElements::SignalsSearchBar::SIGNAL_QUERY_CHANGED;
     bool wrapAround = false;
-    const PlaylistTreeModelNode* targetItem = (nodeCurrent == nullptr) ? nullptr : DoFindSong(query, *nodeCurrent, forwardDirection, false);
+    const PlaylistTreeModelNode* targetItem = (nodeCurrent == nullptr) ? nullptr : DoFindSong(query, *nodeCurrent, forwardDirection, includeCurrent);
 
     if (targetItem == nullptr) // Next/prev result not found, try to wrap around
     {
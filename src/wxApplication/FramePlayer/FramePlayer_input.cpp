@@ -19,7 +19,11 @@
 #include "FramePlayer.h"
 #include "../Config/UIStrings.h"
 #include "../Helpers/HelpersWx.h"
+#include "../../PlaybackController/OfflineRender/OfflineRender.h"
 #include <wx/filedlg.h>
+#include <wx/progdlg.h>
+#include <set>
+#include <thread>
 
 static const wxString WILDCARD_SID = "*.sid;*.str;*.mus";
 static const wxString WILDCARD_ZIP = wxString::Format("*%s", Helpers::Wx::Files::FILE_EXTENSION_ZIP);
@@ -98,4 +102,97 @@ bool FramePlayer::TrySaveCurrentPlaylist()
     const wxString& playlistSavePath = saveFileDialog.GetPath();
     const std::vector<wxString>& filePaths = GetCurrentPlaylistFilePaths(false);
     return Helpers::Wx::Files::TrySavePlaylist(playlistSavePath, filePaths);
-}
\ No newline at end of file
+}
+
+void FramePlayer::ExportPlaylistToWav()
+{
+    wxDirDialog dirDialog(this, Strings::FramePlayer::EXPORT_WAV_CHOOSE_FOLDER);
+    if (dirDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    const wxString outFolder = dirDialog.GetPath();
+
+    // Jobs (same songs & durations as the playback would use)
+    std::vector<OfflineRender::Job> jobs;
+    std::set<wxString> usedNames;
+    const auto addJob = [this, &jobs, &usedNames, &outFolder](const PlaylistTreeModelNode& node, unsigned int subsong, int nameSubsong)
+    {
+        OfflineRender::Job job;
+        job.tuneFileName = wxFileName(node.filepath).GetFullName().ToStdWstring();
+        job.loadTune = [filepath = node.filepath, musCompanionStrFilePath = node.musCompanionStrFilePath]()
+        {
+            return Helpers::Wx::Files::GetTuneContent(filepath, musCompanionStrFilePath); // On the render worker (under the progress dialog).
+        };
+
+        job.subsong = subsong;
+        job.durationMs = static_cast<uint_least32_t>(GetEffectiveSongDuration(node));
+        job.outputPath = Helpers::Wx::Files::MakeUniqueOutputPath(outFolder, node.filepath, nameSubsong, "wav", usedNames).ToStdWstring();
+        jobs.emplace_back(std::move(job));
+    };
+
+    const auto isExportable = [](const PlaylistTreeModelNode& node)
+    {
+        return node.IsPlayable() && node.GetTag() != PlaylistTreeModelNode::ItemTag::Blacklisted;
+    };
+
+    for (const PlaylistTreeModelNodePtr& song : _ui->treePlaylist->GetSongs())
+    {
+        if (!isExportable(*song))
+        {
+            continue;
+        }
+
+        const bool musStrPair = !song->musCompanionStrFilePath.IsEmpty(); // Its subsongs are fake (the individual MUS+STR components), so render the pair only.
+        if (musStrPair || song->GetSubsongCount() == 0)
+        {
+            addJob(*song, (musStrPair) ? 0 : song->defaultSubsong, 0);
+            continue;
+        }
+
+        for (const PlaylistTreeModelNodePtr& subsong : song->GetChildren())
+        {
+            if (isExportable(*subsong))
+            {
+                addJob(*subsong, subsong->defaultSubsong, subsong->defaultSubsong);
+            }
+        }
+    }
+
+    if (jobs.empty())
+    {
+        wxMessageBox(Strings::FramePlayer::EXPORT_WAV_NOTHING, Strings::FramePlayer::WINDOW_TITLE, wxICON_INFORMATION);
+        return;
+    }
+
+    // Render (leaving a core to the playback)
+    const int jobsCount = static_cast<int>(jobs.size());
+    const unsigned int cores = std::thread::hardware_concurrency();
+    OfflineRender render(std::move(jobs), OfflineRender::Settings(_app.GetPlaybackInfo()), (cores > 1) ? cores - 1 : 1);
+
+    {
+        wxProgressDialog progressDialog(Strings::FramePlayer::EXPORT_WAV_PROGRESS_TITLE, wxString::Format(Strings::FramePlayer::EXPORT_WAV_PROGRESS, 0, jobsCount), jobsCount, this, wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME);
+        while (!render.IsDone())
+        {
+            const int finished = static_cast<int>(render.GetFinishedCount());
+            if (!progressDialog.Update(finished, wxString::Format(Strings::FramePlayer::EXPORT_WAV_PROGRESS, finished, jobsCount)))
+            {
+                render.Abort(); // The partially rendered files get deleted.
+                break;
+            }
+
+            wxMilliSleep(100);
+        }
+    }
+
+    render.Wait();
+
+    int exported = 0;
+    for (size_t i = 0; i < render.GetJobsCount(); ++i)
+    {
+        exported += (render.GetJobStatus(i) == OfflineRender::JobStatus::Done) ? 1 : 0;
+    }
+
+    wxMessageBox(wxString::Format(Strings::FramePlayer::EXPORT_WAV_DONE, exported, jobsCount, outFolder), Strings::FramePlayer::WINDOW_TITLE, (exported == jobsCount) ? wxICON_INFORMATION : wxICON_WARNING);
+}
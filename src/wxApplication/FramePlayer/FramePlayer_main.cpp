@@ -88,6 +88,7 @@ FramePlayer::FramePlayer(const wxString& title, const wxPoint& pos, const wxSize
 
     SubscribeMe(*_ui->searchBar, UIElements::SignalsSearchBar::SIGNAL_FIND_NEXT, std::bind(&OnFindSong, this, UIElements::SignalsSearchBar::SIGNAL_FIND_NEXT));
     SubscribeMe(*_ui->searchBar, UIElements::SignalsSearchBar::SIGNAL_FIND_PREV, std::bind(&OnFindSong, this, UIElements::SignalsSearchBar::SIGNAL_FIND_PREV));
+    SubscribeMe(*_ui->searchBar, UIElements::SignalsSearchBar::SIGNAL_QUERY_CHANGED, std::bind(&OnFindSong, this, UIElements::SignalsSearchBar::SIGNAL_QUERY_CHANGED));
 
     // Final
     UpdateUiState();
@@ -200,6 +201,9 @@ void FramePlayer::InitSonglengthsDatabase()
         wxMessageBox(exceptionMessage, Strings::FramePlayer::WINDOW_TITLE, wxICON_EXCLAMATION);
         _app.currentSettings->GetOption(Settings::AppSettings::ID::SonglengthsPath)->UpdateValue(""); // Reminder: leave this even if resettable in Prefs.
     }
+
+    // Song lengths estimated earlier for the tunes missing from the above (the file doesn't exist until the first estimate is done)
+    _estimatedSidDatabase.TryLoad(Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_ESTIMATED_SONGLENGTHS_NAME).ToStdWstring());
 }
 
 void FramePlayer::InitStilInfo()
@@ -253,6 +257,11 @@ void FramePlayer::InitStilInfo()
         }
     }
 
+    if (success && _app.currentSettings->GetOption(Settings::AppSettings::ID::StilPreload)->GetValueAsBool())
+    {
+        _stilInfo.PreloadAsync();
+    }
+
     if (!exceptionMessage.IsEmpty())
     {
         if (success)
@@ -453,6 +462,7 @@ void FramePlayer::DeferredInit()
         if (wxFileExists(playlistPath))
         {
             // Load default playlist from file
+            _tuneMetadataCache.TryLoad(Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_PLAYLIST_METADATA_CACHE_NAME)); // Lets the unchanged tunes skip the re-scanning.
             const wxArrayString& playlistFiles = Helpers::Wx::Files::LoadPathsFromPlaylist(playlistPath);
             DiscoverFilesAndSendToPlaylist(playlistFiles, true, false); // Reminder: this line can take a long time but is asynchronous and the program can be used before the next line is reached.
 
@@ -534,6 +544,8 @@ void FramePlayer::CloseApplication()
         _timerRefresh->Stop(); // Segfault can occur otherwise.
     }
 
+    StopSonglengthEstimation();
+
     _app.StopPlayback();
     Hide();
 
@@ -558,6 +570,9 @@ void FramePlayer::CloseApplication()
         const std::vector<wxString>& fileList = GetCurrentPlaylistFilePaths(false);
         Helpers::Wx::Files::TrySavePlaylist(Helpers::Wx::Files::DEFAULT_PLAYLIST_NAME, fileList);
 
+        _tuneMetadataCache.RetainOnly(fileList);
+        _tuneMetadataCache.TrySave(Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_PLAYLIST_METADATA_CACHE_NAME));
+
         // Store the last played song & subsong as an internal option...
         PlaylistTreeModelNode* const node = _ui->treePlaylist->GetActiveSong();
         const int cSongPosition = (node == nullptr) ? 0 : _ui->treePlaylist->GetMainSongPlaylistPosition(*node);
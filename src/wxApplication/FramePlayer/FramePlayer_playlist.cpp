@@ -18,6 +18,8 @@
 
 #include "FramePlayer.h"
 #include "ElementsPlayer.h"
+#include "FileDiscovery.h"
+#include "PlaylistIngest.h"
 #include "../MyApp.h"
 #include "../Config/AppSettings.h"
 #include "../Config/UIStrings.h"
@@ -26,6 +28,8 @@
 #include "../../Util/Const.h"
 #include "../../PlaybackController/PlaybackWrappers/Input/SidDecoder/TuneUtil.h"
 
+#include <map>
+
 namespace
 {
     /// @brief └
@@ -33,6 +37,9 @@ namespace
 
     /// @brief ├
     constexpr int BOX_CHAR_VERT_RIGHT = 0x251C;
+
+    /// @brief How long to wait for the ingest workers before yielding to the UI.
+    constexpr int INGEST_WAIT_MS = 50;
 }
 
 std::vector<wxString> FramePlayer::GetCurrentPlaylistFilePaths(bool includeBlacklistedSongs)
@@ -62,276 +69,240 @@ void FramePlayer::DiscoverFilesAndSendToPlaylist(const wxArrayString& rawPaths,
         return;
     }
 
-    wxBeginBusyCursor();
-    SetStatusText(Strings::FramePlayer::STATUS_DISCOVERING_FILES, 2); // TODO
-
-    const wxArrayString& validFileList = Helpers::Wx::Files::GetValidFiles(rawPaths);
-    if (!validFileList.IsEmpty())
+    if (_addingFilesToPlaylist)
     {
-        if (_addingFilesToPlaylist)
-        {
-            _enqueuedFiles.reserve(_enqueuedFiles.GetCount() + validFileList.GetCount());
-            for (auto& item : validFileList)
-            {
-                _enqueuedFiles.Add(item);
-            }
-        }
-        else
+        _enqueuedFiles.reserve(_enqueuedFiles.GetCount() + rawPaths.GetCount());
+        for (auto& item : rawPaths)
         {
-            SendFilesToPlaylist(validFileList, clearPrevious, autoPlayFirstImmediately);
+            _enqueuedFiles.Add(item); // Discovered once the current batch is done.
         }
     }
+    else
+    {
+        SetStatusText(Strings::FramePlayer::STATUS_DISCOVERING_FILES, 2); // TODO
+        SendFilesToPlaylist(rawPaths, clearPrevious, autoPlayFirstImmediately);
+    }
 
     UpdateUiState();
-    wxEndBusyCursor();
-    SetCursor(*wxSTANDARD_CURSOR); // Workaround the wx issue where the busy cursor doesn't properly update until the mouse is moved.
 }
 
-void FramePlayer::SendFilesToPlaylist(const wxArrayString& files, bool clearPrevious, bool autoPlayFirstImmediately)
+void FramePlayer::SendFilesToPlaylist(const wxArrayString& rawPaths, bool clearPrevious, bool autoPlayFirstImmediately)
 {
     //wxWindowDisabler disabler;
     //wxBusyCursor busyCursor;
 
     _addingFilesToPlaylist = true;
 
-    if (clearPrevious)
-    {
-        _app.StopPlayback();
-        _app.UnloadActiveTune();
-
-        SetStatusText(Strings::FramePlayer::STATUS_CLEARING_PLAYLIST, 2); // TODO
-        _ui->treePlaylist->Clear();
-
-        UpdateUiState();
-        Update();
-    }
+    bool pendingClear = clearPrevious; // Deferred until something valid is actually discovered (so that e.g., dropping a bogus path doesn't wipe the playlist).
 
     const bool enabledShortSongSkip = _app.currentSettings->GetOption(Settings::AppSettings::ID::SkipShorter)->GetValueAsInt() > 0;
+    const bool enabledSonglengthEstimation = _app.currentSettings->GetOption(Settings::AppSettings::ID::SonglengthsEstimate)->GetValueAsBool();
     bool shouldAutoPlay = (autoPlayFirstImmediately) ? _app.currentSettings->GetOption(Settings::AppSettings::ID::AutoPlay)->GetValueAsBool() : false;
 
     int processedFilesCount = 0;
     int lastPercentage = -1;
-    bool tuneIsValid = false;
 
     int playableTunesCount = 0; // Not important if it rolls over.
     const PlaybackController& playback = _app.GetPlaybackInfo();
 
     uint8_t throttledYieldCounter = 0;
 
-    for (const wxString& filepath : files)
-    {
-        ++processedFilesCount;
-
-        if (!_ui->treePlaylist->IsEmpty())
-        {
-            const wxString& lastMainSongmusCompanionStrFilePath = _ui->treePlaylist->GetSongs().at(_ui->treePlaylist->GetSongs().size() - 1)->musCompanionStrFilePath;
-            if (!lastMainSongmusCompanionStrFilePath.IsEmpty() && wxFileName(filepath).GetFullPath().IsSameAs(lastMainSongmusCompanionStrFilePath, false))
-            {
-                continue; // Skip the duplicate STR file (MUS+STR already loaded in pair).
-            }
-        }
+    PlaylistIngest ingest(_sidDatabase, &_tuneMetadataCache, &_estimatedSidDatabase); // Tunes are inspected on the worker threads, we only insert the results here (in the original order).
+    FileDiscovery discovery(rawPaths, ingest); // Feeds the ingest while the folders are still being walked. Reminder: must be destroyed before the ingest (hence declared after it).
 
-        const int totalFiles = files.GetCount() + _enqueuedFiles.GetCount();
-        const float totalFilesFloat = static_cast<float>(totalFiles);
+    while (!ingest.IsDone())
+    {
+        std::vector<PlaylistIngest::TuneDescriptorPtr> readyTunes = ingest.TakeReady(std::chrono::milliseconds(INGEST_WAIT_MS));
 
-        // Progress percentage display ------------------------
-        const int currentPercentage = static_cast<int>((processedFilesCount / totalFilesFloat) * 100.0f);
-        if (currentPercentage != lastPercentage) // SetStatusText calls are expensive.
+        if (pendingClear && ingest.GetFileCount() > 0)
         {
-            const wxString textAddingFilesWithCount = wxString::Format(Strings::FramePlayer::STATUS_ADDING_FILES_WITH_COUNT, totalFiles);
-            SetStatusText(wxString::Format("%s (%i%%)", textAddingFilesWithCount, currentPercentage), 2);
-        }
-        lastPercentage = currentPercentage;
+            pendingClear = false;
 
-        // Inspect the tune  -------
-        std::unique_ptr<SidTune> inspectTune = nullptr;
+            _app.StopPlayback();
+            _app.UnloadActiveTune();
 
-        {
-            const std::unique_ptr<BufferHolder>& infoTuneBufferHolder = (Helpers::Wx::Files::IsWithinZipFile(filepath))
-                    ? Helpers::Wx::Files::GetFileContentFromZip(filepath)
-                    : Helpers::Wx::Files::GetFileContentFromDisk(filepath);
+            SetStatusText(Strings::FramePlayer::STATUS_CLEARING_PLAYLIST, 2); // TODO
+            _ui->treePlaylist->Clear();
 
-            inspectTune = (infoTuneBufferHolder != nullptr) ? std::make_unique<SidTune>(infoTuneBufferHolder->buffer[0], infoTuneBufferHolder->size[0]) : nullptr;
-            tuneIsValid = inspectTune != nullptr && inspectTune->getStatus();
+            UpdateUiState();
+            Update();
         }
 
-        if (tuneIsValid)
+        if (readyTunes.empty())
         {
-            // Tune title
-            wxString songTitle(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Title));
+            if (!discovery.IsDone())
             {
-                if (songTitle.IsEmpty()) [[unlikely]] // Fallback/MUS file (rare situation)
-                {
-                    songTitle = wxFileNameFromPath(filepath);
-                }
-
-                const int sidsNeeded = inspectTune->getInfo()->sidChips();
-                const wxString& songTitleAddendum = (sidsNeeded > 1) ? wxString::Format(" [%iSID]", sidsNeeded) : wxGetEmptyString();
-                songTitle.Append(songTitleAddendum);
+                SetStatusText(wxString::Format(Strings::FramePlayer::STATUS_DISCOVERING_FILES_IN_FOLDER, static_cast<int>(discovery.GetDiscoveredCount()), discovery.GetCurrentFolder()), 2);
             }
 
-            // Subsongs count
-            const int defaultSubsong = inspectTune->getInfo()->startSong();
-            int totalSubsongs = inspectTune->getInfo()->songs();
+            wxYield(); // Keep the UI responsive while the workers are busy (e.g., with a slow drive).
+            if (_exitingApplication || !_addingFilesToPlaylist)
+            {
+                return;
+            }
 
-            // Tune ROM requirement
-            const TuneUtil::RomRequirement romRequirement = TuneUtil::GetTuneRomRequirement(*inspectTune);
-            const bool playable = playback.IsRomLoaded(romRequirement);
+            continue;
+        }
 
-            // Add main song node to playlist tree
-            PlaylistTreeModelNode* mainSongNodeNew = nullptr;
+        for (const PlaylistIngest::TuneDescriptorPtr& tune : readyTunes)
+        {
+            ++processedFilesCount;
 
-            const Songlengths::HvscInfo& hvscInfoMain = TryGetHvscInfo(inspectTune->createMD5New());
+            const wxString& filepath = tune->filepath;
 
+            if (!_ui->treePlaylist->IsEmpty())
             {
-                const wxString author = Helpers::Wx::StringFromWin1252(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Author));
-                const wxString copyright = Helpers::Wx::StringFromWin1252(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Released));
-
-                // Determine ROM requirement
-                PlaylistTreeModelNode::RomRequirement nodeRom = PlaylistTreeModelNode::RomRequirement::None;
-                switch (romRequirement)
+                const wxString& lastMainSongmusCompanionStrFilePath = _ui->treePlaylist->GetSongs().at(_ui->treePlaylist->GetSongs().size() - 1)->musCompanionStrFilePath;
+                if (!lastMainSongmusCompanionStrFilePath.IsEmpty() && wxFileName(filepath).GetFullPath().IsSameAs(lastMainSongmusCompanionStrFilePath, false))
                 {
-                    case TuneUtil::RomRequirement::None:
-                        nodeRom = PlaylistTreeModelNode::RomRequirement::None;
-                        break;
-                    case TuneUtil::RomRequirement::BasicRom:
-                        nodeRom = PlaylistTreeModelNode::RomRequirement::BasicRom;
-                        break;
-                    case TuneUtil::RomRequirement::R64:
-                        nodeRom = PlaylistTreeModelNode::RomRequirement::R64;
-                        break;
-                    default:
-                        wxMessageBox(Strings::Internal::UNHANDLED_SWITCH_CASE); // throwing doesn't work properly with release mode wxWidgets
-                        throw(Strings::Internal::UNHANDLED_SWITCH_CASE);
+                    continue; // Skip the duplicate STR file (MUS+STR already loaded in pair).
                 }
+            }
 
-                #pragma region Detect MUS+STR pair
+            const int totalFiles = static_cast<int>(ingest.GetFileCount()) + _enqueuedFiles.GetCount(); // Grows while the discovery is still in progress.
+            const float totalFilesFloat = static_cast<float>(totalFiles);
 
-                wxString musCompanionStrFilePath;
+            // Progress percentage display ------------------------
+            const int currentPercentage = static_cast<int>((processedFilesCount / totalFilesFloat) * 100.0f);
+            if (currentPercentage != lastPercentage) // SetStatusText calls are expensive.
+            {
+                const wxString textAddingFilesWithCount = wxString::Format(Strings::FramePlayer::STATUS_ADDING_FILES_WITH_COUNT, totalFiles);
+                SetStatusText(wxString::Format("%s (%i%%)", textAddingFilesWithCount, currentPercentage), 2);
+            }
+            lastPercentage = currentPercentage;
 
-                const bool musFileType = filepath.Lower().EndsWith(".mus");
-                if (musFileType)
-                {
-                    // Check if the companion STR file exists as well, and load it in pair (MUS+STR)
-                    wxFileName extraStrFilePath(filepath);
-                    extraStrFilePath.SetExt("str");
+            if (tune->valid)
+            {
+                // Tune ROM requirement
+                const bool playable = playback.IsRomLoaded(tune->romRequirement);
 
-                    const bool exists =
-                        (Helpers::Wx::Files::IsWithinZipFile(extraStrFilePath.GetFullPath()) && Helpers::Wx::Files::FileExistsInZipArchive(extraStrFilePath.GetFullPath())) ||
-                        (extraStrFilePath.FileExists());
+                // Add main song node to playlist tree
+                PlaylistTreeModelNode* mainSongNodeNew = nullptr;
 
-                    if (exists)
+                {
+                    // Determine ROM requirement
+                    PlaylistTreeModelNode::RomRequirement nodeRom = PlaylistTreeModelNode::RomRequirement::None;
+                    switch (tune->romRequirement)
                     {
-                        musCompanionStrFilePath = extraStrFilePath.GetFullPath();
-                        totalSubsongs = 3; // Add as fake subsongs so that individual MUS+STR components can be selected by the user if so desired.
+                        case TuneUtil::RomRequirement::None:
+                            nodeRom = PlaylistTreeModelNode::RomRequirement::None;
+                            break;
+                        case TuneUtil::RomRequirement::BasicRom:
+                            nodeRom = PlaylistTreeModelNode::RomRequirement::BasicRom;
+                            break;
+                        case TuneUtil::RomRequirement::R64:
+                            nodeRom = PlaylistTreeModelNode::RomRequirement::R64;
+                            break;
+                        default:
+                            wxMessageBox(Strings::Internal::UNHANDLED_SWITCH_CASE); // throwing doesn't work properly with release mode wxWidgets
+                            throw(Strings::Internal::UNHANDLED_SWITCH_CASE);
                     }
-                }
 
-                #pragma endregion
-
-                mainSongNodeNew = &_ui->treePlaylist->AddMainSong(Helpers::Wx::StringFromWin1252(songTitle.ToStdString()), filepath, defaultSubsong, hvscInfoMain.duration, hvscInfoMain.hvscPath, hvscInfoMain.md5, author, copyright, nodeRom, playable, musCompanionStrFilePath);
-            }
-
-            if (playable)
-            {
-                ++playableTunesCount;
-            }
-
-            // Add any subsongs to playlist tree
-            if (totalSubsongs > 1)
-            {
-                std::vector<uint_least32_t> subsongDurations;
-                subsongDurations.reserve(totalSubsongs);
+                    const char* const md5 = (tune->md5.empty()) ? nullptr : tune->md5.c_str();
+                    mainSongNodeNew = &_ui->treePlaylist->AddMainSong(tune->title, filepath, tune->defaultSubsong, tune->duration, tune->hvscPath, md5, tune->author, tune->copyright, nodeRom, playable, tune->musCompanionStrFilePath);
+                }
 
-                // Determine durations
-                for (int i = 1; i <= totalSubsongs; ++i)
+                if (playable)
                 {
-                    subsongDurations.emplace_back(TryGetHvscInfo(hvscInfoMain.md5, i).duration);
+                    ++playableTunesCount;
                 }
 
-                // Determine subsong titles (from STIL where possible)
-                std::vector<wxString> subsongTitles;
-                subsongTitles.reserve(totalSubsongs);
+                // Unknown song length (the MUS+STR pairs are left out, their subsongs are just the individual components)
+                if (enabledSonglengthEstimation && playable && tune->md5.empty() && !tune->estimated && tune->musCompanionStrFilePath.IsEmpty() && !tune->tuneMd5.empty())
+                {
+                    EnqueueSonglengthEstimation(filepath, tune->tuneMd5, tune->totalSubsongs);
+                }
 
-                const bool singleFileTune = mainSongNodeNew->musCompanionStrFilePath.IsEmpty();
-                if (singleFileTune) // Normal (or standalone MUS) tune
+                // Add any subsongs to playlist tree
+                const int totalSubsongs = tune->totalSubsongs;
+                if (totalSubsongs > 1)
                 {
-                    const Stil::Info info(_stilInfo.Get(mainSongNodeNew->hvscPath.ToStdString())); // Blank if unavailable.
-                    for (int i = 1; i <= totalSubsongs; ++i)
-                    {
-                        const int boxChar = (i < totalSubsongs) ? BOX_CHAR_VERT_RIGHT : BOX_CHAR_L;
-                        const std::string& title = info.GetFieldAsString(info.names, i);
+                    // Determine subsong titles (from STIL where possible)
+                    std::vector<wxString> subsongTitles;
+                    subsongTitles.reserve(totalSubsongs);
 
-                        if (!title.empty()) // STIL title
-                        {
-                            subsongTitles.emplace_back(wxString::Format("%c %s %i: %s", boxChar, Strings::PlaylistTree::SUBSONG, i, Helpers::Wx::StringFromWin1252(title)));
-                        }
-                        else // Generic subsong title
+                    const bool singleFileTune = mainSongNodeNew->musCompanionStrFilePath.IsEmpty();
+                    if (singleFileTune) // Normal (or standalone MUS) tune
+                    {
+                        const std::string hvscPath(mainSongNodeNew->hvscPath.ToStdString());
+                        Stil::Info parsedInfo; // Blank if unavailable.
+                        const Stil::Info& info = _stilInfo.GetPreloadedOrParse(hvscPath, parsedInfo); // No copy in the preloaded mode.
+                        for (int i = 1; i <= totalSubsongs; ++i)
                         {
-                            subsongTitles.emplace_back(wxString::Format("%c %s %i", boxChar, Strings::PlaylistTree::SUBSONG, i));
+                            const int boxChar = (i < totalSubsongs) ? BOX_CHAR_VERT_RIGHT : BOX_CHAR_L;
+                            const std::string& title = info.GetFieldAsString(info.names, i);
+
+                            if (!title.empty()) // STIL title
+                            {
+                                subsongTitles.emplace_back(wxString::Format("%c %s %i: %s", boxChar, Strings::PlaylistTree::SUBSONG, i, Helpers::Wx::StringFromWin1252(title)));
+                            }
+                            else // Generic subsong title
+                            {
+                                subsongTitles.emplace_back(wxString::Format("%c %s %i", boxChar, Strings::PlaylistTree::SUBSONG, i));
+                            }
                         }
                     }
+                    else // MUS+STR tune
+                    {
+                        subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_VERT_RIGHT, mainSongNodeNew->title.Mid(0, mainSongNodeNew->title.Length() - 4) + " [MUS+STR]"));
+                        subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_VERT_RIGHT, mainSongNodeNew->title));
+                        subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_L, mainSongNodeNew->title.Mid(0, mainSongNodeNew->title.Length() - 4) + ".str"));
+                    }
+
+                    // Add subsongs
+                    _ui->treePlaylist->AddSubsongs(tune->subsongDurations, subsongTitles, *mainSongNodeNew);
+
+                    if (!singleFileTune) // MUS+STR tune
+                    {
+                        _ui->treePlaylist->SetItemTag(mainSongNodeNew->GetSubsong(2), PlaylistTreeModelNode::ItemTag::MUS_StandaloneMus, {});
+                        _ui->treePlaylist->SetItemTag(mainSongNodeNew->GetSubsong(3), PlaylistTreeModelNode::ItemTag::MUS_StandaloneStr, {});
+                    }
                 }
-                else // MUS+STR tune
+
+                // One tune (with any subsongs) added -----------------
+
+                if (playable && enabledShortSongSkip) // Tag short songs
                 {
-                    subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_VERT_RIGHT, mainSongNodeNew->title.Mid(0, mainSongNodeNew->title.Length() - 4) + " [MUS+STR]"));
-                    subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_VERT_RIGHT, mainSongNodeNew->title));
-                    subsongTitles.emplace_back(wxString::Format("%c %s", BOX_CHAR_L, mainSongNodeNew->title.Mid(0, mainSongNodeNew->title.Length() - 4) + ".str"));
+                    UpdateIgnoredSong(*mainSongNodeNew);
+                }
+                else // Apply Normal tag and ROM requirement icons/styling
+                {
+                    _ui->treePlaylist->SetItemTag(*mainSongNodeNew, PlaylistTreeModelNode::ItemTag::Normal, true);
                 }
 
-                // Add subsongs
-                _ui->treePlaylist->AddSubsongs(subsongDurations, subsongTitles, *mainSongNodeNew);
-
-                if (!singleFileTune) // MUS+STR tune
+                // Auto-play
+                if (shouldAutoPlay)
                 {
-                    _ui->treePlaylist->SetItemTag(mainSongNodeNew->GetSubsong(2), PlaylistTreeModelNode::ItemTag::MUS_StandaloneMus, {});
-                    _ui->treePlaylist->SetItemTag(mainSongNodeNew->GetSubsong(3), PlaylistTreeModelNode::ItemTag::MUS_StandaloneStr, {});
+                    const PlaylistTreeModelNode* subsongItemData = _ui->treePlaylist->GetEffectiveInitialSubsong(*mainSongNodeNew);
+                    if (subsongItemData != nullptr) // Can be nullptr if the main song is not playable (e.g., missing ROM).
+                    {
+                        shouldAutoPlay = subsongItemData->GetTag() != PlaylistTreeModelNode::ItemTag::Normal || !TryPlayPlaylistItem(*mainSongNodeNew);
+                    }
                 }
             }
 
-            // One tune (with any subsongs) added -----------------
-
-            if (playable && enabledShortSongSkip) // Tag short songs
-            {
-                UpdateIgnoredSong(*mainSongNodeNew);
-            }
-            else // Apply Normal tag and ROM requirement icons/styling
+            if (playableTunesCount == 2)
             {
-                _ui->treePlaylist->SetItemTag(*mainSongNodeNew, PlaylistTreeModelNode::ItemTag::Normal, true);
+                UpdateUiState(); // Simply to enable the "next song" button immediately while still adding lots of files.
+                wxYield();
             }
 
-            // Auto-play
-            if (shouldAutoPlay)
+            // Update the UI in the interim (sparingly as the wxYield causes a tremendous slowdown)
             {
-                const PlaylistTreeModelNode* subsongItemData = _ui->treePlaylist->GetEffectiveInitialSubsong(*mainSongNodeNew);
-                if (subsongItemData != nullptr) // Can be nullptr if the main song is not playable (e.g., missing ROM).
+                if (throttledYieldCounter == 0 || throttledYieldCounter >= 100) // 255 max
                 {
-                    shouldAutoPlay = subsongItemData->GetTag() != PlaylistTreeModelNode::ItemTag::Normal || !TryPlayPlaylistItem(*mainSongNodeNew);
+                    throttledYieldCounter = 0;
+                    UpdatePlaylistPositionLabel();
+                    wxYield(); // Also must be before the HasFocus() call because not even that updates otherwise!
                 }
-            }
-        }
 
-        if (playableTunesCount == 2)
-        {
-            UpdateUiState(); // Simply to enable the "next song" button immediately while still adding lots of files.
-            wxYield();
-        }
+                ++throttledYieldCounter;
+            }
 
-        // Update the UI in the interim (sparingly as the wxYield causes a tremendous slowdown)
-        {
-            if (throttledYieldCounter == 0 || throttledYieldCounter >= 100) // 255 max
+            if (_exitingApplication || !_addingFilesToPlaylist) // In case the user clicked Close (or cleared the playlist) while adding lots of files. This should be checked immediately after any wxYield.
             {
-                throttledYieldCounter = 0;
-                UpdatePlaylistPositionLabel();
-                wxYield(); // Also must be before the HasFocus() call because not even that updates otherwise!
+                return; // The FileDiscovery and PlaylistIngest stop their workers on destruction.
             }
-
-            ++throttledYieldCounter;
-        }
-
-        if (_exitingApplication || !_addingFilesToPlaylist) // In case the user clicked Close (or cleared the playlist) while adding lots of files. This should be checked immediately after any wxYield.
-        {
-            return;
         }
     }
 
@@ -363,6 +334,16 @@ void FramePlayer::UpdateIgnoredSongs(PassKey<FramePrefs>)
     UpdateIgnoredSongs();
 }
 
+void FramePlayer::StopSonglengthEstimation(PassKey<FramePrefs>)
+{
+    StopSonglengthEstimation();
+}
+
+void FramePlayer::RestartSonglengthEstimation(PassKey<FramePrefs>)
+{
+    RestartSonglengthEstimation();
+}
+
 void FramePlayer::UpdateIgnoredSongs()
 {
     for (const PlaylistTreeModelNodePtr& songNode : _ui->treePlaylist->GetSongs())
@@ -388,7 +369,7 @@ void FramePlayer::UpdateIgnoredSong(PlaylistTreeModelNode& mainSongNode)
             continue;
         }
 
-        const uint_least32_t relevantSubsongDuration = (subsongNode->duration == 0) ? fallbackDuration : subsongNode->duration;
+        const uint_least32_t relevantSubsongDuration = (subsongNode->GetDuration() == 0) ? fallbackDuration : subsongNode->GetDuration();
         const bool durationIsShort = skipDurationThreshold > 0 && (relevantSubsongDuration < skipDurationThreshold);
 
         const PlaylistTreeModelNode::ItemTag tag = (durationIsShort) ? PlaylistTreeModelNode::ItemTag::ShortDuration : PlaylistTreeModelNode::ItemTag::Normal;
@@ -401,7 +382,7 @@ void FramePlayer::UpdateIgnoredSong(PlaylistTreeModelNode& mainSongNode)
 
         if (mainSongNode.GetSubsongCount() == 0)
         {
-            const uint_least32_t relevantSingleSongDuration = (mainSongNode.duration == 0) ? fallbackDuration : mainSongNode.duration;
+            const uint_least32_t relevantSingleSongDuration = (mainSongNode.GetDuration() == 0) ? fallbackDuration : mainSongNode.GetDuration();
             mainSongDurationIsShort = skipDurationThreshold > 0 && (relevantSingleSongDuration < skipDurationThreshold);
         }
         else
@@ -421,7 +402,7 @@ void FramePlayer::UpdateIgnoredSong(PlaylistTreeModelNode& mainSongNode)
 
 long FramePlayer::GetEffectiveSongDuration(const PlaylistTreeModelNode& node) const
 {
-    long effectiveDuration = static_cast<long>(node.duration);
+    long effectiveDuration = static_cast<long>(node.GetDuration());
     if (effectiveDuration == 0)
     {
         effectiveDuration = _app.currentSettings->GetOption(Settings::AppSettings::ID::SongFallbackDuration)->GetValueAsInt() * Const::MILLISECONDS_IN_SECOND;
@@ -432,11 +413,141 @@ long FramePlayer::GetEffectiveSongDuration(const PlaylistTreeModelNode& node) co
 
 Songlengths::HvscInfo FramePlayer::TryGetHvscInfo(const char* md5, int subsong) const
 {
-    if (!_sidDatabase.IsLoaded())
+    if (_sidDatabase.IsLoaded())
+    {
+        Songlengths::HvscInfo hvscInfo = _sidDatabase.GetHvscInfo(md5, subsong);
+        if (hvscInfo.md5 != nullptr)
+        {
+            return hvscInfo;
+        }
+    }
+
+    if (_estimatedSidDatabase.IsLoaded())
+    {
+        return _estimatedSidDatabase.GetHvscInfo(md5, subsong); // Tunes missing from the HVSC database (no HVSC path then).
+    }
+
+    //throw std::runtime_error("Database wasn't loaded!");
+    return Songlengths::HvscInfo(); // Dummy
+}
+
+void FramePlayer::EnqueueSonglengthEstimation(const wxString& filepath, const std::string& tuneMd5, int totalSubsongs)
+{
+    SonglengthEstimator::Job job;
+    job.tuneMd5 = tuneMd5;
+    job.filepath = std::string(filepath.utf8_str());
+    job.tuneFileName = wxFileName(filepath).GetFullName().ToStdWstring();
+    job.totalSubsongs = static_cast<unsigned int>(std::max(1, totalSubsongs));
+    job.loadTune = [filepath]()
     {
-        //throw std::runtime_error("Database wasn't loaded!");
-        return Songlengths::HvscInfo(); // Dummy
+        return (Helpers::Wx::Files::IsWithinZipFile(filepath)) ? Helpers::Wx::Files::GetFileContentFromZip(filepath) : Helpers::Wx::Files::GetFileContentFromDisk(filepath);
+    };
+
+    GetSonglengthEstimator().Enqueue(std::move(job));
+}
+
+SonglengthEstimator& FramePlayer::GetSonglengthEstimator()
+{
+    if (_songlengthEstimator == nullptr)
+    {
+        const PlaybackController& playback = _app.GetPlaybackInfo();
+        _songlengthEstimator = std::make_unique<SonglengthEstimator>(playback.GetSyncedPlaybackConfig(), playback.GetRomPaths()); // The user's config (not the current tune's overrides).
+    }
+
+    return *_songlengthEstimator;
+}
+
+void FramePlayer::RestartSonglengthEstimation()
+{
+    if (_songlengthEstimator == nullptr)
+    {
+        return;
+    }
+
+    _songlengthEstimator->Abort();
+    ApplyEstimatedSonglengths(); // Keep whatever was finished.
+
+    std::vector<SonglengthEstimator::Job> unfinishedJobs = _songlengthEstimator->TakeUnfinishedJobs();
+    _songlengthEstimator = nullptr;
+
+    for (SonglengthEstimator::Job& job : unfinishedJobs)
+    {
+        GetSonglengthEstimator().Enqueue(std::move(job));
+    }
+}
+
+void FramePlayer::ApplyEstimatedSonglengths()
+{
+    if (_songlengthEstimator != nullptr && _songlengthEstimator->HasResults())
+    {
+        for (SonglengthEstimator::Result& result : _songlengthEstimator->TakeResults())
+        {
+            _pendingEstimates.emplace_back(std::move(result));
+        }
+    }
+
+    if (!_pendingEstimates.empty() && !_addingFilesToPlaylist) // The ingest workers may be reading the estimated database.
+    {
+        FlushEstimatedSonglengths();
+    }
+}
+
+void FramePlayer::FlushEstimatedSonglengths()
+{
+    // Store (reminder: the database file is memory-mapped, so it has to be closed while appending)
+    {
+        const std::filesystem::path path(Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_ESTIMATED_SONGLENGTHS_NAME).ToStdWstring());
+        _estimatedSidDatabase.Unload();
+        SonglengthEstimator::TryAppendToSonglengthsFile(path, _pendingEstimates);
+        _estimatedSidDatabase.TryLoad(path);
+    }
+
+    // Apply to the songs already in the playlist
+    std::map<wxString, const SonglengthEstimator::Result*> estimates;
+    for (const SonglengthEstimator::Result& result : _pendingEstimates)
+    {
+        estimates.emplace(wxString::FromUTF8(result.filepath), &result);
+    }
+
+    const bool enabledShortSongSkip = _app.currentSettings->GetOption(Settings::AppSettings::ID::SkipShorter)->GetValueAsInt() > 0;
+    for (const PlaylistTreeModelNodePtr& songNode : _ui->treePlaylist->GetSongs())
+    {
+        const auto it = (songNode->md5.IsEmpty()) ? estimates.find(songNode->filepath) : estimates.end();
+        if (it == estimates.end() || it->second->durations.empty())
+        {
+            continue;
+        }
+
+        const std::vector<uint_least32_t>& durations = it->second->durations;
+        _ui->treePlaylist->SetItemDuration(*songNode, durations.front()); // Same as the Songlengths lookup (the first subsong's).
+
+        for (const PlaylistTreeModelNodePtr& subsongNode : songNode->GetChildren())
+        {
+            const size_t index = static_cast<size_t>(subsongNode->defaultSubsong - 1); // Self-index for the subsongs.
+            if (index < durations.size())
+            {
+                _ui->treePlaylist->SetItemDuration(*subsongNode, durations[index]);
+            }
+        }
+
+        if (songNode->IsPlayable() && enabledShortSongSkip)
+        {
+            UpdateIgnoredSong(*songNode);
+        }
+    }
+
+    _pendingEstimates.clear();
+    UpdatePlaylistPositionLabel(); // Total duration.
+}
+
+void FramePlayer::StopSonglengthEstimation()
+{
+    if (_songlengthEstimator == nullptr)
+    {
+        return;
     }
 
-    return _sidDatabase.GetHvscInfo(md5, subsong);
+    _songlengthEstimator->Abort();
+    ApplyEstimatedSonglengths(); // Keep whatever was finished.
+    _songlengthEstimator = nullptr;
 }
\ No newline at end of file
@@ -21,61 +21,80 @@
 #include "../Config/AppSettings.h"
 #include "../FrameChildren/FrameTuneInfo/FrameTuneInfo.h"
 
-bool FramePlayer::TryPlayPlaylistItem(const PlaylistTreeModelNode& activatedNode)
+bool FramePlayer::TryResolvePlaybackTarget(const PlaylistTreeModelNode& activatedNode, PlaybackTarget& outTarget) const
 {
     if (!activatedNode.IsPlayable())
     {
         return false;
     }
 
-    int subsong = activatedNode.defaultSubsong;
-
-    const PlaylistTreeModelNode* nodeToPlay = &activatedNode;
+    outTarget.subsong = activatedNode.defaultSubsong;
+    outTarget.node = &activatedNode;
 
     // If the selected node is a mainsong, determine the initial subsong to play.
     if (activatedNode.type == PlaylistTreeModelNode::ItemType::Song && activatedNode.GetSubsongCount() > 0)
     {
-        if (const PlaylistTreeModelNode* const subNode = _ui->treePlaylist->GetEffectiveInitialSubsong(activatedNode))
+        const PlaylistTreeModelNode* const subNode = _ui->treePlaylist->GetEffectiveInitialSubsong(activatedNode);
+        if (subNode == nullptr)
         {
-            subsong = subNode->defaultSubsong;
-            nodeToPlay = subNode;
+            return false; // All subsongs tagged for navigation auto-skip.
         }
-        else // All subsongs tagged for navigation auto-skip. Just expand the node but don't start any playback.
+
+        outTarget.subsong = subNode->defaultSubsong;
+        outTarget.node = subNode;
+    }
+
+    const PlaylistTreeModelNode& nodeToPlay = *outTarget.node;
+    outTarget.filepath = nodeToPlay.filepath;
+    outTarget.preRenderDurationMs = (_app.currentSettings->GetOption(Settings::AppSettings::ID::PreRenderEnabled)->GetValueAsBool()) ? GetEffectiveSongDuration(nodeToPlay) : 0;
+
+    wxFileName musCompanionStrFilePath(nodeToPlay.musCompanionStrFilePath); // MUS+STR (if STR is available)
+
+    switch (nodeToPlay.GetTag())
+    {
+        case PlaylistTreeModelNode::ItemTag::MUS_StandaloneMus: // Load MUS without STR
+            musCompanionStrFilePath.Clear();
+            break;
+        case PlaylistTreeModelNode::ItemTag::MUS_StandaloneStr: // Load STR without MUS
+            musCompanionStrFilePath.SetExt("str");
+            outTarget.filepath = musCompanionStrFilePath.GetFullPath();
+            musCompanionStrFilePath.Clear();
+            break;
+    }
+
+    outTarget.musCompanionStrFilePath = musCompanionStrFilePath.GetFullPath();
+    return true;
+}
+
+bool FramePlayer::TryPlayPlaylistItem(const PlaylistTreeModelNode& activatedNode)
+{
+    PlaybackTarget target;
+    if (!TryResolvePlaybackTarget(activatedNode, target))
+    {
+        if (activatedNode.IsPlayable()) // All subsongs tagged for navigation auto-skip. Just expand the node but don't start any playback.
         {
             _ui->treePlaylist->ExpandSongNode(activatedNode);
-            return false;
         }
+
+        return false;
     }
 
+    const PlaylistTreeModelNode* const nodeToPlay = target.node;
+    const wxString& targetFilepath = target.filepath;
+
 #ifdef WIN32
     wxSafeYield(); // Allow buttons to refresh to unclicked state before the blocking SID loading. Note: Linux (Wayland?) doesn't like this (may immediately mark the app as not responding).
 #endif
 
     // Trigger playback
-    wxString targetFilepath = nodeToPlay->filepath;
-    const int preRenderDurationMs = (_app.currentSettings->GetOption(Settings::AppSettings::ID::PreRenderEnabled)->GetValueAsBool()) ? GetEffectiveSongDuration(*nodeToPlay) : 0;
-    const bool sameTune = _app.GetPlaybackInfo().GetCurrentTuneFilePath() == targetFilepath.ToStdWstring();
+    const bool sameTune = _app.GetPlaybackInfo().GetCurrentTuneFilePath() == nodeToPlay->filepath.ToStdWstring();
     if (sameTune && nodeToPlay->musCompanionStrFilePath.IsEmpty())
     {
-        _app.PlaySubsong(subsong, preRenderDurationMs); // Switch an already-loaded tune to subsong.
+        _app.PlaySubsong(target.subsong, target.preRenderDurationMs); // Switch an already-loaded tune to subsong.
     }
     else
     {
-        wxFileName musCompanionStrFilePath(nodeToPlay->musCompanionStrFilePath); // MUS+STR (if STR is available)
-
-        switch (nodeToPlay->GetTag())
-        {
-            case PlaylistTreeModelNode::ItemTag::MUS_StandaloneMus: // Load MUS without STR
-                musCompanionStrFilePath.Clear();
-                break;
-            case PlaylistTreeModelNode::ItemTag::MUS_StandaloneStr: // Load STR without MUS
-                musCompanionStrFilePath.SetExt("str");
-                targetFilepath = musCompanionStrFilePath.GetFullPath();
-                musCompanionStrFilePath.Clear();
-                break;
-        }
-
-        _app.Play(targetFilepath, subsong, preRenderDurationMs, musCompanionStrFilePath.GetFullPath());
+        _app.Play(targetFilepath, target.subsong, target.preRenderDurationMs, target.musCompanionStrFilePath);
     }
 
     // Highlight the item in the playlist if the playback started successfully (file exists etc.)
@@ -94,9 +113,59 @@ bool FramePlayer::TryPlayPlaylistItem(const PlaylistTreeModelNode& activatedNode
         ShowTuneInfo();
     }
 
+    if (fileLoadedSuccessfully)
+    {
+        CallAfter(&FramePlayer::PrepareNextPlaylistItem); // Once the UI has settled.
+    }
+
     return true;
 }
 
+void FramePlayer::PrepareNextPlaylistItem()
+{
+    using RepeatMode = UIElements::RepeatModeButton::RepeatMode;
+
+    if (!_app.currentSettings->GetOption(Settings::AppSettings::ID::PreloadNextSong)->GetValueAsBool() || _app.GetPlaybackInfo().GetState() == PlaybackController::State::Stopped)
+    {
+        return;
+    }
+
+    // Mirror the OnSongDurationReached
+    const RepeatMode repeatMode = static_cast<RepeatMode>(_app.currentSettings->GetOption(Settings::AppSettings::ID::RepeatMode)->GetValueAsInt());
+    if (repeatMode != RepeatMode::Normal && repeatMode != RepeatMode::RepeatAll)
+    {
+        return;
+    }
+
+    const bool includeSubsongs = _app.currentSettings->GetOption(Settings::AppSettings::ID::RepeatModeIncludeSubsongs)->GetValueAsBool();
+    if (includeSubsongs && _ui->treePlaylist->GetNextSubsong() != nullptr)
+    {
+        return; // Next subsong of the already-loaded tune, nothing to preload.
+    }
+
+    const PlaylistTreeModelNode* nextNode = _ui->treePlaylist->GetNextSong();
+    if (nextNode == nullptr && repeatMode == RepeatMode::RepeatAll && !_ui->treePlaylist->IsEmpty())
+    {
+        const PlaylistTreeModelNode& firstTuneNode = *_ui->treePlaylist->GetSongs().front();
+        if (firstTuneNode.GetTag() == PlaylistTreeModelNode::ItemTag::Normal)
+        {
+            nextNode = &firstTuneNode; // Wrap around.
+        }
+    }
+
+    PlaybackTarget target;
+    if (nextNode == nullptr || !TryResolvePlaybackTarget(*nextNode, target))
+    {
+        return;
+    }
+
+    const bool sameTune = _app.GetPlaybackInfo().GetCurrentTuneFilePath() == target.node->filepath.ToStdWstring();
+    if (!(sameTune && target.node->musCompanionStrFilePath.IsEmpty())) // Otherwise it'd just switch the subsong of the already-loaded tune.
+    {
+        _app.PrepareNext(target.filepath, target.subsong, target.preRenderDurationMs, target.musCompanionStrFilePath);
+    }
+}
+
 bool FramePlayer::TryPlayNextValidSong()
 {
     const PlaylistTreeModelNode* const node = _ui->treePlaylist->GetNextSong();
@@ -494,7 +494,7 @@ void FramePlayer::UpdatePlaylistPositionLabel()
                             durationPlayedMs += durationTotalMs;
                         }
 
-                        durationTotalMs += (subsongNode->duration != 0) ? subsongNode->duration : fallbackDurationMs;
+                        durationTotalMs += (subsongNode->GetDuration() != 0) ? subsongNode->GetDuration() : fallbackDurationMs;
                     }
                 }
                 else // Sum the main song's duration only
@@ -504,7 +504,7 @@ void FramePlayer::UpdatePlaylistPositionLabel()
                         durationPlayedMs += durationTotalMs;
                     }
 
-                    durationTotalMs += (songNode->duration != 0) ? songNode->duration : fallbackDurationMs;
+                    durationTotalMs += (songNode->GetDuration() != 0) ? songNode->GetDuration() : fallbackDurationMs;
                 }
             }
 
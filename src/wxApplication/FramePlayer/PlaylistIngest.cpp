@@ -0,0 +1,321 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "PlaylistIngest.h"
+#include "../Helpers/HelpersWx.h"
+
+#include <sidplayfp/SidTuneInfo.h>
+
+#include <algorithm>
+
+namespace
+{
+	static constexpr unsigned int MAX_WORKERS = 8;
+
+	/// @brief How far ahead of the consumer the workers may get (bounds the memory held by the finished-but-not-taken descriptors).
+	static constexpr size_t MAX_LOOKAHEAD = 1024;
+}
+
+PlaylistIngest::PlaylistIngest(const Songlengths& sidDatabase, TuneMetadataCache* metadataCache, const Songlengths* estimatedSidDatabase) :
+	_sidDatabase(sidDatabase),
+	_metadataCache(metadataCache),
+	_estimatedSidDatabase(estimatedSidDatabase)
+{
+}
+
+PlaylistIngest::PlaylistIngest(const wxArrayString& files, const Songlengths& sidDatabase, TuneMetadataCache* metadataCache, const Songlengths* estimatedSidDatabase) :
+	PlaylistIngest(sidDatabase, metadataCache, estimatedSidDatabase)
+{
+	AddFiles(files);
+	FinishAdding();
+}
+
+PlaylistIngest::~PlaylistIngest()
+{
+	Abort();
+}
+
+void PlaylistIngest::AddFiles(const wxArrayString& files)
+{
+	if (files.IsEmpty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_abort || _addingFinished)
+		{
+			return;
+		}
+
+		_files.insert(_files.end(), files.begin(), files.end()); // Own copies so that the workers never touch the caller's strings.
+		_results.resize(_files.size());
+
+		// Spawn the workers lazily (no more than there are files)
+		const unsigned int numWorkers = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_WORKERS);
+		const size_t effectiveWorkers = std::min(static_cast<size_t>(numWorkers), _files.size());
+
+		while (_workers.size() < effectiveWorkers)
+		{
+			_workers.emplace_back(&PlaylistIngest::WorkerLoop, this); // Reminder: the new worker simply waits for the lock we're holding here.
+		}
+	}
+
+	_cvWindow.notify_all();
+}
+
+void PlaylistIngest::FinishAdding()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_addingFinished = true;
+	}
+
+	_cvWindow.notify_all();
+	_cvReady.notify_all();
+}
+
+size_t PlaylistIngest::GetFileCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _files.size();
+}
+
+std::vector<PlaylistIngest::TuneDescriptorPtr> PlaylistIngest::TakeReady(std::chrono::milliseconds timeout)
+{
+	std::vector<TuneDescriptorPtr> ready;
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_cvReady.wait_for(lock, timeout, [this]()
+		{
+			if (_abort)
+			{
+				return true;
+			}
+
+			return (_nextToTake < _results.size()) ? _results[_nextToTake] != nullptr : _addingFinished;
+		});
+
+		while (_nextToTake < _results.size() && _results[_nextToTake] != nullptr)
+		{
+			ready.emplace_back(std::move(_results[_nextToTake]));
+			++_nextToTake;
+		}
+	}
+
+	if (!ready.empty())
+	{
+		_cvWindow.notify_all();
+	}
+
+	return ready;
+}
+
+bool PlaylistIngest::IsDone() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _addingFinished && _nextToTake >= _results.size();
+}
+
+void PlaylistIngest::Abort()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_abort = true;
+	}
+
+	_cvWindow.notify_all();
+	_cvReady.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+	_workers.clear();
+}
+
+void PlaylistIngest::WorkerLoop()
+{
+	while (true)
+	{
+		size_t index = 0;
+		wxString filepath;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cvWindow.wait(lock, [this]()
+			{
+				const bool claimable = _nextToClaim < _files.size() && _nextToClaim < _nextToTake + MAX_LOOKAHEAD;
+				return _abort || claimable || (_addingFinished && _nextToClaim >= _files.size());
+			});
+
+			if (_abort || _nextToClaim >= _files.size())
+			{
+				return;
+			}
+
+			index = _nextToClaim++;
+			filepath = _files[index]; // Copied under the lock, as the AddFiles may reallocate the vector meanwhile.
+		}
+
+		TuneDescriptorPtr descriptor = InspectTune(filepath);
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_results[index] = std::move(descriptor);
+		}
+
+		_cvReady.notify_one();
+	}
+}
+
+PlaylistIngest::TuneDescriptorPtr PlaylistIngest::InspectTune(const wxString& filepath) const
+{
+	TuneDescriptorPtr descriptor = std::make_unique<TuneDescriptor>();
+	descriptor->filepath = filepath;
+
+	TuneMetadataCache::Metadata metadata;
+	if (_metadataCache == nullptr || !_metadataCache->TryGet(filepath, metadata))
+	{
+		if (!TryReadTuneMetadata(filepath, metadata))
+		{
+			return descriptor;
+		}
+
+		if (_metadataCache != nullptr)
+		{
+			_metadataCache->Put(filepath, metadata);
+		}
+	}
+
+	descriptor->valid = true;
+	descriptor->title = metadata.title;
+	descriptor->author = metadata.author;
+	descriptor->copyright = metadata.copyright;
+	descriptor->defaultSubsong = metadata.defaultSubsong;
+	descriptor->totalSubsongs = metadata.totalSubsongs;
+	descriptor->romRequirement = metadata.romRequirement;
+	descriptor->tuneMd5 = metadata.md5;
+
+	// Songlengths (read-only lookups, safe to do concurrently)
+	if (_sidDatabase.IsLoaded())
+	{
+		const Songlengths::HvscInfo& hvscInfoMain = _sidDatabase.GetHvscInfo(metadata.md5.c_str());
+		descriptor->duration = hvscInfoMain.duration;
+		descriptor->hvscPath = hvscInfoMain.hvscPath;
+		descriptor->md5 = (hvscInfoMain.md5 == nullptr) ? "" : hvscInfoMain.md5;
+	}
+
+	// Estimated Songlengths (only for the tunes missing from the main database)
+	if (descriptor->md5.empty() && _estimatedSidDatabase != nullptr && _estimatedSidDatabase->IsLoaded())
+	{
+		const Songlengths::HvscInfo& estimatedInfo = _estimatedSidDatabase->GetHvscInfo(metadata.md5.c_str());
+		descriptor->duration = estimatedInfo.duration;
+		descriptor->estimated = estimatedInfo.md5 != nullptr;
+	}
+
+	#pragma region Detect MUS+STR pair
+
+	const bool musFileType = filepath.Lower().EndsWith(".mus");
+	if (musFileType)
+	{
+		// Check if the companion STR file exists as well, and load it in pair (MUS+STR)
+		wxFileName extraStrFilePath(filepath);
+		extraStrFilePath.SetExt("str");
+
+		const bool exists =
+			(Helpers::Wx::Files::IsWithinZipFile(extraStrFilePath.GetFullPath()) && Helpers::Wx::Files::FileExistsInZipArchive(extraStrFilePath.GetFullPath())) ||
+			(extraStrFilePath.FileExists());
+
+		if (exists)
+		{
+			descriptor->musCompanionStrFilePath = extraStrFilePath.GetFullPath();
+			descriptor->totalSubsongs = 3; // Add as fake subsongs so that individual MUS+STR components can be selected by the user if so desired.
+		}
+	}
+
+	#pragma endregion
+
+	// Subsong durations (decoded all at once)
+	if (descriptor->totalSubsongs > 1)
+	{
+		if (!descriptor->md5.empty())
+		{
+			descriptor->subsongDurations = _sidDatabase.GetSubsongDurations(descriptor->md5.c_str());
+		}
+		else if (descriptor->estimated)
+		{
+			descriptor->subsongDurations = _estimatedSidDatabase->GetSubsongDurations(descriptor->tuneMd5.c_str());
+		}
+
+		descriptor->subsongDurations.resize(descriptor->totalSubsongs, 0); // Unknown durations are 0 (also for the MUS+STR fake subsongs).
+	}
+
+	return descriptor;
+}
+
+bool PlaylistIngest::TryReadTuneMetadata(const wxString& filepath, TuneMetadataCache::Metadata& outMetadata)
+{
+	std::unique_ptr<SidTune> inspectTune = nullptr;
+
+	{
+		const std::unique_ptr<BufferHolder>& infoTuneBufferHolder = (Helpers::Wx::Files::IsWithinZipFile(filepath))
+				? Helpers::Wx::Files::GetFileContentFromZip(filepath)
+				: Helpers::Wx::Files::GetFileContentFromDisk(filepath);
+
+		inspectTune = (infoTuneBufferHolder != nullptr) ? std::make_unique<SidTune>(infoTuneBufferHolder->buffer[0], infoTuneBufferHolder->size[0]) : nullptr;
+		if (inspectTune == nullptr || !inspectTune->getStatus())
+		{
+			return false;
+		}
+	}
+
+	// Tune title
+	{
+		wxString songTitle(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Title));
+		if (songTitle.IsEmpty()) [[unlikely]] // Fallback/MUS file (rare situation)
+		{
+			songTitle = wxFileNameFromPath(filepath);
+		}
+
+		const int sidsNeeded = inspectTune->getInfo()->sidChips();
+		if (sidsNeeded > 1)
+		{
+			songTitle.Append(wxString::Format(" [%iSID]", sidsNeeded));
+		}
+
+		outMetadata.title = Helpers::Wx::StringFromWin1252(songTitle.ToStdString());
+	}
+
+	outMetadata.author = Helpers::Wx::StringFromWin1252(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Author));
+	outMetadata.copyright = Helpers::Wx::StringFromWin1252(TuneUtil::GetTuneInfoString(*inspectTune, TuneUtil::SongInfoCategory::Released));
+
+	outMetadata.defaultSubsong = inspectTune->getInfo()->startSong();
+	outMetadata.totalSubsongs = inspectTune->getInfo()->songs();
+	outMetadata.romRequirement = TuneUtil::GetTuneRomRequirement(*inspectTune);
+	const char* const md5 = inspectTune->createMD5New();
+	outMetadata.md5 = (md5 == nullptr) ? "" : md5;
+
+	return true;
+}
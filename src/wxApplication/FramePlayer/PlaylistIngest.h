@@ -0,0 +1,124 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include "TuneMetadataCache.h"
+#include "../../HvscSupport/Songlengths.h"
+#include "../../PlaybackController/PlaybackWrappers/Input/SidDecoder/TuneUtil.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Inspects tune files on worker threads (file/zip I/O, SidTune parsing, MD5 and Songlengths lookups) so that the GUI thread only has to insert the finished descriptors into the playlist.
+class PlaylistIngest
+{
+public:
+	struct TuneDescriptor
+	{
+		wxString filepath;
+		bool valid = false;
+
+		wxString title;
+		wxString author;
+		wxString copyright;
+
+		int defaultSubsong = 0;
+		int totalSubsongs = 0;
+		TuneUtil::RomRequirement romRequirement = TuneUtil::RomRequirement::None;
+
+		uint_least32_t duration = 0;
+		std::string hvscPath;
+		std::string md5; // Empty if the tune is not in the Songlengths database (same as the HvscInfo::md5 semantics).
+		std::vector<uint_least32_t> subsongDurations; // Only populated if the tune has more than one (real or MUS+STR fake) subsong.
+
+		std::string tuneMd5; // Tune's own MD5 (regardless of whether it's in any database).
+		bool estimated = false; // The durations come from the estimated Songlengths database (the tune isn't in the main one).
+
+		wxString musCompanionStrFilePath;
+	};
+
+	using TuneDescriptorPtr = std::unique_ptr<TuneDescriptor>;
+
+public:
+	PlaylistIngest() = delete;
+	PlaylistIngest(PlaylistIngest&) = delete;
+
+	/// @brief Streaming mode: the files are supplied via the AddFiles (e.g., while they're still being discovered), followed by the FinishAdding.
+	/// The metadataCache is optional: if given, it's consulted before reading the tune files and it's populated with the newly inspected tunes.
+	/// The estimatedSidDatabase is optional: if given, it's consulted for the tunes which aren't in the main sidDatabase. It mustn't be reloaded while the ingest is running.
+	PlaylistIngest(const Songlengths& sidDatabase, TuneMetadataCache* metadataCache = nullptr, const Songlengths* estimatedSidDatabase = nullptr);
+
+	/// @brief All files are known upfront.
+	PlaylistIngest(const wxArrayString& files, const Songlengths& sidDatabase, TuneMetadataCache* metadataCache = nullptr, const Songlengths* estimatedSidDatabase = nullptr);
+	~PlaylistIngest();
+
+public:
+	/// @brief Thread-safe. Appends the files to be inspected (the descriptors are still taken in the overall order the files were added in).
+	void AddFiles(const wxArrayString& files);
+
+	/// @brief Thread-safe. Signals that no more files will be added (the IsDone can't become true before this).
+	void FinishAdding();
+
+	/// @brief Number of files added so far.
+	size_t GetFileCount() const;
+
+	/// @brief Takes all consecutive (in the original file order) descriptors which are ready, waiting up to the timeout for at least one of them.
+	std::vector<TuneDescriptorPtr> TakeReady(std::chrono::milliseconds timeout);
+
+	/// @brief Returns true once all descriptors have been taken.
+	bool IsDone() const;
+
+	/// @brief Stops the workers as soon as they finish their current file. Called automatically on destruction.
+	void Abort();
+
+private:
+	void WorkerLoop();
+	TuneDescriptorPtr InspectTune(const wxString& filepath) const;
+
+	/// @brief Reads and parses the tune file (the slow part).
+	static bool TryReadTuneMetadata(const wxString& filepath, TuneMetadataCache::Metadata& outMetadata);
+
+private:
+	const Songlengths& _sidDatabase;
+	TuneMetadataCache* const _metadataCache;
+	const Songlengths* const _estimatedSidDatabase;
+	std::vector<wxString> _files;
+	std::vector<TuneDescriptorPtr> _results;
+
+	std::vector<std::thread> _workers;
+	mutable std::mutex _mutex;
+	std::condition_variable _cvReady;
+	std::condition_variable _cvWindow;
+
+	size_t _nextToClaim = 0;
+	size_t _nextToTake = 0;
+	bool _addingFinished = false;
+	bool _abort = false;
+};
@@ -0,0 +1,287 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "TuneMetadataCache.h"
+#include "../Helpers/HelpersWx.h"
+#include "../../Util/MemoryMappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <unordered_set>
+
+// Layout (little-endian, native for all supported platforms):
+// [Header][Entries: str filepath, i64 modified, u64 size, str title, str author, str copyright, i32 defaultSubsong, i32 totalSubsongs, u8 romRequirement, str md5]
+// Where str = u32 length + UTF-8 bytes.
+static constexpr char METADATA_CACHE_MAGIC[8] = {'S', 'W', 'X', 'M', 'E', 'T', 'A', '\0'};
+static constexpr uint32_t METADATA_CACHE_FORMAT_VERSION = 1;
+
+namespace
+{
+	struct Header
+	{
+		char magic[8];
+		uint32_t formatVersion;
+		uint32_t entriesCount;
+	};
+
+	class Writer
+	{
+	public:
+		template <typename T>
+		void Write(T value)
+		{
+			const size_t pos = _image.size();
+			_image.resize(pos + sizeof(T));
+			std::memcpy(_image.data() + pos, &value, sizeof(T));
+		}
+
+		void WriteString(std::string_view str)
+		{
+			Write<uint32_t>(static_cast<uint32_t>(str.size()));
+			_image.insert(_image.end(), str.begin(), str.end());
+		}
+
+		void WriteString(const wxString& str)
+		{
+			const wxScopedCharBuffer utf8 = str.utf8_str();
+			WriteString(std::string_view(utf8.data(), utf8.length()));
+		}
+
+		const std::vector<char>& Image() const
+		{
+			return _image;
+		}
+
+	private:
+		std::vector<char> _image;
+	};
+
+	/// @brief Bounds-checked reader: once anything is out of bounds, all subsequent reads yield the default values and IsOk returns false.
+	class Reader
+	{
+	public:
+		explicit Reader(std::string_view image) :
+			_pos(image.data()),
+			_end(image.data() + image.size())
+		{
+		}
+
+		template <typename T>
+		T Read()
+		{
+			T value{};
+			if (_ok && static_cast<size_t>(_end - _pos) >= sizeof(T))
+			{
+				std::memcpy(&value, _pos, sizeof(T)); // Avoids unaligned access.
+				_pos += sizeof(T);
+			}
+			else
+			{
+				_ok = false;
+			}
+
+			return value;
+		}
+
+		std::string_view ReadString()
+		{
+			const uint32_t length = Read<uint32_t>();
+			if (!_ok || static_cast<size_t>(_end - _pos) < length)
+			{
+				_ok = false;
+				return std::string_view();
+			}
+
+			const std::string_view str(_pos, length);
+			_pos += length;
+			return str;
+		}
+
+		wxString ReadWxString()
+		{
+			const std::string_view str = ReadString();
+			return wxString::FromUTF8(str.data(), str.size());
+		}
+
+		bool IsOk() const
+		{
+			return _ok;
+		}
+
+	private:
+		const char* _pos;
+		const char* _end;
+		bool _ok = true;
+	};
+}
+
+bool TuneMetadataCache::TryLoad(const wxString& cacheFilePath)
+{
+	std::unordered_map<std::wstring, Entry> entries;
+
+	MemoryMappedFile file;
+	if (!file.TryOpen(cacheFilePath.ToStdWstring()))
+	{
+		return false;
+	}
+
+	Reader reader(file.View());
+
+	const Header header = reader.Read<Header>();
+	if (!reader.IsOk() || std::memcmp(header.magic, METADATA_CACHE_MAGIC, sizeof(header.magic)) != 0 || header.formatVersion != METADATA_CACHE_FORMAT_VERSION)
+	{
+		return false; // Outdated or not our file.
+	}
+
+	entries.reserve(header.entriesCount);
+	for (uint32_t i = 0; i < header.entriesCount && reader.IsOk(); ++i)
+	{
+		const wxString filepath = reader.ReadWxString();
+
+		Entry entry;
+		entry.modified = reader.Read<int64_t>();
+		entry.size = reader.Read<uint64_t>();
+		entry.metadata.title = reader.ReadWxString();
+		entry.metadata.author = reader.ReadWxString();
+		entry.metadata.copyright = reader.ReadWxString();
+		entry.metadata.defaultSubsong = reader.Read<int32_t>();
+		entry.metadata.totalSubsongs = reader.Read<int32_t>();
+
+		const uint8_t romRequirement = reader.Read<uint8_t>();
+		if (romRequirement > static_cast<uint8_t>(TuneUtil::RomRequirement::R64))
+		{
+			return false; // Corrupted.
+		}
+
+		entry.metadata.romRequirement = static_cast<TuneUtil::RomRequirement>(romRequirement);
+		entry.metadata.md5 = reader.ReadString();
+
+		entries.emplace(filepath.ToStdWstring(), std::move(entry));
+	}
+
+	if (!reader.IsOk())
+	{
+		return false; // Truncated.
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries = std::move(entries);
+	return true;
+}
+
+bool TuneMetadataCache::TrySave(const wxString& cacheFilePath) const
+{
+	Writer writer;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		Header header{};
+		std::memcpy(header.magic, METADATA_CACHE_MAGIC, sizeof(header.magic));
+		header.formatVersion = METADATA_CACHE_FORMAT_VERSION;
+		header.entriesCount = static_cast<uint32_t>(_entries.size());
+		writer.Write<Header>(header);
+
+		for (const auto& [filepath, entry] : _entries)
+		{
+			writer.WriteString(wxString(filepath));
+			writer.Write<int64_t>(entry.modified);
+			writer.Write<uint64_t>(entry.size);
+			writer.WriteString(entry.metadata.title);
+			writer.WriteString(entry.metadata.author);
+			writer.WriteString(entry.metadata.copyright);
+			writer.Write<int32_t>(entry.metadata.defaultSubsong);
+			writer.Write<int32_t>(entry.metadata.totalSubsongs);
+			writer.Write<uint8_t>(static_cast<uint8_t>(entry.metadata.romRequirement));
+			writer.WriteString(std::string_view(entry.metadata.md5));
+		}
+	}
+
+#ifndef WIN32
+	const wxString cacheFolder = wxFileName(cacheFilePath).GetPath();
+	if (!cacheFolder.IsEmpty() && !wxDirExists(cacheFolder))
+	{
+		wxFileName::Mkdir(cacheFolder, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+	}
+#endif
+
+	std::ofstream outStream(std::filesystem::path(cacheFilePath.ToStdWstring()), std::ios::trunc | std::ios::binary);
+	if (!outStream.good())
+	{
+		return false;
+	}
+
+	const std::vector<char>& image = writer.Image();
+	outStream.write(image.data(), static_cast<std::streamsize>(image.size()));
+	outStream.close();
+
+	return outStream.good();
+}
+
+bool TuneMetadataCache::TryGet(const wxString& filepath, Metadata& outMetadata) const
+{
+	int64_t modified = 0;
+	uint64_t size = 0;
+	if (!Helpers::Wx::Files::TryGetFileStamp(filepath, modified, size))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	const auto it = _entries.find(filepath.ToStdWstring());
+	if (it == _entries.cend() || it->second.modified != modified || it->second.size != size)
+	{
+		return false;
+	}
+
+	outMetadata = it->second.metadata;
+	return true;
+}
+
+void TuneMetadataCache::Put(const wxString& filepath, const Metadata& metadata)
+{
+	Entry entry;
+	if (!Helpers::Wx::Files::TryGetFileStamp(filepath, entry.modified, entry.size))
+	{
+		return;
+	}
+
+	entry.metadata = metadata;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries[filepath.ToStdWstring()] = std::move(entry);
+}
+
+void TuneMetadataCache::RetainOnly(const std::vector<wxString>& filepaths)
+{
+	std::unordered_set<std::wstring> retained;
+	retained.reserve(filepaths.size());
+	for (const wxString& filepath : filepaths)
+	{
+		retained.emplace(filepath.ToStdWstring());
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto it = _entries.begin(); it != _entries.end();)
+	{
+		it = (retained.find(it->first) == retained.end()) ? _entries.erase(it) : std::next(it);
+	}
+}
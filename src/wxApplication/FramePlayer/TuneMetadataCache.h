@@ -0,0 +1,84 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include "../../PlaybackController/PlaybackWrappers/Input/SidDecoder/TuneUtil.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Persistent cache of the tune-intrinsic metadata (i.e., what would otherwise require reading and parsing the tune file), so that re-opening a large playlist skips the re-scanning.
+/// Entries are validated by the file's (or containing archive's) modification time and size. The Songlengths-derived data is deliberately not cached, as the database can change independently of the tunes.
+class TuneMetadataCache
+{
+public:
+	struct Metadata
+	{
+		wxString title; // Final (decoded) form, incl. the multi-SID suffix.
+		wxString author;
+		wxString copyright;
+
+		int defaultSubsong = 0;
+		int totalSubsongs = 0;
+		TuneUtil::RomRequirement romRequirement = TuneUtil::RomRequirement::None;
+
+		std::string md5; // Tune's own MD5 (regardless of whether it's in the Songlengths database).
+	};
+
+public:
+	TuneMetadataCache() = default;
+	TuneMetadataCache(TuneMetadataCache&) = delete;
+
+	TuneMetadataCache operator=(const TuneMetadataCache&) = delete;
+
+public:
+	/// @brief Replaces the current content with the cache file's. Returns false (leaving the cache empty) if the file is missing, outdated or corrupted.
+	bool TryLoad(const wxString& cacheFilePath);
+
+	bool TrySave(const wxString& cacheFilePath) const;
+
+	/// @brief Thread-safe. Returns false if not cached or the file was modified since.
+	bool TryGet(const wxString& filepath, Metadata& outMetadata) const;
+
+	/// @brief Thread-safe.
+	void Put(const wxString& filepath, const Metadata& metadata);
+
+	/// @brief Drops the entries of files not in the list (e.g., songs which were removed from the playlist).
+	void RetainOnly(const std::vector<wxString>& filepaths);
+
+private:
+	struct Entry
+	{
+		int64_t modified = 0;
+		uint64_t size = 0;
+		Metadata metadata;
+	};
+
+private:
+	mutable std::mutex _mutex;
+	std::unordered_map<std::wstring, Entry> _entries;
+};
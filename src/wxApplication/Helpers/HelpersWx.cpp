@@ -17,6 +17,8 @@
  */
 
 #include "HelpersWx.h"
+#include "ZipArchiveIndex.h"
+#include "../../Util/TuneBufferCache.h"
 
 #include <wx/dir.h>
 #include <wx/stdpaths.h>
@@ -29,44 +31,157 @@
 
 namespace
 {
+	ZipArchiveIndex zipArchiveIndex;
+
+	static constexpr size_t DEFAULT_TUNE_CACHE_BUDGET_BYTES = 32 * 1024 * 1024;
+	TuneBufferCache tuneBufferCache(DEFAULT_TUNE_CACHE_BUDGET_BYTES);
+
 	inline wxArrayString GetFilesInZip(const wxString& path)
 	{
 		wxArrayString flatfileList;
 
-		wxFileSystem fs;
-		fs.ChangePathTo(path); // Prevent OpenFile from trying relative scope first (always in vain). This yields huuuge speed boost.
-		wxString filenameOnly = path;
-		filenameOnly.Replace("\\", "/");
-		if (!fs.GetPath().IsEmpty())
+		for (const wxString& entryName : zipArchiveIndex.GetEntryNames(path))
+		{
+			flatfileList.push_back(wxString::Format("%s/%s", path, entryName));
+		}
+
+		return flatfileList;
+	}
+
+	/// @brief Walks the folders manually (rather than via wxDir::GetAllFiles) so that the files can be passed on per folder while the walk is still in progress.
+	class ValidFilesWalker
+	{
+	public:
+		/// @brief Large folders are passed on in chunks, so that the consumer can start early (and stop the walk) without waiting for the whole folder.
+		static constexpr size_t MAX_BATCH_SIZE = 256;
+
+	public:
+		explicit ValidFilesWalker(const Helpers::Wx::Files::DiscoveryBatchSink& sink) :
+			_sink(sink),
+			_selfExecutablePath(wxStandardPaths::Get().GetExecutablePath())
 		{
-			filenameOnly.Replace(fs.GetPath(), "");
 		}
 
-		wxFSFile* fsFile = fs.OpenFile(filenameOnly, wxFS_READ);
-		if (fsFile != NULL)
+		void Walk(const wxArrayString& rawFileList)
+		{
+			for (const wxString& fileOrFolder : rawFileList)
+			{
+				if (_stopped)
+				{
+					return;
+				}
+
+				AddPath(fileOrFolder);
+			}
+
+			Flush();
+		}
+
+	private:
+		void AddPath(const wxString& fileOrFolder)
 		{
-			wxZipInputStream in(fsFile->GetStream());
+			using namespace Helpers::Wx::Files;
 
-			if (in.GetTotalEntries() > 0)
+			if (wxFileExists(fileOrFolder))
 			{
-				wxZipEntry* entry = in.GetNextEntry();
-				while (entry != nullptr)
+				if (IsZipFile(fileOrFolder))
+				{
+					const wxArrayString& result = GetFilesInZip(fileOrFolder); // Files are obtained in a "flat" manner (no need for recursion for folders).
+					_batch.reserve(_batch.GetCount() + result.GetCount());
+					std::copy(result.begin(), result.end(), std::back_inserter(_batch));
+				}
+				else if (fileOrFolder.EndsWith(FILE_EXTENSION_PLAYLIST)) // Playlist file
+				{
+					const wxArrayString& filesInPlaylist = LoadPathsFromPlaylist(fileOrFolder);
+					_batch.reserve(_batch.GetCount() + filesInPlaylist.GetCount());
+					std::copy(filesInPlaylist.begin(), filesInPlaylist.end(), std::back_inserter(_batch));
+				}
+				else // Plain file
 				{
-					if (!entry->IsDir())
+					if (fileOrFolder != _selfExecutablePath)
 					{
-						flatfileList.push_back(wxString::Format("%s/%s", path, entry->GetName()));
+						_batch.push_back(fileOrFolder);
 					}
+				}
+			}
+			else if (IsWithinZipFile(fileOrFolder))
+			{
+				const wxString& archiveFilename = SplitZipArchiveAndFileNames(fileOrFolder).first;
+				if (wxFileExists(archiveFilename))
+				{
+					_batch.push_back(fileOrFolder);
+				}
+			}
+			else if (wxDirExists(fileOrFolder))
+			{
+				WalkFolder(fileOrFolder); // Neccessary in order to process any encountered Zip files.
+			}
+
+			if (_batch.GetCount() >= MAX_BATCH_SIZE)
+			{
+				Flush();
+			}
+		}
 
-					delete entry;
-					entry = in.GetNextEntry();
+		void WalkFolder(const wxString& folder)
+		{
+			Flush(); // Whatever was found so far belongs to the previous folder.
+			_currentFolder = folder;
+			Flush(true); // Report the progress (and let the consumer stop the walk) even if this folder has no files of its own.
+
+			wxArrayString subfolders;
+
+			{
+				wxDir dir(folder);
+				if (!dir.IsOpened())
+				{
+					return;
+				}
+
+				const wxString prefix = dir.GetNameWithSep();
+				wxString name;
+
+				// Files first, then the subfolders (same as the wxDir::GetAllFiles)
+				for (bool found = dir.GetFirst(&name, wxEmptyString, wxDIR_FILES | wxDIR_HIDDEN); found && !_stopped; found = dir.GetNext(&name))
+				{
+					AddPath(prefix + name);
+				}
+
+				for (bool found = dir.GetFirst(&name, wxEmptyString, wxDIR_DIRS | wxDIR_HIDDEN); found; found = dir.GetNext(&name))
+				{
+					subfolders.push_back(prefix + name);
+				}
+			}
+
+			for (const wxString& subfolder : subfolders)
+			{
+				if (_stopped)
+				{
+					return;
 				}
 
-				in.CloseEntry();
+				WalkFolder(subfolder);
 			}
 		}
 
-		return flatfileList;
-	}
+		void Flush(bool evenIfEmpty = false)
+		{
+			if (!_stopped && (evenIfEmpty || !_batch.IsEmpty()))
+			{
+				_stopped = !_sink(_batch, _currentFolder);
+			}
+
+			_batch.Clear();
+		}
+
+	private:
+		const Helpers::Wx::Files::DiscoveryBatchSink& _sink;
+		const wxString _selfExecutablePath;
+
+		wxArrayString _batch;
+		wxString _currentFolder;
+		bool _stopped = false;
+	};
 }
 
 namespace Helpers
@@ -136,56 +251,23 @@ namespace Helpers
 
 			wxArrayString GetValidFiles(const wxArrayString& rawFileList)
 			{
-				const wxString& selfExecutablePath = wxStandardPaths::Get().GetExecutablePath();
-
 				wxArrayString filesChecked;
-				for (const wxString& fileOrFolder : rawFileList)
+				DiscoverValidFiles(rawFileList, [&filesChecked](const wxArrayString& batch, const wxString& /*currentFolder*/)
 				{
-					if (wxFileExists(fileOrFolder))
-					{
-						if (IsZipFile(fileOrFolder))
-						{
-							const wxArrayString& result = GetFilesInZip(fileOrFolder); // Files are obtained in a "flat" manner (no need for recursion for folders).
-							filesChecked.reserve(filesChecked.GetCount() + result.GetCount());
-							std::copy(result.begin(), result.end(), std::back_inserter(filesChecked));
-						}
-						else if (fileOrFolder.EndsWith(Helpers::Wx::Files::FILE_EXTENSION_PLAYLIST)) // Playlist file
-						{
-							const wxArrayString& filesInPlaylist = Helpers::Wx::Files::LoadPathsFromPlaylist(fileOrFolder);
-							filesChecked.reserve(filesChecked.GetCount() + filesInPlaylist.GetCount());
-							std::copy(filesInPlaylist.begin(), filesInPlaylist.end(), std::back_inserter(filesChecked));
-						}
-						else // Plain file
-						{
-							if (fileOrFolder != selfExecutablePath)
-							{
-								filesChecked.push_back(fileOrFolder);
-							}
-						}
-					}
-					else if (IsWithinZipFile(fileOrFolder))
-					{
-						const wxString& archiveFilename = SplitZipArchiveAndFileNames(fileOrFolder).first;
-						if (wxFileExists(archiveFilename))
-						{
-							filesChecked.push_back(fileOrFolder);
-						}
-					}
-					else if (wxDirExists(fileOrFolder))
-					{
-						// Neccessary in order to process any encountered Zip files.
-						wxArrayString filesInFolder;
-						wxDir::GetAllFiles(fileOrFolder, &filesInFolder);
-						filesInFolder = GetValidFiles(filesInFolder);
-
-						filesChecked.reserve(filesChecked.GetCount() + filesInFolder.GetCount());
-						std::copy(filesInFolder.begin(), filesInFolder.end(), std::back_inserter(filesChecked));
-					}
-				}
+					filesChecked.reserve(filesChecked.GetCount() + batch.GetCount());
+					std::copy(batch.begin(), batch.end(), std::back_inserter(filesChecked));
+					return true;
+				});
 
 				return filesChecked;
 			}
 
+			void DiscoverValidFiles(const wxArrayString& rawFileList, const DiscoveryBatchSink& sink)
+			{
+				ValidFilesWalker walker(sink);
+				walker.Walk(rawFileList);
+			}
+
 			std::pair<wxString, wxString> SplitZipArchiveAndFileNames(const wxString& filename)
 			{
 				const size_t toExt = filename.find(FILE_EXTENSION_ZIP);
@@ -199,39 +281,29 @@ namespace Helpers
 				return std::pair<wxString, wxString>(zipArchive, zipFile);
 			}
 
-			std::unique_ptr<BufferHolder> GetFileContentFromZip(const wxString& filename)
+			std::unique_ptr<BufferHolder> GetFileContentFromZip(const wxString& filename, bool populateCache)
 			{
 				assert(IsWithinZipFile(filename));
 				std::unique_ptr<BufferHolder> bufferHolder;
 
 				const auto& archiveAndFile = SplitZipArchiveAndFileNames(filename);
 
-				wxFileSystem fs;
-				fs.ChangePathTo(archiveAndFile.first); // Prevent OpenFile from trying relative scope first (always in vain). This yields some speed boost.
-				wxString filenameOnly = archiveAndFile.first;
-				filenameOnly.Replace("\\", "/");
-				if (!fs.GetPath().IsEmpty())
-				{
-					filenameOnly.Replace(fs.GetPath(), "");
-				}
-
-				wxFSFile* zip = fs.OpenFile(wxString::Format("%s#zip:%s", filenameOnly, archiveAndFile.second), wxFS_READ);
-				if (zip != NULL)
+				TuneBufferCache::Stamp stamp;
+				const bool cacheable = TryGetFileStamp(filename, stamp.modified, stamp.size);
+				if (cacheable)
 				{
-					wxInputStream* in = zip->GetStream();
-
-					const size_t zipStreamSize = in->GetSize();
-
-					if (zipStreamSize != 0)
+					bufferHolder = tuneBufferCache.TryGet(filename.ToStdWstring(), stamp);
+					if (bufferHolder != nullptr)
 					{
-						bufferHolder = std::make_unique<BufferHolder>(zipStreamSize);
-						if (!in->ReadAll(bufferHolder->buffer[0], bufferHolder->size[0]))
-						{
-							bufferHolder = nullptr;
-						}
+						return bufferHolder; // Skips both the I/O and the inflation.
 					}
+				}
+
+				bufferHolder = zipArchiveIndex.TryRead(archiveAndFile.first, archiveAndFile.second);
 
-					delete zip;
+				if (populateCache && cacheable && bufferHolder != nullptr)
+				{
+					tuneBufferCache.Put(filename.ToStdWstring(), stamp, *bufferHolder);
 				}
 
 				return bufferHolder;
@@ -243,25 +315,30 @@ namespace Helpers
 
 				const auto& archiveAndFile = SplitZipArchiveAndFileNames(filename);
 
-				wxFileSystem fs;
-				fs.ChangePathTo(archiveAndFile.first); // Prevent OpenFile from trying relative scope first (always in vain). This yields some speed boost.
-				wxString filenameOnly = archiveAndFile.first;
-				filenameOnly.Replace("\\", "/");
-				if (!fs.GetPath().IsEmpty())
+				TuneBufferCache::Stamp stamp;
+				if (TryGetFileStamp(filename, stamp.modified, stamp.size) && tuneBufferCache.Contains(filename.ToStdWstring(), stamp))
 				{
-					filenameOnly.Replace(fs.GetPath(), "");
+					return true;
 				}
 
-				wxFSFile* zip = fs.OpenFile(wxString::Format("%s#zip:%s", filenameOnly, archiveAndFile.second), wxFS_READ);
-				const bool exists = zip != nullptr;
-				delete zip;
-				return exists;
+				return zipArchiveIndex.Contains(archiveAndFile.first, archiveAndFile.second);
 			}
 
-			std::unique_ptr<BufferHolder> GetFileContentFromDisk(const wxString& filename)
+			std::unique_ptr<BufferHolder> GetFileContentFromDisk(const wxString& filename, bool populateCache)
 			{
 				std::unique_ptr<BufferHolder> bufferHolder;
 
+				TuneBufferCache::Stamp stamp;
+				const bool cacheable = TryGetFileStamp(filename, stamp.modified, stamp.size);
+				if (cacheable)
+				{
+					bufferHolder = tuneBufferCache.TryGet(filename.ToStdWstring(), stamp);
+					if (bufferHolder != nullptr)
+					{
+						return bufferHolder;
+					}
+				}
+
 				wxFileSystem fs;
 				fs.ChangePathTo(wxFileName(filename).GetPath()); // Prevent OpenFile from trying relative scope first (always in vain). This yields some speed boost.
 				wxFSFile* file = fs.OpenFile(filename, wxFS_READ);
@@ -283,9 +360,76 @@ namespace Helpers
 					delete file;
 				}
 
+				if (populateCache && cacheable && bufferHolder != nullptr)
+				{
+					tuneBufferCache.Put(filename.ToStdWstring(), stamp, *bufferHolder);
+				}
+
 				return bufferHolder;
 			}
 
+			std::unique_ptr<BufferHolder> GetTuneContent(const wxString& filename, const wxString& musCompanionStrFilePath, bool populateCache)
+			{
+				const auto load = [populateCache](const wxString& filepath)
+				{
+					return (IsWithinZipFile(filepath)) ? GetFileContentFromZip(filepath, populateCache) : GetFileContentFromDisk(filepath, populateCache);
+				};
+
+				std::unique_ptr<BufferHolder> bufferHolder = load(filename);
+				if (bufferHolder == nullptr || musCompanionStrFilePath.IsEmpty())
+				{
+					return bufferHolder;
+				}
+
+				const std::unique_ptr<BufferHolder> strBufferHolder = load(musCompanionStrFilePath);
+				if (strBufferHolder != nullptr)
+				{
+					bufferHolder->buffer[1] = new uint_least8_t[strBufferHolder->size[0]];
+					std::memcpy(bufferHolder->buffer[1], strBufferHolder->buffer[0], strBufferHolder->size[0] * sizeof(uint_least8_t));
+					bufferHolder->size[1] = strBufferHolder->size[0];
+				}
+
+				return bufferHolder;
+			}
+
+			wxString MakeUniqueOutputPath(const wxString& outFolder, const wxString& tuneFilepath, int subsong, const wxString& extension, std::set<wxString>& usedNames)
+			{
+				wxString stem = wxFileName(tuneFilepath).GetName(); // Also fine for the files within a zip.
+				if (subsong > 0)
+				{
+					stem.Append(wxString::Format(" (%i)", subsong));
+				}
+
+				wxString name = stem;
+				for (int i = 2; !usedNames.insert(name.Lower()).second; ++i)
+				{
+					name = wxString::Format("%s_%i", stem, i);
+				}
+
+				return wxFileName(outFolder, name, extension).GetFullPath();
+			}
+
+			bool TryGetFileStamp(const wxString& filename, int64_t& outModified, uint64_t& outSize)
+			{
+				const wxString& path = (IsWithinZipFile(filename)) ? SplitZipArchiveAndFileNames(filename).first : filename;
+
+				const time_t modified = wxFileModificationTime(path);
+				const wxULongLong size = wxFileName::GetSize(path);
+				if (modified == -1 || size == wxInvalidSize)
+				{
+					return false;
+				}
+
+				outModified = static_cast<int64_t>(modified);
+				outSize = size.GetValue();
+				return true;
+			}
+
+			void SetTuneCacheBudget(size_t budgetBytes)
+			{
+				tuneBufferCache.SetBudget(budgetBytes);
+			}
+
 			bool TrySavePlaylist(wxString fullpath, const std::vector<wxString>& fileList)
 			{
 				if (fullpath == DEFAULT_PLAYLIST_NAME)
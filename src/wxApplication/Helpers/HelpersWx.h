@@ -34,7 +34,10 @@
 #include <wx/zipstrm.h>
 #include <wx/wfstream.h>
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <set>
 #include <string>
 
 namespace Helpers
@@ -113,11 +116,20 @@ namespace Helpers
 			static const std::string FILE_EXTENSION_ZIP = ".zip";
 			static const std::string FILE_EXTENSION_PLAYLIST = ".m3u8";
 			static const std::string DEFAULT_PLAYLIST_NAME = "default" + FILE_EXTENSION_PLAYLIST;
+			static const std::string DEFAULT_PLAYLIST_METADATA_CACHE_NAME = DEFAULT_PLAYLIST_NAME + ".cache";
+			static const std::string DEFAULT_PRERENDER_CACHE_FOLDER_NAME = "prerender-cache";
+			static const std::string DEFAULT_ESTIMATED_SONGLENGTHS_NAME = "Songlengths-estimated.md5";
 
 			wxString AsAbsolutePathIfPossible(const wxString& relPath);
 			wxString AsRelativePathIfPossible(const wxString& absPath);
 			wxArrayString GetValidFiles(const wxArrayString& rawFileList);
 
+			/// @brief Receives a batch of the discovered files (can be empty when just reporting the progress) along with the folder being walked (empty if none). Return false to stop the discovery.
+			using DiscoveryBatchSink = std::function<bool(const wxArrayString& batch, const wxString& currentFolder)>;
+
+			/// @brief Incremental GetValidFiles: the folders are walked one at a time and the valid files are passed on in batches as they're found (same order as GetValidFiles).
+			void DiscoverValidFiles(const wxArrayString& rawFileList, const DiscoveryBatchSink& sink);
+
 			inline bool IsZipFile(const wxString& filename)
 			{
 				return filename.Lower().ends_with(FILE_EXTENSION_ZIP);
@@ -130,10 +142,24 @@ namespace Helpers
 			bool FileExistsInZipArchive(const wxString& filename);
 
 			std::pair<wxString, wxString> SplitZipArchiveAndFileNames(const wxString& filename);
-			std::unique_ptr<BufferHolder> GetFileContentFromZip(const wxString& filename);
+
+			/// @brief Served from the tune cache if it's there. Only the playback loads should populateCache, otherwise the bulk reads (the playlist ingest, the estimation, the exports) would flush the recently played tunes out of it.
+			std::unique_ptr<BufferHolder> GetFileContentFromZip(const wxString& filename, bool populateCache = false);
 
 			/// @brief Like GetFileContentFromZip but for regular files, supporting unicode paths (can't just naively load them directly via libsidplayfp's loader unfortunately due to lack of unicode paths support there).
-			std::unique_ptr<BufferHolder> GetFileContentFromDisk(const wxString& filename);
+			std::unique_ptr<BufferHolder> GetFileContentFromDisk(const wxString& filename, bool populateCache = false);
+
+			/// @brief Loads a tune from the disk or from within a Zip archive. For a MUS+STR pair, the STR goes into the second buffer.
+			std::unique_ptr<BufferHolder> GetTuneContent(const wxString& filename, const wxString& musCompanionStrFilePath, bool populateCache = false);
+
+			/// @brief Output file path named after the tune (and the subsong, if non-zero), made unique against the usedNames (which it gets added to).
+			wxString MakeUniqueOutputPath(const wxString& outFolder, const wxString& tuneFilepath, int subsong, const wxString& extension, std::set<wxString>& usedNames);
+
+			/// @brief Modification time and size of the file (or of the containing archive for the files within a Zip archive, as its entries can only change along with it).
+			bool TryGetFileStamp(const wxString& filename, int64_t& outModified, uint64_t& outSize);
+
+			/// @brief Sets the memory budget of the LRU cache behind the GetFileContentFromZip/GetFileContentFromDisk (0 = disabled).
+			void SetTuneCacheBudget(size_t budgetBytes);
 
 			bool TrySavePlaylist(wxString fullpath, const std::vector<wxString>& fileList);
 			wxArrayString LoadPathsFromPlaylist(const wxString& fullpath);
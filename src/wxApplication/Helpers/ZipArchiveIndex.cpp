@@ -0,0 +1,181 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "ZipArchiveIndex.h"
+
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+
+#include <algorithm>
+
+namespace
+{
+	/// @brief Indexes of the least recently used archives are dropped beyond this count (HVSC alone is ~60k entries).
+	static constexpr size_t MAX_INDEXED_ARCHIVES = 32;
+}
+
+wxArrayString ZipArchiveIndex::GetEntryNames(const wxString& archivePath)
+{
+	wxArrayString names;
+
+	const ArchivePtr archive = GetArchive(archivePath);
+	if (archive != nullptr)
+	{
+		names.reserve(archive->entries.size());
+		for (const std::unique_ptr<wxZipEntry>& entry : archive->entries)
+		{
+			names.push_back(entry->GetName());
+		}
+	}
+
+	return names;
+}
+
+bool ZipArchiveIndex::Contains(const wxString& archivePath, const wxString& entryName)
+{
+	const ArchivePtr archive = GetArchive(archivePath);
+	return archive != nullptr && TryFindEntry(*archive, entryName) != nullptr;
+}
+
+std::unique_ptr<BufferHolder> ZipArchiveIndex::TryRead(const wxString& archivePath, const wxString& entryName)
+{
+	const ArchivePtr archive = GetArchive(archivePath);
+	const wxZipEntry* const indexedEntry = (archive == nullptr) ? nullptr : TryFindEntry(*archive, entryName);
+	if (indexedEntry == nullptr || indexedEntry->GetSize() <= 0)
+	{
+		return nullptr;
+	}
+
+	wxFFileInputStream file(archivePath);
+	if (!file.IsOk())
+	{
+		return nullptr;
+	}
+
+	// OpenEntry needs a mutable entry, and the indexed one is shared between the threads: a copy shares its extra field buffers (refcounted non-atomically), so it's made and detached from them under the lock.
+	// Reminder: OpenEntry reads the local header anyway, so the copy doesn't need them.
+	wxZipEntry entry;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		entry = *indexedEntry;
+		entry.SetExtra(nullptr, 0);
+		entry.SetLocalExtra(nullptr, 0);
+	}
+
+	wxZipInputStream zip(file);
+	if (!zip.OpenEntry(entry))
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<BufferHolder> bufferHolder = std::make_unique<BufferHolder>(static_cast<size_t>(entry.GetSize()));
+	if (!zip.ReadAll(bufferHolder->buffer[0], bufferHolder->size[0]))
+	{
+		return nullptr;
+	}
+
+	return bufferHolder;
+}
+
+void ZipArchiveIndex::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_archives.clear();
+}
+
+ZipArchiveIndex::ArchivePtr ZipArchiveIndex::GetArchive(const wxString& archivePath)
+{
+	const time_t modified = wxFileModificationTime(archivePath);
+	const wxULongLong size = wxFileName::GetSize(archivePath);
+	if (modified == -1 || size == wxInvalidSize)
+	{
+		return nullptr;
+	}
+
+	const std::wstring key = archivePath.ToStdWstring();
+
+	std::lock_guard<std::mutex> lock(_mutex); // Also held while parsing, so that the concurrent first accesses don't all parse the same archive.
+
+	const auto it = _archives.find(key);
+	if (it != _archives.end() && it->second.archive->modified == modified && it->second.archive->size == size)
+	{
+		it->second.lastUsed = ++_useCounter;
+		return it->second.archive;
+	}
+
+	ArchivePtr archive = TryParseArchive(archivePath, modified, size);
+	if (archive == nullptr)
+	{
+		if (it != _archives.end())
+		{
+			_archives.erase(it);
+		}
+
+		return nullptr;
+	}
+
+	if (it == _archives.end() && _archives.size() >= MAX_INDEXED_ARCHIVES)
+	{
+		const auto leastRecentlyUsed = std::min_element(_archives.begin(), _archives.end(), [](const auto& a, const auto& b) { return a.second.lastUsed < b.second.lastUsed; });
+		_archives.erase(leastRecentlyUsed);
+	}
+
+	_archives[key] = CachedArchive{archive, ++_useCounter};
+	return archive;
+}
+
+ZipArchiveIndex::ArchivePtr ZipArchiveIndex::TryParseArchive(const wxString& archivePath, time_t modified, const wxULongLong& size)
+{
+	wxFFileInputStream file(archivePath);
+	if (!file.IsOk())
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<Archive> archive = std::make_shared<Archive>();
+	archive->modified = modified;
+	archive->size = size;
+
+	wxZipInputStream zip(file); // The file stream is seekable, so the entries come straight from the central directory (no local headers are walked and nothing is inflated).
+	const int totalEntries = zip.GetTotalEntries();
+	if (totalEntries > 0)
+	{
+		archive->entries.reserve(totalEntries);
+		archive->entryIndexByInternalName.reserve(totalEntries);
+	}
+
+	std::unique_ptr<wxZipEntry> entry(zip.GetNextEntry());
+	while (entry != nullptr)
+	{
+		if (!entry->IsDir())
+		{
+			archive->entryIndexByInternalName.emplace(entry->GetInternalName().ToStdWstring(), archive->entries.size());
+			archive->entries.emplace_back(std::move(entry));
+		}
+
+		entry.reset(zip.GetNextEntry());
+	}
+
+	return archive;
+}
+
+const wxZipEntry* ZipArchiveIndex::TryFindEntry(const Archive& archive, const wxString& entryName)
+{
+	const auto it = archive.entryIndexByInternalName.find(wxZipEntry::GetInternalName(entryName).ToStdWstring());
+	return (it == archive.entryIndexByInternalName.cend()) ? nullptr : archive.entries[it->second].get();
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "../../Util/BufferHolder.h"
+
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+	#include <wx/wx.h>
+#endif
+
+#include <wx/zipstrm.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Parses the Zip central directory once per archive into an in-memory table (re-parsed only if the archive file changes), so that the entry enumeration and existence checks are lookups and the reads seek directly to the entry instead of going through the wx "#zip:" virtual filesystem.
+/// Thread-safe: the reads don't share any stream state, so they can run concurrently (e.g., from the playlist ingest workers). The indexed entries are only ever copied under the _mutex.
+class ZipArchiveIndex
+{
+public:
+	ZipArchiveIndex() = default;
+	ZipArchiveIndex(ZipArchiveIndex&) = delete;
+
+	ZipArchiveIndex operator=(const ZipArchiveIndex&) = delete;
+
+public:
+	/// @brief Returns the names (native path format) of all non-directory entries in the archive order. Empty if the archive can't be read.
+	wxArrayString GetEntryNames(const wxString& archivePath);
+
+	bool Contains(const wxString& archivePath, const wxString& entryName);
+
+	/// @brief Returns nullptr if the entry doesn't exist, is empty, or fails to inflate (including the CRC check).
+	std::unique_ptr<BufferHolder> TryRead(const wxString& archivePath, const wxString& entryName);
+
+	void Clear();
+
+private:
+	struct Archive
+	{
+		time_t modified = 0;
+		wxULongLong size = 0;
+
+		std::vector<std::unique_ptr<wxZipEntry>> entries; // Archive order, directories excluded.
+		std::unordered_map<std::wstring, size_t> entryIndexByInternalName;
+	};
+
+	using ArchivePtr = std::shared_ptr<const Archive>;
+
+	struct CachedArchive
+	{
+		ArchivePtr archive;
+		uint64_t lastUsed = 0;
+	};
+
+private:
+	/// @brief Returns the up-to-date index for the archive (parsing it if needed), or nullptr if the archive can't be read.
+	ArchivePtr GetArchive(const wxString& archivePath);
+	static ArchivePtr TryParseArchive(const wxString& archivePath, time_t modified, const wxULongLong& size);
+	static const wxZipEntry* TryFindEntry(const Archive& archive, const wxString& entryName);
+
+private:
+	std::mutex _mutex;
+	std::unordered_map<std::wstring, CachedArchive> _archives;
+	uint64_t _useCounter = 0;
+};
@@ -18,6 +18,7 @@
 
 #include "MyApp.h"
 #include "Config/AppSettings.h"
+#include "Config/PlaybackConfig.h"
 #include "Config/UIStrings.h"
 #include "Helpers/HelpersWx.h"
 #include "SingleInstanceManager/IpcSetup.h"
@@ -36,63 +37,6 @@ namespace
         wxMessageBox(errMessage + additionalInfo, Strings::FramePlayer::WINDOW_TITLE, wxICON_ERROR);
     }
 
-    struct ExtractedC64ModelSetting
-    {
-        ExtractedC64ModelSetting() = delete;
-        explicit ExtractedC64ModelSetting(Settings::AppSettings& settings)
-        {
-            using DefaultC64Model = Settings::AppSettings::DefaultC64Model;
-
-            const int intValue = settings.GetOption(Settings::AppSettings::ID::DefaultC64Model)->GetValueAsInt();
-            const DefaultC64Model c64ModelOption = static_cast<DefaultC64Model>(intValue);
-
-            if (c64ModelOption == Settings::AppSettings::DefaultC64Model::Prefer_PAL || c64ModelOption == DefaultC64Model::Force_PAL)
-            {
-                defaultC64Model = SidConfig::c64_model_t::PAL;
-            }
-            else if (c64ModelOption == DefaultC64Model::Prefer_NTSC || c64ModelOption == DefaultC64Model::Force_NTSC)
-            {
-                defaultC64Model = SidConfig::c64_model_t::NTSC;
-            }
-            else if (c64ModelOption == DefaultC64Model::Prefer_Old_NTSC || c64ModelOption == DefaultC64Model::Force_Old_NTSC)
-            {
-                defaultC64Model = SidConfig::c64_model_t::OLD_NTSC;
-            }
-            else if (c64ModelOption == DefaultC64Model::Prefer_Drean || c64ModelOption == DefaultC64Model::Force_Drean)
-            {
-                defaultC64Model = SidConfig::c64_model_t::DREAN;
-            }
-            else if (c64ModelOption == DefaultC64Model::Prefer_PAL_M || c64ModelOption == DefaultC64Model::Force_PAL_M)
-            {
-                defaultC64Model = SidConfig::c64_model_t::PAL_M;
-            }
-
-            forceC64Model = intValue >= static_cast<int>(DefaultC64Model::Force_PAL);
-        };
-
-        SidConfig::c64_model_t defaultC64Model = SidConfig::c64_model_t::PAL;
-        bool forceC64Model = false;
-    };
-
-    struct ExtractedSidModelSetting
-    {
-        ExtractedSidModelSetting() = delete;
-        explicit ExtractedSidModelSetting(Settings::AppSettings& settings)
-        {
-            using DefaultSidModel = Settings::AppSettings::DefaultSidModel;
-            const DefaultSidModel sidModelOption = static_cast<DefaultSidModel>(settings.GetOption(Settings::AppSettings::ID::DefaultSidModel)->GetValueAsInt());
-            if ((sidModelOption == DefaultSidModel::Prefer_MOS8580) || (sidModelOption == DefaultSidModel::Force_MOS8580))
-            {
-                defaultSidModel = SidConfig::sid_model_t::MOS8580;
-            }
-
-            forceSidModel = (sidModelOption == DefaultSidModel::Force_MOS6581) || (sidModelOption == DefaultSidModel::Force_MOS8580);
-        };
-
-        SidConfig::sid_model_t defaultSidModel = SidConfig::sid_model_t::MOS6581;
-        bool forceSidModel = false;
-    };
-
     PortAudioOutput::AudioConfig LoadAudioConfig(Settings::AppSettings& settings)
     {
         PortAudioOutput::AudioConfig audioConfig;
@@ -109,35 +53,10 @@ namespace
         audioConfig.channelCount = (outChannelsMode == Settings::AppSettings::OutChannels::ForceMono) ? 1 : 2;
         audioConfig.sampleRate = Pa_GetDeviceInfo(audioConfig.preferredOutputDevice)->defaultSampleRate;
         audioConfig.lowLatency = settings.GetOption(Settings::AppSettings::ID::LowLatency)->GetValueAsBool();
+        audioConfig.decoupledRenderDepthMs = settings.GetOption(Settings::AppSettings::ID::DecoupledRenderDepth)->GetValueAsInt();
 
         return audioConfig;
     }
-
-    SidConfig LoadSidConfig(SidConfig baseSidConfig, Settings::AppSettings& settings)
-    {
-        const ExtractedSidModelSetting sidModelSetting(settings);
-        baseSidConfig.defaultSidModel = sidModelSetting.defaultSidModel;
-        baseSidConfig.forceSidModel = sidModelSetting.forceSidModel;
-
-        const ExtractedC64ModelSetting c64ModelSetting(settings);
-        baseSidConfig.defaultC64Model = c64ModelSetting.defaultC64Model;
-        baseSidConfig.forceC64Model = c64ModelSetting.forceC64Model;
-
-        baseSidConfig.digiBoost = settings.GetOption(Settings::AppSettings::ID::DigiBoost)->GetValueAsBool();
-        baseSidConfig.powerOnDelay = 16; // Force predictable powerOnDelay, 16 should be minimal stable value and also so low (microseconds) that we don't have to account for it.
-
-        return baseSidConfig;
-    }
-
-    PlaybackController::FilterConfig LoadFilterConfig(Settings::AppSettings& settings)
-    {
-        return {
-            settings.GetOption(Settings::AppSettings::ID::FilterCurve6581)->GetValueAsDouble(),
-            settings.GetOption(Settings::AppSettings::ID::FilterRange6581)->GetValueAsDouble(),
-            settings.GetOption(Settings::AppSettings::ID::FilterCurve8580)->GetValueAsDouble(),
-            settings.GetOption(Settings::AppSettings::ID::Old6581caps)->GetValueAsBool()
-        };
-    }
 }
 
 bool MyApp::OnInit()
@@ -159,12 +78,14 @@ bool MyApp::OnInit()
     else // Normal init
     {
         wxFileSystem::AddHandler(new wxZipFSHandler);
+        Helpers::Wx::Files::SetTuneCacheBudget(static_cast<size_t>(currentSettings->GetOption(Settings::AppSettings::ID::TuneCacheBudget)->GetValueAsInt()) * 1024 * 1024);
         _playback = std::make_unique<PlaybackController>(); // Must be pre-init here in order for Pa_* methods to be usable immediately.
+        RefreshPreRenderDiskCache();
 
         const bool useNtscForMus = currentSettings->GetOption(Settings::AppSettings::ID::UseNtscForMus)->GetValueAsBool();
         const bool initSuccess = _playback->TryInit(PlaybackController::SyncedPlaybackConfig(LoadAudioConfig(*currentSettings),
-                                                                                             LoadSidConfig(SidConfig(), *currentSettings),
-                                                                                             LoadFilterConfig(*currentSettings),
+                                                                                             Settings::LoadSidConfig(SidConfig(), *currentSettings),
+                                                                                             Settings::LoadFilterConfig(*currentSettings),
                                                                                              useNtscForMus)
         );
 
@@ -289,34 +210,15 @@ void MyApp::Play(const wxString& filename, unsigned int subsong, int preRenderDu
 
     PlaybackController::PlaybackAttemptStatus status = PlaybackController::PlaybackAttemptStatus::Success;
 
+    if (IsNextPrepared(filename, subsong, preRenderDurationMs, musCompanionStrFilePath))
     {
-        std::unique_ptr<BufferHolder> bufferHolder;
-        std::unique_ptr<BufferHolder> temp;
-
-        if (Helpers::Wx::Files::IsWithinZipFile(filename))
-        {
-            bufferHolder = Helpers::Wx::Files::GetFileContentFromZip(filename);
-            if (!musCompanionStrFilePath.IsEmpty())
-            {
-                temp = Helpers::Wx::Files::GetFileContentFromZip(musCompanionStrFilePath);
-            }
-        }
-        else
-        {
-            bufferHolder = Helpers::Wx::Files::GetFileContentFromDisk(filename);
-            if (!musCompanionStrFilePath.IsEmpty())
-            {
-                temp = Helpers::Wx::Files::GetFileContentFromDisk(musCompanionStrFilePath);
-            }
-        }
-
-        if (temp != nullptr)
-        {
-            bufferHolder->buffer[1] = new uint_least8_t[temp->size[0]];
-            std::memcpy(bufferHolder->buffer[1], temp->buffer[0], temp->size[0] * sizeof(uint_least8_t));
-            bufferHolder->size[1] = temp->size[0];
-        }
+        status = _playback->TryPlayNext(); // Already loaded (and pre-rendered if applicable) in the background.
+    }
+    else
+    {
+        _playback->DiscardNext(); // Stale (the playlist, the repeat mode or the settings changed in the meantime).
 
+        std::unique_ptr<BufferHolder> bufferHolder = Helpers::Wx::Files::GetTuneContent(filename, musCompanionStrFilePath, true);
         status = (bufferHolder == nullptr) ? PlaybackController::PlaybackAttemptStatus::InputError : _playback->TryPlayFromBuffer(filename.ToStdWstring(), bufferHolder, subsong, preRenderDurationMs);
     }
 
@@ -338,6 +240,29 @@ void MyApp::Play(const wxString& filename, unsigned int subsong, int preRenderDu
     }
 }
 
+void MyApp::PrepareNext(const wxString& filename, unsigned int subsong, int preRenderDurationMs, const wxString& musCompanionStrFilePath)
+{
+    assert(_playback != nullptr);
+
+    if (IsNextPrepared(filename, subsong, preRenderDurationMs, musCompanionStrFilePath))
+    {
+        return;
+    }
+
+    std::unique_ptr<BufferHolder> bufferHolder = Helpers::Wx::Files::GetTuneContent(filename, musCompanionStrFilePath, true);
+    if (bufferHolder == nullptr || !_playback->TryPrepareNext(filename.ToStdWstring(), bufferHolder, subsong, preRenderDurationMs))
+    {
+        _playback->DiscardNext(); // Silently, the regular playback attempt will report the error when (and if) it comes to it.
+    }
+
+    _preparedNextMusCompanionStrFilePath = musCompanionStrFilePath;
+}
+
+bool MyApp::IsNextPrepared(const wxString& filename, unsigned int subsong, int preRenderDurationMs, const wxString& musCompanionStrFilePath) const
+{
+    return musCompanionStrFilePath == _preparedNextMusCompanionStrFilePath && _playback->IsNextPrepared(filename.ToStdWstring(), subsong, preRenderDurationMs);
+}
+
 void MyApp::ReplayLoadedTune(int preRenderDurationMs, bool reusePreRender)
 {
     StopPlayback();
@@ -381,9 +306,9 @@ void MyApp::SetVolume(float volume)
     _playback->SetVolume(volume);
 }
 
-void MyApp::SeekTo(uint_least32_t timeMs)
+void MyApp::SeekTo(uint_least32_t timeMs, uint_least32_t songDurationMs)
 {
-    _playback->SeekTo(timeMs);
+    _playback->SeekTo(timeMs, songDurationMs);
 }
 
 void MyApp::SetPlaybackSpeed(double factor)
@@ -422,31 +347,22 @@ void MyApp::RefreshVirtualStereoState()
 
 void MyApp::RefreshChannelMatrix()
 {
-    MultiSidChannelMatrix newMatrix;
+    PlaybackController::ChannelMatrixConfig newConfig;
 
     Settings::AppSettings::OutChannels outChannelsMode = static_cast<Settings::AppSettings::OutChannels>(currentSettings->GetOption(Settings::AppSettings::ID::OutChannels)->GetValueAsInt());
     if (outChannelsMode != Settings::AppSettings::OutChannels::ForceMono)
     {
-        const bool shouldFlattenCurrentMultiSidTune = outChannelsMode == Settings::AppSettings::OutChannels::VirtualStereo && _playback->GetCurrentTuneSidChipsRequired() > 1 && currentSettings->GetOption(Settings::AppSettings::ID::VirtualStereoMultiSid)->GetValueAsBool();
-        if (!shouldFlattenCurrentMultiSidTune)
-        {
-            // 2SID
-            newMatrix.tune2Sid_First.left = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_FirstLeft)->GetValueAsFloat();
-            newMatrix.tune2Sid_First.right = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_FirstRight)->GetValueAsFloat();
-            newMatrix.tune2Sid_Second.left = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_SecondLeft)->GetValueAsFloat();
-            newMatrix.tune2Sid_Second.right = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_2Sid_SecondRight)->GetValueAsFloat();
-
-            // 3SID
-            newMatrix.tune3Sid_First.left = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_FirstLeft)->GetValueAsFloat();
-            newMatrix.tune3Sid_First.right = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_FirstRight)->GetValueAsFloat();
-            newMatrix.tune3Sid_Second.left = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_SecondLeft)->GetValueAsFloat();
-            newMatrix.tune3Sid_Second.right = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_SecondRight)->GetValueAsFloat();
-            newMatrix.tune3Sid_Third.left = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_ThirdLeft)->GetValueAsFloat();
-            newMatrix.tune3Sid_Third.right = currentSettings->GetOption(Settings::AppSettings::ID::PanMatrix_3Sid_ThirdRight)->GetValueAsFloat();
-        }
+        newConfig.matrix = Settings::LoadMultiSidChannelMatrix(*currentSettings);
+        newConfig.flattenMultiSid = outChannelsMode == Settings::AppSettings::OutChannels::VirtualStereo && currentSettings->GetOption(Settings::AppSettings::ID::VirtualStereoMultiSid)->GetValueAsBool(); // The playback controller resolves this per tune (incl. the prepared next one).
     }
 
-    _playback->SetChannelMatrix(newMatrix);
+    _playback->SetChannelMatrix(newConfig);
+}
+
+void MyApp::RefreshPreRenderDiskCache()
+{
+    const uint64_t capBytes = static_cast<uint64_t>(currentSettings->GetOption(Settings::AppSettings::ID::PreRenderCacheSize)->GetValueAsInt()) * 1024 * 1024;
+    _playback->SetPreRenderDiskCache(Helpers::Wx::Files::GetConfigFilePath(Helpers::Wx::Files::DEFAULT_PRERENDER_CACHE_FOLDER_NAME).ToStdWstring(), capBytes);
 }
 
 const PlaybackController& MyApp::GetPlaybackInfo() const
@@ -458,8 +374,8 @@ bool MyApp::ReapplyPlaybackSettings()
 {
     const bool useNtscForMus = currentSettings->GetOption(Settings::AppSettings::ID::UseNtscForMus)->GetValueAsBool();
     const PlaybackController::SwitchAudioDeviceResult result =_playback->TrySwitchPlaybackConfiguration(PlaybackController::SyncedPlaybackConfig(LoadAudioConfig(*currentSettings),
-                                                                                                                                                 LoadSidConfig(_playback->GetSidConfig(), *currentSettings),
-                                                                                                                                                 LoadFilterConfig(*currentSettings),
+                                                                                                                                                 Settings::LoadSidConfig(_playback->GetSidConfig(), *currentSettings),
+                                                                                                                                                 Settings::LoadFilterConfig(*currentSettings),
                                                                                                                                                  useNtscForMus)
     );
 
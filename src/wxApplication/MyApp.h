@@ -52,6 +52,7 @@ private:
 
 public:
     void Play(const wxString& filename, unsigned int subsong, int preRenderDurationMs, const wxString& musCompanionStrFilePath); // TODO: PassKey or something to allow calling this by the TryPlayPlaylistItem method only?
+    void PrepareNext(const wxString& filename, unsigned int subsong, int preRenderDurationMs, const wxString& musCompanionStrFilePath); // Loads the tune in the background of the current playback for an immediate transition to it by the Play().
     void ReplayLoadedTune(int preRenderDurationMs, bool reusePreRender = false);
     void PausePlayback();
     void ResumePlayback();
@@ -59,7 +60,7 @@ public:
     void PlaySubsong(int subsong, int preRenderDurationMs);
 
     void SetVolume(float volume);
-    void SeekTo(uint_least32_t timeMs);
+    void SeekTo(uint_least32_t timeMs, uint_least32_t songDurationMs);
 
     void SetPlaybackSpeed(double factor);
 
@@ -72,6 +73,9 @@ public:
     /// @brief The Channel matrix state should not be changed during the playback *if* the Prerender (Instant seeking) mode is active. Otherwise it can be changed in the realtime during the playback, without limitations.
     void RefreshChannelMatrix();
 
+    /// @brief Applies the Instant seeking disk cache setting.
+    void RefreshPreRenderDiskCache();
+
     const PlaybackController& GetPlaybackInfo() const;
     bool ReapplyPlaybackSettings();
     void UnloadActiveTune();
@@ -95,6 +99,8 @@ private:
 
     void RunOnMainThread(std::function<void()> fn);
 
+    bool IsNextPrepared(const wxString& filename, unsigned int subsong, int preRenderDurationMs, const wxString& musCompanionStrFilePath) const;
+
     void FinalizePlaybackStarted();
     void PopSilencer();
 
@@ -107,4 +113,5 @@ private:
     std::unique_ptr<PlaybackController> _playback;
     std::unique_ptr<SingleInstanceManager> _instanceManager;
     std::unique_ptr<SimpleTimer> _popSilencer;
+    wxString _preparedNextMusCompanionStrFilePath; // The PlaybackController only knows whether the prepared tune is a MUS+STR pair, not which STR it's paired with.
 };
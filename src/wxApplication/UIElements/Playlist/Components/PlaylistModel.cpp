@@ -24,19 +24,19 @@
 // PlaylistTreeModelNode
 // ----------------------------------------------------------------------------
 
-PlaylistTreeModelNode::PlaylistTreeModelNode(unsigned int uid, PlaylistTreeModelNode* parent, const wxString& title, const wxString& filepath, int defaultSubsong, uint_least32_t duration, const wxString& hvscPath, const char* md5, const wxString& author, const wxString& copyright, RomRequirement romRequirement, bool playable, const wxString& musCompanionStrFilePath) :
+PlaylistTreeModelNode::PlaylistTreeModelNode(unsigned int uid, PlaylistTreeModelNode* parent, const wxString& title, const wxString& filepath, int defaultSubsong, uint_least32_t duration, const wxString& hvscPath, const wxString& md5, const wxString& author, const wxString& copyright, RomRequirement romRequirement, bool playable, const wxString& musCompanionStrFilePath) :
 	uid(uid),
 	_parent(parent),
 	title(title),
 	filepath(filepath),
 	defaultSubsong(defaultSubsong),
-	duration(duration),
 	hvscPath(hvscPath),
 	md5(md5),
 	author(author),
 	copyright(copyright),
 	type((parent == nullptr) ? ItemType::Song : ItemType::Subsong),
 	romRequirement(romRequirement),
+	_duration(duration),
 	_playable(playable),
 	musCompanionStrFilePath(musCompanionStrFilePath)
 {
@@ -52,6 +52,11 @@ PlaylistTreeModelNodePtrArray& PlaylistTreeModelNode::GetChildren()
 	return _children;
 }
 
+const PlaylistTreeModelNodePtrArray& PlaylistTreeModelNode::GetChildren() const
+{
+	return _children;
+}
+
 int PlaylistTreeModelNode::GetSubsongCount() const
 {
 	return _children.size();
@@ -82,6 +87,11 @@ bool PlaylistTreeModelNode::IsAutoPlayable() const
 	});
 }
 
+uint_least32_t PlaylistTreeModelNode::GetDuration() const
+{
+	return _duration;
+}
+
 PlaylistTreeModelNode::ItemTag PlaylistTreeModelNode::GetTag() const
 {
 	return _tag;
@@ -92,25 +102,30 @@ UIElements::Playlist::PlaylistIconId PlaylistTreeModelNode::GetIconId() const
 	return _iconId;
 }
 
-PlaylistTreeModelNode& PlaylistTreeModelNode::AddChild(PlaylistTreeModelNode* childToAdopt, PlaylistTreeModelNode::PassKey<UIElements::Playlist::Playlist>)
+bool PlaylistTreeModelNode::HasStyle(ItemStyle style) const
 {
-	assert(_parent == nullptr); // Adding children to children is unexpected usecase.
-	return *_children.emplace_back(childToAdopt).get();
+	return (_style & static_cast<uint8_t>(style)) != 0;
+}
+
+bool PlaylistTreeModelNode::HasAnyStyle() const
+{
+	return _style != static_cast<uint8_t>(ItemStyle::None);
 }
 
-wxDataViewItemAttr& PlaylistTreeModelNode::GetItemAttr(PlaylistTreeModelNode::PassKey<UIElements::Playlist::Playlist>)
+PlaylistTreeModelNode& PlaylistTreeModelNode::AddChild(PlaylistTreeModelNode* childToAdopt, PlaylistTreeModelNode::PassKey<UIElements::Playlist::Playlist>)
 {
-	return _itemAttr;
+	assert(_parent == nullptr); // Adding children to children is unexpected usecase.
+	return *_children.emplace_back(childToAdopt).get();
 }
 
-wxDataViewItemAttr& PlaylistTreeModelNode::GetItemAttrForModel(PlaylistTreeModelNode::PassKey<PlaylistTreeModel>)
+void PlaylistTreeModelNode::AddStyle(ItemStyle style, PassKey<UIElements::Playlist::Playlist>)
 {
-	return _itemAttr;
+	_style |= static_cast<uint8_t>(style);
 }
 
-void PlaylistTreeModelNode::ResetItemAttr(PassKey<UIElements::Playlist::Playlist>)
+void PlaylistTreeModelNode::ResetStyle(PassKey<UIElements::Playlist::Playlist>)
 {
-	_itemAttr = wxDataViewItemAttr();
+	_style = static_cast<uint8_t>(ItemStyle::None);
 }
 
 void PlaylistTreeModelNode::SetPlayable(bool playable, PassKey<UIElements::Playlist::Playlist>)
@@ -123,6 +138,11 @@ void PlaylistTreeModelNode::SetTag(ItemTag tag, PassKey<UIElements::Playlist::Pl
 	_tag = tag;
 }
 
+void PlaylistTreeModelNode::SetDuration(uint_least32_t duration, PassKey<UIElements::Playlist::Playlist>)
+{
+	_duration = duration;
+}
+
 void PlaylistTreeModelNode::SetIconId(UIElements::Playlist::PlaylistIconId newIconId, PassKey<UIElements::Playlist::Playlist>)
 {
 	_iconId = newIconId;
@@ -165,6 +185,41 @@ std::unique_ptr<void, std::function<void(void*)>> PlaylistTreeModel::PrepareDirt
 	);
 }
 
+const wxString& PlaylistTreeModel::Intern(const wxString& str)
+{
+	const auto it = _internedStrings.try_emplace(str, 0).first;
+	++it->second;
+	return it->first;
+}
+
+void PlaylistTreeModel::ReleaseInternedStrings(const PlaylistTreeModelNode& song)
+{
+	assert(song.type == PlaylistTreeModelNode::ItemType::Song);
+
+	ReleaseInterned(song.filepath);
+	ReleaseInterned(song.hvscPath);
+	ReleaseInterned(song.md5);
+	ReleaseInterned(song.author);
+	ReleaseInterned(song.copyright);
+	ReleaseInterned(song.musCompanionStrFilePath);
+}
+
+void PlaylistTreeModel::ReleaseInterned(const wxString& str)
+{
+	const auto it = _internedStrings.find(str);
+	assert(it != _internedStrings.end());
+	if (--it->second == 0)
+	{
+		_internedStrings.erase(it); // Reminder: the str may be this very key, don't touch it beyond this point.
+	}
+}
+
+void PlaylistTreeModel::ClearInternedStrings()
+{
+	assert(entries.empty());
+	_internedStrings.clear();
+}
+
 bool PlaylistTreeModel::HasContainerColumns(const wxDataViewItem& item) const
 {
 	const PlaylistTreeModelNode* const node = TreeItemToModelNode(item);
@@ -208,7 +263,7 @@ void PlaylistTreeModel::GetValue(wxVariant& variant, const wxDataViewItem& item,
 		{
 			if (node->GetSubsongCount() == 0)
 			{
-				variant = Helpers::Wx::GetTimeFormattedString(node->duration, true);
+				variant = Helpers::Wx::GetTimeFormattedString(node->GetDuration(), true);
 			}
 			else
 			{
@@ -296,7 +351,29 @@ unsigned int PlaylistTreeModel::GetChildren(const wxDataViewItem& parent, wxData
 
 bool PlaylistTreeModel::GetAttr(const wxDataViewItem& item, unsigned int col, wxDataViewItemAttr& attr) const
 {
-	PlaylistTreeModelNode* node = TreeItemToModelNode(item);
-	attr = node->GetItemAttrForModel({});
+	const PlaylistTreeModelNode& node = *TreeItemToModelNode(item);
+	if (!node.HasAnyStyle()) [[likely]]
+	{
+		return false; // Default attributes.
+	}
+
+	if (node.HasStyle(PlaylistTreeModelNode::ItemStyle::Unplayable))
+	{
+		static const wxColour COLOUR_UNPLAYABLE_BASIC_ROM("#054a80"); // TODO: these colors should probably be defined in the theme XML and not hardcoded here.
+		static const wxColour COLOUR_UNPLAYABLE_OTHER_ROM("#8a5454");
+		attr.SetColour((node.romRequirement == PlaylistTreeModelNode::RomRequirement::BasicRom) ? COLOUR_UNPLAYABLE_BASIC_ROM : COLOUR_UNPLAYABLE_OTHER_ROM);
+		attr.SetStrikethrough(true);
+	}
+
+	if (node.HasStyle(PlaylistTreeModelNode::ItemStyle::Hotlight))
+	{
+		attr.SetColour(wxSystemSettings::GetColour(wxSYS_COLOUR_HOTLIGHT)); // TODO: define the color in the theme XML instead of here.
+	}
+
+	if (node.HasStyle(PlaylistTreeModelNode::ItemStyle::Bold))
+	{
+		attr.SetBold(true);
+	}
+
 	return true;
 }
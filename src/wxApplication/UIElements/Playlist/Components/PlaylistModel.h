@@ -26,10 +26,12 @@
 #endif
 
 #include <wx/dataview.h>
+#include <wx/hashmap.h>
 
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 // Forward declarations
@@ -81,10 +83,21 @@ public:
         R64
     };
 
+	/// @brief Visual styling flags, the actual wxDataViewItemAttr is only built on demand when the control asks for it.
+	enum class ItemStyle : uint8_t
+	{
+		None = 0,
+		Bold = 1 << 0,
+		Hotlight = 1 << 1,
+		Unplayable = 1 << 2
+	};
+
 public:
 	PlaylistTreeModelNode() = delete;
 	PlaylistTreeModelNode(PlaylistTreeModelNode&) = delete;
-	PlaylistTreeModelNode(unsigned int uid, PlaylistTreeModelNode* parent, const wxString& title, const wxString& filepath, int defaultSubsong, uint_least32_t duration, const wxString& hvscPath, const char* md5, const wxString& author, const wxString& copyright, RomRequirement romRequirement, bool playable, const wxString& musCompanionStrFilePath);
+
+	/// @brief All string parameters except the title must be interned (see the PlaylistTreeModel::Intern), as the node only keeps references to them.
+	PlaylistTreeModelNode(unsigned int uid, PlaylistTreeModelNode* parent, const wxString& title, const wxString& filepath, int defaultSubsong, uint_least32_t duration, const wxString& hvscPath, const wxString& md5, const wxString& author, const wxString& copyright, RomRequirement romRequirement, bool playable, const wxString& musCompanionStrFilePath);
 
 public:
 	/// @brief Returns a nullptr for a mainsong or a mainsong for a subsong.
@@ -92,6 +105,7 @@ public:
 
 	/// @brief Returns children nodes i.e., subsongs.
 	PlaylistTreeModelNodePtrArray& GetChildren();
+	const PlaylistTreeModelNodePtrArray& GetChildren() const;
 
 	/// @brief A number of subsong child nodes, can be zero.
 	int GetSubsongCount() const;
@@ -105,21 +119,24 @@ public:
 	/// @brief Whether the item is playable (e.g., not missing any required ROM) and isn't tagged for auto-navigation skip (either itself or all its children).
 	bool IsAutoPlayable() const;
 
+	/// @brief Song duration in milliseconds (zero if unknown).
+	uint_least32_t GetDuration() const;
+
 	ItemTag GetTag() const;
 	UIElements::Playlist::PlaylistIconId GetIconId() const;
 
+	bool HasStyle(ItemStyle style) const;
+	bool HasAnyStyle() const;
+
 public:
 	/// @brief This is a protected method that can only be called by the controller due to mandatory model refresh requirement.
 	PlaylistTreeModelNode& AddChild(PlaylistTreeModelNode* childToAdopt, PassKey<UIElements::Playlist::Playlist>);
 
 	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
-	wxDataViewItemAttr& GetItemAttr(PassKey<UIElements::Playlist::Playlist>);
-
-	/// @brief This is a protected method that can only be called by the model due to wxDataViewModel virtual override requirement.
-	wxDataViewItemAttr& GetItemAttrForModel(PassKey<PlaylistTreeModel>);
+	void AddStyle(ItemStyle style, PassKey<UIElements::Playlist::Playlist>);
 
 	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
-	void ResetItemAttr(PassKey<UIElements::Playlist::Playlist>);
+	void ResetStyle(PassKey<UIElements::Playlist::Playlist>);
 
 	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
 	void SetPlayable(bool playable, PassKey<UIElements::Playlist::Playlist>);
@@ -127,31 +144,34 @@ public:
 	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
 	void SetTag(ItemTag tag, PassKey<UIElements::Playlist::Playlist>);
 
+	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
+	void SetDuration(uint_least32_t duration, PassKey<UIElements::Playlist::Playlist>);
+
 	/// @brief This is a protected method that can only be called by the controller to ensure visual presentation consistency.
 	void SetIconId(UIElements::Playlist::PlaylistIconId newIconId, PassKey<UIElements::Playlist::Playlist>);
 
 public:
 	const unsigned int uid;
 	const ItemType type;
-	const wxString title;
-	const wxString author;
-	const wxString copyright;
-	const wxString filepath;
-	const wxString hvscPath;
-	const wxString md5;
+	const wxString title; // Mostly unique, so it's not interned.
+	const wxString& author;
+	const wxString& copyright;
+	const wxString& filepath;
+	const wxString& hvscPath;
+	const wxString& md5;
 
 	/// @brief Indicates a default subsong for a song item, or a self-index (1-based) for a subsong item.
 	const int defaultSubsong;
-	const uint_least32_t duration;
 	const RomRequirement romRequirement;
 
-	const wxString musCompanionStrFilePath; // For MUS
+	const wxString& musCompanionStrFilePath; // For MUS
 
 private:
 	PlaylistTreeModelNode* _parent = nullptr;
 	PlaylistTreeModelNodePtrArray _children;
-	wxDataViewItemAttr _itemAttr;
+	uint_least32_t _duration = 0;
 	bool _playable = true;
+	uint8_t _style = static_cast<uint8_t>(ItemStyle::None);
 	ItemTag _tag = ItemTag::Normal;
 	UIElements::Playlist::PlaylistIconId _iconId = UIElements::Playlist::PlaylistIconId::NoIcon;
 };
@@ -194,6 +214,16 @@ public:
 
 	/// @brief Should be called before modifying the model state. Encapsulates a BeforeReset & AfterReset sequence safely which is needed on Linux (GTK). On MSW it uses a notifier mechanism instead which is more stable.
 	[[nodiscard]] std::unique_ptr<void, std::function<void(void*)>> PrepareDirty(std::function<void()> notifier);
+
+	/// @brief Returns a pooled copy of the string which stays valid until it's released (as many times as it was interned). Lots of songs share the same author, copyright etc. (and the subsongs share all of their parent's strings).
+	const wxString& Intern(const wxString& str);
+
+	/// @brief Releases all strings the main song interned (the subsongs don't intern their own), they're dropped from the pool once unused. Must be called before the song is removed.
+	void ReleaseInternedStrings(const PlaylistTreeModelNode& song);
+
+	/// @brief Must only be called when there are no more entries referencing the interned strings.
+	void ClearInternedStrings();
+
 	PlaylistTreeModelNodePtrArray entries;
 
 public:
@@ -211,6 +241,10 @@ protected: // Implementation of base class virtuals to define model
 
 	virtual bool GetAttr(const wxDataViewItem & item, unsigned int col, wxDataViewItemAttr& attr) const override;
 
+private:
+	void ReleaseInterned(const wxString& str);
+
 private:
 	UIElements::Playlist::PlaylistIcons _playlistIcons;
+	std::unordered_map<wxString, size_t, wxStringHash, wxStringEqual> _internedStrings; // Value is the reference count. Reminder: node-based container, so the references to its keys remain valid on rehash.
 };
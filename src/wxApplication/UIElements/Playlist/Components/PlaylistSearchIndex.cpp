@@ -0,0 +1,166 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "PlaylistSearchIndex.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace UIElements
+{
+	namespace Playlist
+	{
+		namespace
+		{
+			constexpr wchar_t FIELD_SEPARATOR = L'\n'; // Can't be typed into the search box, so a match can never span two fields.
+		}
+
+		void PlaylistSearchIndex::Add(const PlaylistTreeModelNode& song)
+		{
+			assert(song.type == PlaylistTreeModelNode::ItemType::Song);
+
+			wxString titleAndFileName(song.title);
+			titleAndFileName.Append(FIELD_SEPARATOR).Append(wxFileNameFromPath(song.filepath));
+
+			AddSharedField(song.author);
+			AddSharedField(song.copyright);
+			const Entry& entry = _entries[song.uid] = Entry{titleAndFileName.Lower().ToStdWstring(), &song.author, &song.copyright};
+
+			// Keep the remembered result up to date (songs get added while the user may already be searching)
+			if (_lastMatchesValid)
+			{
+				for (const wxString* field : {entry.author, entry.copyright})
+				{
+					if (_sharedFields.at(field).lower.find(_lastQuery) != std::wstring::npos)
+					{
+						_matchingSharedFields.insert(field);
+					}
+				}
+
+				if (IsMatch(entry, _lastQuery))
+				{
+					_lastMatches.insert(song.uid);
+				}
+			}
+		}
+
+		void PlaylistSearchIndex::Remove(unsigned int songUid)
+		{
+			const auto it = _entries.find(songUid);
+			if (it == _entries.end())
+			{
+				return;
+			}
+
+			RemoveSharedField(it->second.author);
+			RemoveSharedField(it->second.copyright);
+			_entries.erase(it);
+
+			_lastMatches.erase(songUid); // The remembered result stays valid without it.
+		}
+
+		void PlaylistSearchIndex::Clear()
+		{
+			_entries.clear();
+			_sharedFields.clear();
+			Invalidate();
+		}
+
+		const PlaylistSearchIndex::Matches& PlaylistSearchIndex::Find(const wxString& queryLower)
+		{
+			const std::wstring query(queryLower.ToStdWstring());
+			if (_lastMatchesValid && query == _lastQuery)
+			{
+				return _lastMatches; // Find Next/Prev with an unchanged query.
+			}
+
+			MatchSharedFields(query);
+
+			if (_lastMatchesValid && !_lastQuery.empty() && query.compare(0, _lastQuery.length(), _lastQuery) == 0)
+			{
+				// The query was only extended (typing), so it can only match a subset of the previous matches
+				for (auto it = _lastMatches.begin(); it != _lastMatches.end();)
+				{
+					it = (!IsMatch(_entries.at(*it), query)) ? _lastMatches.erase(it) : std::next(it);
+				}
+			}
+			else
+			{
+				_lastMatches.clear();
+				for (const auto& [uid, entry] : _entries)
+				{
+					if (IsMatch(entry, query))
+					{
+						_lastMatches.insert(uid);
+					}
+				}
+			}
+
+			_lastQuery = query;
+			_lastMatchesValid = true;
+			return _lastMatches;
+		}
+
+		void PlaylistSearchIndex::AddSharedField(const wxString& interned)
+		{
+			SharedField& field = _sharedFields[&interned];
+			if (field.refCount++ == 0)
+			{
+				field.lower = interned.Lower().ToStdWstring();
+			}
+		}
+
+		void PlaylistSearchIndex::RemoveSharedField(const wxString* interned)
+		{
+			const auto it = _sharedFields.find(interned);
+			assert(it != _sharedFields.end());
+			if (--it->second.refCount == 0)
+			{
+				_sharedFields.erase(it);
+				_matchingSharedFields.erase(interned); // The address may get reused by a different string.
+			}
+		}
+
+		void PlaylistSearchIndex::MatchSharedFields(const std::wstring& query)
+		{
+			_matchingSharedFields.clear();
+			for (const auto& [interned, field] : _sharedFields)
+			{
+				if (field.lower.find(query) != std::wstring::npos)
+				{
+					_matchingSharedFields.insert(interned);
+				}
+			}
+		}
+
+		bool PlaylistSearchIndex::IsMatch(const Entry& entry, const std::wstring& query) const
+		{
+			return _matchingSharedFields.count(entry.author) != 0 ||
+				_matchingSharedFields.count(entry.copyright) != 0 ||
+				entry.titleAndFileName.find(query) != std::wstring::npos;
+		}
+
+		void PlaylistSearchIndex::Invalidate()
+		{
+			_lastMatchesValid = false;
+			_lastMatches.clear();
+			_matchingSharedFields.clear();
+			_lastQuery.clear();
+		}
+	}
+}
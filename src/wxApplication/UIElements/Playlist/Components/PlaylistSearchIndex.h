@@ -0,0 +1,88 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "PlaylistModel.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace UIElements
+{
+	namespace Playlist
+	{
+		/// @brief Keeps the searchable texts (title, author, released and the file name) of each main song pre-lowercased, so that the queries don't have to touch the wx strings of the nodes.
+		/// The author and released texts are indexed over the model's interned strings: each distinct one is lowercased and matched once per query (rather than once per song).
+		/// The last query's result is remembered: repeating it (Find Next/Prev) is free and extending it (typing) only refines the previous matches.
+		class PlaylistSearchIndex
+		{
+		public:
+			using Matches = std::unordered_set<unsigned int>; // Main song UIDs.
+
+		public:
+			PlaylistSearchIndex() = default;
+			PlaylistSearchIndex(PlaylistSearchIndex&) = delete;
+
+		public:
+			/// @brief The song's author and copyright must be interned (the index refers to them until the song is removed).
+			void Add(const PlaylistTreeModelNode& song);
+
+			/// @brief Must be called before the song's interned strings are released.
+			void Remove(unsigned int songUid);
+			void Clear();
+
+			/// @brief Returns the UIDs of all songs containing the (already lowercased and trimmed) query. The reference is valid until the next call.
+			const Matches& Find(const wxString& queryLower);
+
+		private:
+			struct Entry
+			{
+				std::wstring titleAndFileName; // Lowercased, the fields which aren't shared with other songs.
+				const wxString* author; // Interned.
+				const wxString* copyright; // Interned.
+			};
+
+			struct SharedField
+			{
+				std::wstring lower;
+				size_t refCount = 0;
+			};
+
+			void AddSharedField(const wxString& interned);
+			void RemoveSharedField(const wxString* interned);
+
+			/// @brief Collects the shared fields containing the query.
+			void MatchSharedFields(const std::wstring& query);
+			bool IsMatch(const Entry& entry, const std::wstring& query) const;
+
+			void Invalidate();
+
+		private:
+			std::unordered_map<unsigned int, Entry> _entries;
+			std::unordered_map<const wxString*, SharedField> _sharedFields; // Keyed by the interned string's address (unique per value within the pool).
+			std::unordered_set<const wxString*> _matchingSharedFields; // For the _lastQuery.
+
+			std::wstring _lastQuery;
+			Matches _lastMatches;
+			bool _lastMatchesValid = false;
+		};
+	}
+}
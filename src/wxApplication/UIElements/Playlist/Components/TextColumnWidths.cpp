@@ -0,0 +1,71 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#include "TextColumnWidths.h"
+
+namespace UIElements
+{
+	namespace Playlist
+	{
+		void TextColumnWidths::Add(const PlaylistTreeModelNode& node, const Widths& widths)
+		{
+			Remove(node);
+
+			_widths.emplace(&node, widths);
+			for (size_t i = 0; i < TEXT_COLUMN_COUNT; ++i)
+			{
+				++_histograms[i][widths[i]];
+			}
+		}
+
+		void TextColumnWidths::Remove(const PlaylistTreeModelNode& node)
+		{
+			const auto it = _widths.find(&node);
+			if (it == _widths.cend())
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < TEXT_COLUMN_COUNT; ++i)
+			{
+				const auto itBucket = _histograms[i].find(it->second[i]);
+				if (--itBucket->second == 0)
+				{
+					_histograms[i].erase(itBucket);
+				}
+			}
+
+			_widths.erase(it);
+		}
+
+		void TextColumnWidths::Clear()
+		{
+			_widths.clear();
+			for (std::map<int, size_t>& histogram : _histograms)
+			{
+				histogram.clear();
+			}
+		}
+
+		int TextColumnWidths::GetMax(PlaylistTreeModel::ColumnId column) const
+		{
+			const std::map<int, size_t>& histogram = _histograms.at(ToIndex(column));
+			return (histogram.empty()) ? 0 : histogram.crbegin()->first;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is part of sidplaywx, a GUI player for Commodore 64 SID music files.
+ * Copyright (C) 2026 Jasmin Rutic (bytespiller@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see https://www.gnu.org/licenses/gpl-3.0.html
+ */
+
+#pragma once
+
+#include "PlaylistModel.h"
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+
+namespace UIElements
+{
+	namespace Playlist
+	{
+		/// @brief Remembers the measured text widths of the playlist items and keeps a width histogram per text column, so that the widest item is known without re-measuring everything.
+		class TextColumnWidths
+		{
+		public:
+			static constexpr size_t TEXT_COLUMN_COUNT = 4; // Title, Duration, Author, Copyright.
+			using Widths = std::array<int, TEXT_COLUMN_COUNT>;
+
+			/// @brief Converts a text column to an index into the Widths.
+			static constexpr size_t ToIndex(PlaylistTreeModel::ColumnId column)
+			{
+				return static_cast<size_t>(column) - static_cast<size_t>(PlaylistTreeModel::ColumnId::Title);
+			}
+
+		public:
+			TextColumnWidths() = default;
+			TextColumnWidths(TextColumnWidths&) = delete;
+
+		public:
+			/// @brief Replaces the item's widths if it was already measured.
+			void Add(const PlaylistTreeModelNode& node, const Widths& widths);
+
+			/// @brief Does nothing if the item wasn't measured.
+			void Remove(const PlaylistTreeModelNode& node);
+
+			void Clear();
+
+			/// @brief Returns the widest measured item width in the text column (0 if there aren't any).
+			int GetMax(PlaylistTreeModel::ColumnId column) const;
+
+		private:
+			std::unordered_map<const PlaylistTreeModelNode*, Widths> _widths;
+			std::array<std::map<int, size_t>, TEXT_COLUMN_COUNT> _histograms; // Width -> number of items of that width.
+		};
+	}
+}
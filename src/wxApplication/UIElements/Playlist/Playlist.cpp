@@ -20,17 +20,50 @@
 #include "../../Config/UIStrings.h"
 #include <wx/renderer.h>
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <random>
+#include <utility>
 
 namespace UIElements
 {
 	namespace Playlist
 	{
 		static constexpr unsigned int COL_PADDING = 10; // Column padding in the respective wxDataViewCtrl, we use this hardcoded value here to avoid PITA.
+		static constexpr size_t REMOVE_MANY_RESET_THRESHOLD = 64; // Above this many removed items a full reset is cheaper than the wx's per-item deletion handling (which is linear each).
 
 		using ColumnId = PlaylistTreeModel::ColumnId;
 
+		namespace
+		{
+			/// @brief Prepares the sort key once per song (rather than on each comparison) and then reorders the entries accordingly.
+			template <typename TKey, typename TKeyGetter>
+			void SortEntriesByKey(PlaylistTreeModelNodePtrArray& entries, bool ascending, TKeyGetter getKey)
+			{
+				std::vector<std::pair<TKey, size_t>> keys;
+				keys.reserve(entries.size());
+				for (size_t i = 0; i < entries.size(); ++i)
+				{
+					keys.emplace_back(getKey(*entries[i]), i);
+				}
+
+				std::stable_sort(keys.begin(), keys.end(), [ascending](const std::pair<TKey, size_t>& a, const std::pair<TKey, size_t>& b)
+				{
+					return (ascending) ? a.first < b.first : b.first < a.first;
+				});
+
+				PlaylistTreeModelNodePtrArray sorted;
+				sorted.reserve(entries.size());
+				for (const std::pair<TKey, size_t>& key : keys)
+				{
+					sorted.emplace_back(std::move(entries[key.second]));
+				}
+
+				entries = std::move(sorted);
+			}
+		}
+
 		Playlist::Playlist(wxPanel* parent, const PlaylistIcons& playlistIcons, Settings::AppSettings& appSettings, unsigned long style) :
 			wxDataViewCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, style),
 			_model(*new PlaylistTreeModel(playlistIcons)),
@@ -49,11 +82,28 @@ namespace UIElements
 #endif
 
 			// Auto-fit the Title column upon the child item expansion
-			Bind(wxEVT_DATAVIEW_ITEM_EXPANDED, [this](const wxDataViewEvent& /*evt*/)
+			Bind(wxEVT_DATAVIEW_ITEM_EXPANDED, [this](const wxDataViewEvent& evt)
 			{
+				const PlaylistTreeModelNode& song = *PlaylistTreeModel::TreeItemToModelNode(evt.GetItem());
+				if (_expandedSongs.insert(&song).second)
+				{
+					for (const PlaylistTreeModelNodePtr& subsong : song.GetChildren())
+					{
+						_unmeasuredItems.insert(subsong.get());
+					}
+				}
+
 				AutoFitTextColumn(ColumnId::Title);
 			});
 
+			// The collapsed subsongs no longer count for auto-fitting
+			Bind(wxEVT_DATAVIEW_ITEM_COLLAPSED, [this](const wxDataViewEvent& evt)
+			{
+				const PlaylistTreeModelNode& song = *PlaylistTreeModel::TreeItemToModelNode(evt.GetItem());
+				_ForgetMeasuredSubsongs(song);
+				_expandedSongs.erase(&song);
+			});
+
 			// Handle sorting
 			Bind(wxEVT_DATAVIEW_COLUMN_HEADER_CLICK, [this](const wxDataViewEvent& evt)
 			{
@@ -165,6 +215,7 @@ namespace UIElements
 
 			// Notify the wx base control of change
 			_model.Cleared();
+			_OnAllCollapsedByReset();
 
 			// Notify the parent (we need to refresh the transport buttons state after sorting in case the first/last positions are swapped)
 			GetEventHandler()->AddPendingEvent(wxDataViewEvent(wxEVT_DATAVIEW_COLUMN_SORTED, this, nullptr));
@@ -172,46 +223,85 @@ namespace UIElements
 
 		int Playlist::_GetBestTextColumnWidth(ColumnId column)
 		{
+			const wxFont font(GetFont().Bold());
+
+			// Re-measure everything if the font has changed (e.g., DPI change)
+			if (font != _measuredFont)
+			{
+				_measuredFont = font;
+				_textColumnWidths.Clear();
+
+				for (const PlaylistTreeModelNodePtr& song : _model.entries)
+				{
+					_unmeasuredItems.insert(song.get());
+				}
+
+				for (const PlaylistTreeModelNode* song : _expandedSongs)
+				{
+					for (const PlaylistTreeModelNodePtr& subsong : song->GetChildren())
+					{
+						_unmeasuredItems.insert(subsong.get());
+					}
+				}
+			}
+
 			wxClientDC dc(this);
-			dc.SetFont(GetFont().MakeBold());
+			dc.SetFont(font);
+			_MeasurePendingItems(dc);
 
-			int width = std::max(10, dc.GetTextExtent(GetColumn(static_cast<unsigned int>(column))->GetTitle()).GetWidth()); // Initial value is minimum auto-width (fit column title).
+			const int minWidth = std::max(10, dc.GetTextExtent(GetColumn(static_cast<unsigned int>(column))->GetTitle()).GetWidth()); // Minimum auto-width (fit column title).
+			return std::max(minWidth, _textColumnWidths.GetMax(column)) + COL_PADDING;
+		}
+
+		void Playlist::_MeasurePendingItems(wxDC& dc)
+		{
+			static constexpr ColumnId TEXT_COLUMNS[] = { ColumnId::Title, ColumnId::Duration, ColumnId::Author, ColumnId::Copyright };
+			static_assert(std::size(TEXT_COLUMNS) == TextColumnWidths::TEXT_COLUMN_COUNT);
 
+			for (const PlaylistTreeModelNode* node : _unmeasuredItems)
 			{
-				const auto DoUpdateWidth = [&](const wxDataViewItem& item) -> void
+				const wxDataViewItem item = PlaylistTreeModel::ModelNodeToTreeItem(*node);
+
+				TextColumnWidths::Widths widths{};
+				for (const ColumnId column : TEXT_COLUMNS)
 				{
 					wxVariant text;
 					_model.GetValue(text, item, static_cast<unsigned int>(column));
+					widths[TextColumnWidths::ToIndex(column)] = dc.GetTextExtent(text.GetString()).GetWidth();
+				}
 
-					const wxSize& size = dc.GetTextExtent(text.GetString());
-					width = std::max(width, size.GetWidth());
-				};
+				_textColumnWidths.Add(*node, widths);
+			}
 
-				std::for_each(_model.entries.cbegin(), _model.entries.cend(), [&](const PlaylistTreeModelNodePtr& song)
-				{
-					const wxDataViewItem& songNode = PlaylistTreeModel::ModelNodeToTreeItem(*song);
-					if (!songNode.IsOk())
-					{
-						return;
-					}
+			_unmeasuredItems.clear();
+		}
 
-					// Update by subsongs' titles (if parent expanded)
-					const PlaylistTreeModelNodePtrArray& subsongs = song->GetChildren();
-					if (!subsongs.empty() && IsExpanded(songNode))
-					{
-						std::for_each(subsongs.cbegin(), subsongs.cend(), [&](const PlaylistTreeModelNodePtr& subsong)
-						{
-							const wxDataViewItem& subsongNode = PlaylistTreeModel::ModelNodeToTreeItem(*subsong);
-							DoUpdateWidth(subsongNode);
-						});
-					}
+		void Playlist::_ForgetMeasuredItem(const PlaylistTreeModelNode& node)
+		{
+			_ForgetMeasuredSubsongs(node);
+			_expandedSongs.erase(&node);
 
-					// Update by the main song title
-					DoUpdateWidth(songNode);
-				});
+			_textColumnWidths.Remove(node);
+			_unmeasuredItems.erase(&node);
+		}
+
+		void Playlist::_ForgetMeasuredSubsongs(const PlaylistTreeModelNode& song)
+		{
+			for (const PlaylistTreeModelNodePtr& subsong : song.GetChildren())
+			{
+				_textColumnWidths.Remove(*subsong);
+				_unmeasuredItems.erase(subsong.get());
+			}
+		}
+
+		void Playlist::_OnAllCollapsedByReset()
+		{
+			for (const PlaylistTreeModelNode* song : _expandedSongs)
+			{
+				_ForgetMeasuredSubsongs(*song);
 			}
 
-			return width + COL_PADDING;
+			_expandedSongs.clear();
 		}
 
 		PlaylistTreeModelNode& Playlist::AddMainSong(const wxString& title, const wxString& filepath, int defaultSubsong, uint_least32_t duration, const wxString& hvscPath, const char* md5, const wxString& author, const wxString& copyright, PlaylistTreeModelNode::RomRequirement romRequirement, bool playable, const wxString& musCompanionStrFilePath)
@@ -219,7 +309,10 @@ namespace UIElements
 			_ResetColumnSortingIndicator();
 
 			// Create item
-			_model.entries.emplace_back(new PlaylistTreeModelNode(_NextFreeItemUid(), nullptr, title, filepath, defaultSubsong, duration, hvscPath, md5, author, copyright, romRequirement, playable, musCompanionStrFilePath));
+			_model.entries.emplace_back(new PlaylistTreeModelNode(_NextFreeItemUid(), nullptr, title, _model.Intern(filepath), defaultSubsong, duration, _model.Intern(hvscPath), _model.Intern(md5), _model.Intern(author), _model.Intern(copyright), romRequirement, playable, _model.Intern(musCompanionStrFilePath)));
+
+			_searchIndex.Add(*_model.entries.back());
+			_unmeasuredItems.insert(_model.entries.back().get());
 
 			// Notify the wx base control of change
 			wxDataViewItem childNotify = wxDataViewItem(_model.entries.back().get());
@@ -238,6 +331,10 @@ namespace UIElements
 				return;
 			}
 
+			// The parent's Title (subsong count) and Duration (blank) texts will change
+			_textColumnWidths.Remove(parent);
+			_unmeasuredItems.insert(&parent);
+
 			wxDataViewItemArray notifyItems(durations.size());
 			const auto _ = _model.PrepareDirty([&]()
 			{
@@ -246,11 +343,13 @@ namespace UIElements
 
 			// Create multiple items at once
 			{
+				static const wxString emptyString; // Not interned, the subsongs don't own any strings (they share their parent's ones).
+
 				int cnt = 0;
 				for (const uint_least32_t duration : durations)
 				{
 					++cnt;
-					PlaylistTreeModelNode& newChildNode = parent.AddChild(new PlaylistTreeModelNode(_NextFreeItemUid(), &parent, titles.at(cnt - 1), parent.filepath, cnt, duration, parent.hvscPath, parent.md5, "", "", parent.romRequirement, parent.IsPlayable(), parent.musCompanionStrFilePath), {});
+					PlaylistTreeModelNode& newChildNode = parent.AddChild(new PlaylistTreeModelNode(_NextFreeItemUid(), &parent, titles.at(cnt - 1), parent.filepath, cnt, duration, parent.hvscPath, parent.md5, emptyString, emptyString, parent.romRequirement, parent.IsPlayable(), parent.musCompanionStrFilePath), {});
 					notifyItems.Add(wxDataViewItem(&newChildNode));
 
 					// Indicate if default subsong
@@ -274,10 +373,14 @@ namespace UIElements
 				}
 			}
 
+			_ForgetMeasuredItem(*item);
+
 			// Find and remove the item from the model (in case of a main song it is removed from the root, in case of a subsong it is removed from its parent main song)
 			const auto it = std::find_if(_model.entries.cbegin(), _model.entries.cend(), [&item](const PlaylistTreeModelNodePtr& qItemNode) { return qItemNode.get() == item; });
 			if (it != _model.entries.cend())
 			{
+				_searchIndex.Remove(item->uid);
+				_model.ReleaseInternedStrings(*item);
 				_model.entries.erase(it); // "item" is now invalid (but not nullptr), do not access it beyond this point.
 			}
 
@@ -285,6 +388,53 @@ namespace UIElements
 			_model.ItemDeleted(static_cast<wxDataViewItem>(parent), static_cast<wxDataViewItem>(item));
 		}
 
+		void Playlist::RemoveMany(const std::vector<PlaylistTreeModelNode*>& songs)
+		{
+			if (songs.empty())
+			{
+				return;
+			}
+
+			const std::unordered_set<const PlaylistTreeModelNode*> removeSet(songs.cbegin(), songs.cend());
+
+			if (PlaylistTreeModelNode* const activeSong = GetActiveSong())
+			{
+				const PlaylistTreeModelNode* const activeMainSong = (activeSong->type == PlaylistTreeModelNode::ItemType::Subsong) ? activeSong->GetParent() : activeSong;
+				if (removeSet.count(activeMainSong) != 0)
+				{
+					_activeItem.Unset();
+				}
+			}
+
+			wxDataViewItemArray notifyItems;
+			notifyItems.Alloc(songs.size());
+			for (PlaylistTreeModelNode* const song : songs)
+			{
+				assert(song->type == PlaylistTreeModelNode::ItemType::Song);
+				_searchIndex.Remove(song->uid);
+				_ForgetMeasuredItem(*song);
+				_model.ReleaseInternedStrings(*song);
+				notifyItems.Add(wxDataViewItem(song));
+			}
+
+			// Single stable compaction pass (the removed nodes get destroyed here, do not access them beyond this point)
+			_model.entries.erase(std::remove_if(_model.entries.begin(), _model.entries.end(), [&removeSet](const PlaylistTreeModelNodePtr& entry)
+			{
+				return removeSet.count(entry.get()) != 0;
+			}), _model.entries.end());
+
+			// Notify the wx base control of change
+			if (notifyItems.size() > REMOVE_MANY_RESET_THRESHOLD)
+			{
+				_model.Cleared();
+				_OnAllCollapsedByReset();
+			}
+			else
+			{
+				_model.ItemsDeleted(wxDataViewItem(0), notifyItems);
+			}
+		}
+
 		void Playlist::Clear()
 		{
 			_ResetColumnSortingIndicator();
@@ -293,6 +443,11 @@ namespace UIElements
 
 			// Clear all entries (entries are unique ptrs so they'll be destroyed since the vector is their owner)
 			_model.entries.clear();
+			_model.ClearInternedStrings();
+			_searchIndex.Clear();
+			_textColumnWidths.Clear();
+			_unmeasuredItems.clear();
+			_expandedSongs.clear();
 
 			// Notify the wx base control of change
 			_model.Cleared();
@@ -569,21 +724,21 @@ namespace UIElements
 				}
 
 				// Un-highlight the old node
-				oldNode.ResetItemAttr({});
+				oldNode.ResetStyle({});
 
 				// Un-highlight the parent item
 				PlaylistTreeModelNode* parent = oldNode.GetParent();
 				if (parent != nullptr)
 				{
 					notifyItems.Add(wxDataViewItem(parent));
-					parent->ResetItemAttr({});
+					parent->ResetStyle({});
 				}
 			}
 
 			// Highlight new node
 			_activeItem = PlaylistTreeModel::ModelNodeToTreeItem(node);
 			notifyItems.Add(_activeItem);
-			GetActiveSong()->GetItemAttr({}).SetBold(true);
+			GetActiveSong()->AddStyle(PlaylistTreeModelNode::ItemStyle::Bold, {});
 
 			// Also highlight the parent node if this is a child node
 			if (node.type == PlaylistTreeModelNode::ItemType::Subsong)
@@ -591,9 +746,8 @@ namespace UIElements
 				PlaylistTreeModelNode* const activeParent = GetActiveSong()->GetParent();
 				notifyItems.Add(wxDataViewItem(activeParent));
 
-				wxDataViewItemAttr& attr = activeParent->GetItemAttr({});
-				attr.SetBold(true);
-				attr.SetColour(wxSystemSettings::GetColour(wxSYS_COLOUR_HOTLIGHT)); // TODO: define the color in the theme XML instead of here.
+				activeParent->AddStyle(PlaylistTreeModelNode::ItemStyle::Bold, {});
+				activeParent->AddStyle(PlaylistTreeModelNode::ItemStyle::Hotlight, {});
 			}
 
 			// Expand new if necessary
@@ -611,6 +765,11 @@ namespace UIElements
 			return true;
 		}
 
+		const PlaylistSearchIndex::Matches& Playlist::FindSongs(const wxString& queryLower)
+		{
+			return _searchIndex.Find(queryLower);
+		}
+
 		bool Playlist::IsEmpty() const
 		{
 			return _model.entries.empty();
@@ -626,7 +785,7 @@ namespace UIElements
 			node.SetTag(tag, {});
 			if (force)
 			{
-				node.ResetItemAttr({}); // Reset attributes only on force, so that the context menu actions don't remove the bold styling for hard-selected items.
+				node.ResetStyle({}); // Reset attributes only on force, so that the context menu actions don't remove the bold styling for hard-selected items.
 			}
 
 			// Apply icon & styling attributes
@@ -655,15 +814,12 @@ namespace UIElements
 						// Apply unplayable styling
 						if (!node.IsPlayable())
 						{
-							const wxColour col = (node.romRequirement == PlaylistTreeModelNode::RomRequirement::BasicRom) ? "#054a80" : "#8a5454"; // TODO: these colors should probably be defined in the theme XML and not hardcoded here.
-							node.GetItemAttr({}).SetColour(col);
-							node.GetItemAttr({}).SetStrikethrough(true);
+							node.AddStyle(PlaylistTreeModelNode::ItemStyle::Unplayable, {});
 
 							// Apply to any subsongs too
 							for (const PlaylistTreeModelNodePtr& subnode : node.GetChildren())
 							{
-								subnode->GetItemAttr({}).SetColour(col);
-								subnode->GetItemAttr({}).SetStrikethrough(true);
+								subnode->AddStyle(PlaylistTreeModelNode::ItemStyle::Unplayable, {});
 							}
 						}
 					}
@@ -691,6 +847,19 @@ namespace UIElements
 			_model.ItemChanged(wxDataViewItem(&node)); // Refresh icon immediately.
 		}
 
+		void Playlist::SetItemDuration(PlaylistTreeModelNode& node, uint_least32_t duration)
+		{
+			node.SetDuration(duration, {});
+			_model.ItemChanged(wxDataViewItem(&node));
+
+			// The Duration column text changed, so re-measure it (if the item counts for the auto-fitting at all, i.e., a song or a visible subsong)
+			if (node.type == PlaylistTreeModelNode::ItemType::Song || _expandedSongs.count(node.GetParent()) != 0)
+			{
+				_textColumnWidths.Remove(node);
+				_unmeasuredItems.insert(&node);
+			}
+		}
+
 		bool Playlist::Select(const PlaylistTreeModelNode& node)
 		{
 			const wxDataViewItem item = PlaylistTreeModel::ModelNodeToTreeItem(node);
@@ -746,45 +915,27 @@ namespace UIElements
 			{
 				case PlaylistTreeModel::ColumnId::Title:
 				{
-					std::sort(_model.entries.begin(), _model.entries.end(), [&](const PlaylistTreeModelNodePtr& a, const PlaylistTreeModelNodePtr& b)
-					{
-						const int result = a->title.CmpNoCase(b->title);
-						return (ascending) ? result < 0 : result > 0;
-					});
-
+					SortEntriesByKey<wxString>(_model.entries, ascending, [](const PlaylistTreeModelNode& node) { return node.title.Lower(); });
 					break;
 				}
 				case PlaylistTreeModel::ColumnId::Duration:
 				{
-					std::sort(_model.entries.begin(), _model.entries.end(), [&](const PlaylistTreeModelNodePtr& a, const PlaylistTreeModelNodePtr& b)
-					{
-						return (ascending) ? a->duration < b->duration : a->duration > b->duration;
-					});
-
+					SortEntriesByKey<uint_least32_t>(_model.entries, ascending, [](const PlaylistTreeModelNode& node) { return node.GetDuration(); });
 					break;
 				}
 				case PlaylistTreeModel::ColumnId::Author:
 				{
-					std::sort(_model.entries.begin(), _model.entries.end(), [&](const PlaylistTreeModelNodePtr& a, const PlaylistTreeModelNodePtr& b)
-					{
-						const int result = a->author.CmpNoCase(b->author);
-						return (ascending) ? result < 0 : result > 0;
-					});
-
+					SortEntriesByKey<wxString>(_model.entries, ascending, [](const PlaylistTreeModelNode& node) { return node.author.Lower(); });
 					break;
 				}
 				case PlaylistTreeModel::ColumnId::Copyright:
 				{
-					std::sort(_model.entries.begin(), _model.entries.end(), [&](const PlaylistTreeModelNodePtr& a, const PlaylistTreeModelNodePtr& b)
+					SortEntriesByKey<wxString>(_model.entries, ascending, [](const PlaylistTreeModelNode& node)
 					{
 						// Ensure years like "200?" are sorted as "2000"
-						wxString aCopyright(a->copyright);
-						aCopyright.Replace('?', '0');
-						wxString bCopyright(b->copyright);
-						bCopyright.Replace('?', '0');
-
-						const int result = aCopyright.CmpNoCase(bCopyright);
-						return (ascending) ? result < 0 : result > 0;
+						wxString key(node.copyright.Lower());
+						key.Replace('?', '0');
+						return key;
 					});
 
 					break;
@@ -810,8 +961,9 @@ namespace UIElements
 			}
 			viewColumn.SetBitmap(*_model.GetPlaylistIcons().GetIconList().at((_columnSortState.ascending) ? PlaylistIconId::SortAscending : PlaylistIconId::SortDescending).bitmap);
 
-			// Notify the wx base control of change
+			// Notify the wx base control of change (there is no reorder notification in the wxDataViewModel, and per-item ItemDeleted & ItemAdded pairs would be far slower than a single reset)
 			_model.Cleared();
+			_OnAllCollapsedByReset();
 
 			// Notify the parent (we need to refresh the transport buttons state after sorting in case the first/last positions are swapped)
 			GetEventHandler()->AddPendingEvent(wxDataViewEvent(wxEVT_DATAVIEW_COLUMN_SORTED, this, &viewColumn));
@@ -19,10 +19,13 @@
 #pragma once
 
 #include "Components/PlaylistModel.h"
+#include "Components/PlaylistSearchIndex.h"
+#include "Components/TextColumnWidths.h"
 #include "../../Config/AppSettings.h"
 #include <wx/dataview.h>
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace UIElements
@@ -46,6 +49,9 @@ namespace UIElements
 			/// @brief Removes a main song or a subsong item.
 			void Remove(PlaylistTreeModelNode* item);
 
+			/// @brief Removes multiple main songs at once (in a single pass with a single notification). The pointers are invalid afterwards.
+			void RemoveMany(const std::vector<PlaylistTreeModelNode*>& songs);
+
 			/// @brief Removes all items from the playlist.
 			void Clear();
 
@@ -103,12 +109,18 @@ namespace UIElements
 			/// @brief Sets the node as currently playing (sub)song if playable. Returns true if successful.
 			bool TrySetActiveSong(const PlaylistTreeModelNode& node, bool autoexpand);
 
+			/// @brief Returns the UIDs of all main songs whose title, author, released or file name contains the (lowercase) query.
+			const PlaylistSearchIndex::Matches& FindSongs(const wxString& queryLower);
+
 			/// @brief Returns true if there aren't any top-level items.
 			bool IsEmpty() const;
 
 			/// @brief Applies the tag to the node with corresponding functional and visual changes. Ignores unplayable nodes by default unless forced.
 			void SetItemTag(PlaylistTreeModelNode& node, PlaylistTreeModelNode::ItemTag tag, bool force = false);
 
+			/// @brief Updates the node's duration (e.g., when it becomes known later) and refreshes its display.
+			void SetItemDuration(PlaylistTreeModelNode& node, uint_least32_t duration);
+
 			/// @brief Soft-selects (highlights) a node in the tree.
 			bool Select(const PlaylistTreeModelNode& node);
 
@@ -126,8 +138,21 @@ namespace UIElements
 
 		private:
 			/// @brief There is no GetBestColumnWidth on Linux for some reason, so we've rolled our own here that should work everywhere for text columns at least.
+			/// Each item is measured only once (all text columns at once), then the widest one is taken from the _textColumnWidths.
 			int _GetBestTextColumnWidth(PlaylistTreeModel::ColumnId column);
 
+			/// @brief Measures the items queued in the _unmeasuredItems.
+			void _MeasurePendingItems(wxDC& dc);
+
+			/// @brief Drops the measured (or queued) widths of the item and its subsongs.
+			void _ForgetMeasuredItem(const PlaylistTreeModelNode& node);
+
+			/// @brief Drops the measured (or queued) widths of the song's subsongs (e.g., when they're not visible anymore).
+			void _ForgetMeasuredSubsongs(const PlaylistTreeModelNode& song);
+
+			/// @brief A model reset (sort/shuffle) collapses all songs, so their subsongs must no longer be taken into account.
+			void _OnAllCollapsedByReset();
+
 			wxDataViewColumn* _AddBitmapColumn(PlaylistTreeModel::ColumnId column, wxAlignment align = wxALIGN_CENTER, int flags = 0);
 
 			// Reminder: wxCOL_REORDERABLE is crashy due to use of OnColumnsCountChanged().
@@ -155,6 +180,11 @@ namespace UIElements
 		private:
 			unsigned int _lastFreeItemUid = 0;
 			PlaylistTreeModel& _model;
+			PlaylistSearchIndex _searchIndex;
+			TextColumnWidths _textColumnWidths;
+			std::unordered_set<const PlaylistTreeModelNode*> _unmeasuredItems;
+			std::unordered_set<const PlaylistTreeModelNode*> _expandedSongs;
+			wxFont _measuredFont;
 			Settings::AppSettings& _appSettings;
 			wxDataViewItem _activeItem;
 			wxDataViewItem _lastTooltipItem;
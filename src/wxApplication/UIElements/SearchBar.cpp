@@ -52,6 +52,11 @@ namespace UIElements
 			EmitSignal((shiftPressed) ? SignalsSearchBar::SIGNAL_FIND_PREV : SignalsSearchBar::SIGNAL_FIND_NEXT);
 		});
 
+		_txtInput->Bind(wxEVT_TEXT, [this](wxCommandEvent& /*evt*/)
+		{
+			EmitSignal(SignalsSearchBar::SIGNAL_QUERY_CHANGED); // Find-as-you-type.
+		});
+
 		_txtInput->Bind(wxEVT_KEY_DOWN, [this](wxKeyEvent& evt)
 		{
 			if (evt.GetKeyCode() == wxKeyCode::WXK_ESCAPE)
@@ -31,7 +31,8 @@ namespace UIElements
 	enum class SignalsSearchBar
 	{
 		SIGNAL_FIND_PREV,
-		SIGNAL_FIND_NEXT
+		SIGNAL_FIND_NEXT,
+		SIGNAL_QUERY_CHANGED
 	};
 
 	class SearchBar: public SimpleSignalProvider<SignalsSearchBar>